@@ -5,7 +5,7 @@
 #include <stdint.h>
 
 #define SMALLMAP_T__HEADER
-#define K uint16_t
+#define K uint32_t
 #define V int
 #define NAME c11_smallmap_n2i
 #include "pocketpy/xmacros/smallmap.h"
@@ -8,11 +8,35 @@
 
 /* string */
 typedef struct c11_string {
-    // int size | char[] | '\0'
+    // int size | uint32_t hash:29 | u8_kind:2 | is_view:1 | char[] | '\0' | c11_u8index
     int size;
-    char data[];  // flexible array member
+    uint32_t hash : 29;    // cached by `c11_string__hash()`, 0 means not computed yet
+    uint32_t u8_kind : 2;  // c11_u8kind, found by the first codepoint access
+    uint32_t is_view : 1;  // `data` holds a `c11_string_ref` instead of the bytes
+    char data[];           // flexible array member
 } c11_string;
 
+typedef enum c11_u8kind {
+    C11_U8_UNKNOWN,    // not scanned yet
+    C11_U8_ASCII,      // one byte per codepoint
+    C11_U8_INDEXED,    // non-ascii with a `c11_u8index`
+    C11_U8_UNINDEXED,  // non-ascii without room for an index, codepoints are counted on each access
+} c11_u8kind;
+
+// codepoint positions of a non-ascii string, stored after the null-terminator of the string,
+// or next to the bytes of a view
+typedef struct c11_u8index {
+    int length;     // number of codepoints, -1 until built
+    int offsets[];  // byte offset of every 64th codepoint
+} c11_u8index;
+
+// where the bytes of a view are, see `c11_string__ctor_view()`
+typedef struct c11_string_ref {
+    char* data;
+    int capacity;           // bytes available at `data`, including the null-terminator
+    c11_u8index* u8_index;  // allocated by the first codepoint access if the view is not ascii
+} c11_string_ref;
+
 /* bytes */
 typedef struct c11_bytes {
     int size;
@@ -34,9 +58,25 @@ c11_string* c11_string__new3(const char* fmt, ...);
 void c11_string__ctor(c11_string* self, const char* data);
 void c11_string__ctor2(c11_string* self, const char* data, int size);
 void c11_string__ctor3(c11_string* self, int size);
+// bytes taken by a string of `size` bytes, a non-ascii one also keeps a `c11_u8index`
+int c11_string__sizeof(int size, bool ascii);
+// like `c11_string__ctor3()` for bytes which are known to be ascii or not
+// `self` needs `c11_string__sizeof(size, ascii)` bytes
+void c11_string__ctor4(c11_string* self, int size, bool ascii);
+// reference `sv` in place, which must be null-terminated and outlive `self`
+// `self` needs `sizeof(c11_string) + sizeof(c11_string_ref)` bytes
+void c11_string__ctor_view(c11_string* self, c11_sv sv);
+c11_string_ref* c11_string__ref(c11_string* self);
 c11_string* c11_string__copy(c11_string* self);
+void c11_string__dtor(c11_string* self);
 void c11_string__delete(c11_string* self);
 c11_sv c11_string__sv(c11_string* self);
+uint32_t c11_string__hash(c11_string* self);
+int c11_string__u8_length(c11_string* self);
+bool c11_string__is_ascii(c11_string* self);
+int c11_string__u8_byte_index(c11_string* self, int i);
+c11_sv c11_string__u8_getitem(c11_string* self, int i);
+c11_string* c11_string__u8_slice(c11_string* self, int start, int stop, int step);
 
 int c11_sv__u8_length(c11_sv self);
 c11_sv c11_sv__u8_getitem(c11_sv self, int i);
@@ -59,9 +99,14 @@ c11_string* c11_sv__replace2(c11_sv self, c11_sv old, c11_sv new_);
 c11_vector /* T=c11_sv */ c11_sv__split(c11_sv self, char sep);
 c11_vector /* T=c11_sv */ c11_sv__split2(c11_sv self, c11_sv sep);
 
+// wyhash, see https://github.com/wangyi-fudan/wyhash
+uint64_t c11__hash_bytes(const void* data, int size);
+
 // misc
 int c11__unicode_index_to_byte(const char* data, int i);
 int c11__byte_index_to_unicode(const char* data, int n);
+bool c11__u8_validate(const char* data, int n);
+bool c11__is_ascii(const char* data, int n);
 
 bool c11__is_unicode_Lo_char(int c);
 int c11__u8_header(unsigned char c, bool suppress);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "pocketpy/config.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/* atomics, available regardless of PK_ENABLE_THREADS */
+#ifdef _MSC_VER
+static inline int64_t c11__atomic_load(volatile int64_t* p) {
+    return _InterlockedCompareExchange64(p, 0, 0);
+}
+
+static inline void c11__atomic_store(volatile int64_t* p, int64_t v) {
+    _InterlockedExchange64(p, v);
+}
+
+static inline bool c11__atomic_cas(volatile int64_t* p, int64_t expected, int64_t desired) {
+    return _InterlockedCompareExchange64(p, desired, expected) == expected;
+}
+#else
+static inline int64_t c11__atomic_load(volatile int64_t* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void c11__atomic_store(volatile int64_t* p, int64_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+static inline bool c11__atomic_cas(volatile int64_t* p, int64_t expected, int64_t desired) {
+    return __atomic_compare_exchange_n(p,
+                                       &expected,
+                                       desired,
+                                       false,
+                                       __ATOMIC_ACQ_REL,
+                                       __ATOMIC_ACQUIRE);
+}
+#endif
+
+typedef struct c11_spinlock {
+    volatile int64_t value;
+} c11_spinlock;
+
+void c11_spinlock__lock(c11_spinlock* self);
+void c11_spinlock__unlock(c11_spinlock* self);
+
+/// Give up the rest of the current time slice.
+void c11_thrd__yield();
+
+#if PK_ENABLE_THREADS
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+typedef struct c11_thrd {
+#ifdef _WIN32
+    void* handle;
+#else
+    pthread_t handle;
+#endif
+    void (*func)(void*);
+    void* arg;
+} c11_thrd;
+
+/// Start `func(arg)` on a new thread. `self` must stay alive until joined.
+bool c11_thrd__create(c11_thrd* self, void (*func)(void*), void* arg);
+void c11_thrd__join(c11_thrd* self);
+
+typedef struct c11_mtx {
+#ifdef _WIN32
+    void* handle;  // SRWLOCK
+#else
+    pthread_mutex_t handle;
+#endif
+} c11_mtx;
+
+void c11_mtx__ctor(c11_mtx* self);
+void c11_mtx__dtor(c11_mtx* self);
+void c11_mtx__lock(c11_mtx* self);
+void c11_mtx__unlock(c11_mtx* self);
+
+typedef struct c11_cnd {
+#ifdef _WIN32
+    void* handle;  // CONDITION_VARIABLE
+#else
+    pthread_cond_t handle;
+#endif
+} c11_cnd;
+
+void c11_cnd__ctor(c11_cnd* self);
+void c11_cnd__dtor(c11_cnd* self);
+/// Release `mtx`, sleep until signaled and lock `mtx` again. May wake spuriously.
+void c11_cnd__wait(c11_cnd* self, c11_mtx* mtx);
+void c11_cnd__signal(c11_cnd* self);
+void c11_cnd__broadcast(c11_cnd* self);
+
+#endif
@@ -1,6 +1,13 @@
 #pragma once
 
+#include "pocketpy/config.h"
+
 #include <stdio.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
 
 #define PK_REGION(name) 1
 
@@ -16,6 +23,37 @@
 #define c11__unreachable() __builtin_unreachable()
 #endif
 
+#if defined(_MSC_VER)
+#define c11__thread_local __declspec(thread)
+#elif defined(__ELF__) && PK_TLS_INITIAL_EXEC
+#define c11__thread_local _Thread_local __attribute__((tls_model("initial-exec")))
+#else
+#define c11__thread_local _Thread_local
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define c11__prefetch(p) __builtin_prefetch(p)
+#else
+#define c11__prefetch(p) ((void)0)
+#endif
+
+// index of the lowest set bit, `x` must not be 0
+#if defined(_MSC_VER) && !defined(__clang__)
+static inline int c11__ctz64(uint64_t x) {
+    unsigned long index;
+#if defined(_M_X64) || defined(_M_ARM64)
+    _BitScanForward64(&index, x);
+#else
+    if(_BitScanForward(&index, (unsigned long)x)) return (int)index;
+    _BitScanForward(&index, (unsigned long)(x >> 32));
+    index += 32;
+#endif
+    return (int)index;
+}
+#else
+#define c11__ctz64(x) __builtin_ctzll(x)
+#endif
+
 #define c11__abort(...)                                                                            \
     do {                                                                                           \
         fprintf(stderr, __VA_ARGS__);                                                              \
@@ -5,4 +5,6 @@
 #include "pocketpy/objects/sourcedata.h"
 #include "pocketpy/objects/codeobject.h"
 
-Error* pk_compile(SourceData_ src, CodeObject* out);
+// `optimize` > 0 enables constant folding, dead code elimination, jump threading
+// and superinstructions
+Error* pk_compile(SourceData_ src, int optimize, CodeObject* out);
@@ -18,6 +18,27 @@
 #define PK_ENABLE_OS                1
 #endif
 
+// Whether to use OS threads, e.g. for the parallel gc sweep
+// `PK_MALLOC` and `PK_FREE` must be thread-safe when this is enabled
+#ifndef PK_ENABLE_THREADS           // can be overridden by cmake
+#define PK_ENABLE_THREADS           0
+#endif
+
+// Whether thread-locals use the initial-exec TLS model, which avoids `__tls_get_addr()` calls
+// Only safe when pocketpy is linked into the executable, not into a `dlopen()`ed library
+#ifndef PK_TLS_INITIAL_EXEC         // can be overridden by cmake
+#define PK_TLS_INITIAL_EXEC         0
+#endif
+
+// Whether to dispatch opcodes through a table of label addresses (GCC and Clang only)
+#ifndef PK_ENABLE_COMPUTED_GOTO     // can be overridden by cmake
+    #if defined(__GNUC__) || defined(__clang__)
+        #define PK_ENABLE_COMPUTED_GOTO     1
+    #else
+        #define PK_ENABLE_COMPUTED_GOTO     0
+    #endif
+#endif
+
 // GC min threshold
 #ifndef PK_GC_MIN_THRESHOLD         // can be overridden by cmake
     #if PK_LOW_MEMORY_MODE
@@ -27,6 +48,21 @@
     #endif
 #endif
 
+// Number of blocks swept per step in the lazy sweep gc mode
+#ifndef PK_GC_SWEEP_STEP            // can be overridden by cmake
+#define PK_GC_SWEEP_STEP            8192
+#endif
+
+// Capacity of the gc gray stack kept between collections
+#ifndef PK_GC_GRAY_STACK_KEEP       // can be overridden by cmake
+#define PK_GC_GRAY_STACK_KEEP       1024
+#endif
+
+// Maximum number of threads sweeping the heap in parallel
+#ifndef PK_GC_MAX_SWEEP_THREADS     // can be overridden by cmake
+#define PK_GC_MAX_SWEEP_THREADS     8
+#endif
+
 // Memory allocation functions
 #ifndef PK_MALLOC
 #define PK_MALLOC(size)             malloc(size)
@@ -1,7 +1,6 @@
 #pragma once
 
 #include "pocketpy/pocketpy.h"
-#include "pocketpy/common/smallmap.h"
 #include "pocketpy/objects/base.h"
 
 typedef struct c11_array2d_like {
@@ -33,25 +32,53 @@ typedef struct c11_array2d_view {
 
 c11_array2d* py_newarray2d(py_OutRef out, int n_cols, int n_rows);
 
+/* array2d_packed */
+typedef enum c11_dtype {
+    c11_dtype_bool,
+    c11_dtype_int8,
+    c11_dtype_int32,
+    c11_dtype_float32,
+} c11_dtype;
+
+typedef struct c11_array2d_packed {
+    c11_array2d_like header;
+    c11_dtype dtype;
+    int itemsize;
+    py_TValue item;  // boxed copy of the last cell returned by `f_get`
+    void* data;      // numel unboxed cells of `dtype`
+} c11_array2d_packed;
+
+c11_array2d_packed* py_newarray2d_packed(py_OutRef out, int n_cols, int n_rows, c11_dtype dtype);
+
 /* chunked_array2d */
-#define SMALLMAP_T__HEADER
-#define K c11_vec2i
-#define V py_TValue*
-#define NAME c11_chunked_array2d_chunks
-#define less(a, b) (a._i64 < b._i64)
-#define equal(a, b) (a._i64 == b._i64)
-#include "pocketpy/xmacros/smallmap.h"
-#undef SMALLMAP_T__HEADER
+typedef struct c11_chunked_array2d_chunk {
+    c11_vec2i pos;
+    py_TValue context;
+    py_TValue* cells;  // NULL if paged out
+    // LRU list of resident chunks
+    struct c11_chunked_array2d_chunk* prev;
+    struct c11_chunked_array2d_chunk* next;
+} c11_chunked_array2d_chunk;
 
 typedef struct c11_chunked_array2d {
-    c11_chunked_array2d_chunks chunks;
+    c11_chunked_array2d_chunk** table;  // open addressing, capacity is a power of 2
+    int capacity;
+    int length;
+    int resident;
+    c11_chunked_array2d_chunk* lru_head;  // most recently used
+    c11_chunked_array2d_chunk* lru_tail;  // next to be paged out
+
     int chunk_size;
     int chunk_size_log2;
     int chunk_size_mask;
-    c11_chunked_array2d_chunks_KV last_visited;
 
     py_TValue default_T;
     py_TValue context_builder;
+
+    int max_resident;  // 0 if unbounded
+    py_TValue on_save;
+    py_TValue on_load;
+    bool is_streaming;  // a `save` or `load` hook is running
 } c11_chunked_array2d;
 
 py_Ref c11_chunked_array2d__get(c11_chunked_array2d* self, int col, int row);
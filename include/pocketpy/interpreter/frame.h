@@ -38,6 +38,7 @@ typedef struct py_Frame {
     bool is_locals_special;
     int ip;
     UnwindTarget* uw_list;
+    LinetableCursor line_cursor;  // see `Frame__lineno`
 } py_Frame;
 
 typedef struct SourceLocation {
@@ -53,8 +54,8 @@ py_Frame* Frame__new(const CodeObject* co,
                   bool is_locals_special);
 void Frame__delete(py_Frame* self);
 
-int Frame__lineno(const py_Frame* self);
-int Frame__iblock(const py_Frame* self);
+int Frame__lineno(py_Frame* self);
+int Frame__iblock(py_Frame* self);
 
 int Frame__getglobal(py_Frame* self, py_Name name) PY_RAISE PY_RETURN;
 bool Frame__setglobal(py_Frame* self, py_Name name, py_TValue* val) PY_RAISE;
@@ -66,7 +67,7 @@ py_StackRef Frame__getlocal_noproxy(py_Frame* self, py_Name name);
 int Frame__prepare_jump_exception_handler(py_Frame* self, ValueStack*);
 
 UnwindTarget* Frame__find_unwind_target(py_Frame* self, int iblock);
-void Frame__set_unwind_target(py_Frame* self, py_TValue* sp);
+void Frame__set_unwind_target(py_Frame* self, int iblock, py_TValue* sp);
 
 void Frame__gc_mark(py_Frame* self);
 SourceLocation Frame__source_location(py_Frame* self);
\ No newline at end of file
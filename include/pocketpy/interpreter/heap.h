@@ -3,14 +3,26 @@
 #include "pocketpy/objects/object.h"
 #include "pocketpy/interpreter/objectpool.h"
 
+typedef enum GCMode {
+    GC_MODE_FULL = 0,        // mark and sweep in one pause
+    GC_MODE_LAZY_SWEEP = 1,  // mark in one pause, only the sweep is spread over later steps
+} GCMode;
+
 typedef struct ManagedHeap {
     MultiPool small_objects;
     c11_vector /* PyObject* */ large_objects;
+    c11_vector /* PyObject* */ pending_large_objects;  // waiting to be swept
+    c11_vector /* PyObject* */ gray_objects;  // marked but children not yet visited
 
     int freed_ma[3];
     int gc_threshold;  // threshold for gc_counter
     int gc_counter;    // objects created since last gc
     bool gc_enabled;
+
+    GCMode gc_mode;
+    bool gc_sweeping;    // a lazy sweep is in progress
+    int gc_sweep_freed;  // objects freed by the current lazy sweep
+    int gc_sweep_threads;  // threads used by a full sweep, 1 means the VM thread only
 } ManagedHeap;
 
 void ManagedHeap__ctor(ManagedHeap* self);
@@ -15,9 +15,11 @@ void pk__add_module_traceback();
 void pk__add_module_enum();
 void pk__add_module_inspect();
 void pk__add_module_pickle();
+void pk__add_module_channel();
 void pk__add_module_importlib();
 
 void pk__add_module_linalg();
+void pk__add_module_linalg_arrays();
 void pk__add_module_array2d();
 void pk__add_module_colorcvt();
 
@@ -1,16 +1,19 @@
 #pragma once
 
 #include "pocketpy/objects/base.h"
-#include "pocketpy/common/smallmap.h"
+#include "pocketpy/common/vector.h"
+#include "pocketpy/common/str.h"
 
 typedef struct {
     char* data;     // null-terminated data
     int size;       // size of the data excluding the null-terminator
+    uint32_t hash;  // hash of the data
     py_TValue obj;  // cached `str` object (lazy initialized)
 } RInternedEntry;
 
 typedef struct {
-    c11_smallmap_s2n interned;
+    py_Name* table;     // open addressing table of 1-based indices, `0` means empty
+    uint32_t capacity;  // power of 2
     c11_vector /* T=RInternedEntry */ r_interned;
 } InternedNames;
 
@@ -2,31 +2,55 @@
 
 #include "pocketpy/common/vector.h"
 #include "pocketpy/common/str.h"
+#include "pocketpy/config.h"
+
+#include <stdbool.h>
+#include <stdint.h>
 
 #define kPoolArenaSize (120 * 1024)
-#define kMultiPoolCount 5
-#define kPoolMaxBlockSize (32*kMultiPoolCount)
+#define kMultiPoolCount 11
+#define kPoolMinBlockSize 32
+#define kPoolMaxBlockSize 1024
+#define kPoolArenaMaxBlocks (kPoolArenaSize / kPoolMinBlockSize)
 
 typedef struct PoolArena {
     int block_size;
     int block_count;
-    int unused_length;
-    int* unused;
+    int free_count;
+    int bump;                 // blocks from here on have never been allocated
+    uint32_t block_size_inv;  // ceil(2^32 / block_size), to find a block index without dividing
+    void* free_list;          // intrusive list threaded through freed blocks
+    uint64_t used[kPoolArenaMaxBlocks / 64];  // occupancy bitmap, one bit per block
     char data[kPoolArenaSize];
 } PoolArena;
 
 typedef struct Pool {
-    c11_vector /* PoolArena* */ arenas;
+    c11_vector /* PoolArena* */ arenas;          // sorted so that the fullest arena is at the back
     c11_vector /* PoolArena* */ no_free_arenas;
+    c11_vector /* PoolArena* */ pending_arenas;  // waiting to be swept
     int block_size;
 } Pool;
 
 typedef struct MultiPool {
     Pool pools[kMultiPoolCount];
+#if PK_ENABLE_THREADS
+    struct PoolSweepWorkers* sweep_workers;  // started by the first parallel sweep
+#endif
 } MultiPool;
 
+// how to destroy a dead object of some type during a parallel sweep
+typedef struct PoolSweepType {
+    void (*dtor)(void*);
+    bool deferred;  // `dtor` must run on the VM thread
+} PoolSweepType;
+
 void* MultiPool__alloc(MultiPool* self, int size);
 int MultiPool__sweep_dealloc(MultiPool* self);
+void MultiPool__sweep_begin(MultiPool* self);
+int MultiPool__sweep_step(MultiPool* self, int* budget);
+#if PK_ENABLE_THREADS
+int MultiPool__sweep_dealloc_parallel(MultiPool* self, int n_threads, const PoolSweepType* types);
+#endif
 void MultiPool__ctor(MultiPool* self);
 void MultiPool__dtor(MultiPool* self);
-c11_string* MultiPool__summary(MultiPool* self);
\ No newline at end of file
+c11_string* MultiPool__summary(MultiPool* self);
@@ -17,6 +17,9 @@ typedef struct py_TypeInfo {
 
     bool is_python;  // is it a python class? (not derived from c object)
     bool is_sealed;  // can it be subclassed?
+    bool has_subclass;  // is it the base of another type?
+
+    uint32_t version;  // bumped when the dict of this type or one of its bases changes
 
     void (*dtor)(void*);
 
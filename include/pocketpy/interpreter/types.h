@@ -3,7 +3,7 @@
 #include "pocketpy/common/vector.h"
 #include "pocketpy/objects/base.h"
 
-#define PK_DICT_MAX_COLLISION 4
+#define PK_DICT_GROUP_WIDTH 16
 
 typedef struct {
     uint64_t hash;
@@ -12,13 +12,15 @@ typedef struct {
 } DictEntry;
 
 typedef struct {
-    int _[PK_DICT_MAX_COLLISION];
-} DictIndex;
+    uint8_t ctrl[PK_DICT_GROUP_WIDTH];  // control tag of each slot
+    int slots[PK_DICT_GROUP_WIDTH];     // index into `entries` of each full slot
+} DictGroup;
 
 typedef struct {
     int length;
-    uint32_t capacity;
-    DictIndex* indices;
+    uint32_t capacity;     // number of slots, a power of two and >= PK_DICT_GROUP_WIDTH
+    uint32_t growth_left;  // inserts into empty slots before the next rehash
+    DictGroup* groups;
     c11_vector /*T=DictEntry*/ entries;
 } Dict;
 
@@ -33,6 +33,8 @@ typedef struct VM {
     py_TValue main;      // __main__ module
 
     py_Callbacks callbacks;
+    c11_string* cache_dir;  // bytecode cache directory, maybe NULL
+    int optimize;           // optimization level of the compiler
 
     py_TValue ascii_literals[128+1];
 
@@ -71,6 +73,8 @@ bool pk__normalize_index(int* index, int length);
 
 bool pk__object_new(int argc, py_Ref argv);
 py_TypeInfo* pk__type_info(py_Type type);
+// invalidates the inline caches of `type` and its subclasses
+void pk__type_modified(py_Type type);
 
 bool pk_wrapper__self(int argc, py_Ref argv);
 
@@ -102,16 +106,45 @@ bool pk_arrayiter(py_Ref val);
 bool pk_arraycontains(py_Ref self, py_Ref val);
 
 bool pk_loadmethod(py_StackRef self, py_Name name);
+
+/// Cached versions of `py_getattr`, `py_setattr` and `pk_loadmethod` used by the bytecode loop.
+py_Ref pk_inlinecache__lookup(InlineCache* cache, py_Type type);
+bool pk_getattr_cached(py_Ref self, InlineCache* cache) PY_RAISE PY_RETURN;
+bool pk_setattr_cached(py_Ref self, InlineCache* cache, py_Ref val) PY_RAISE;
+bool pk_loadmethod_cached(py_StackRef self, InlineCache* cache);
 bool pk_callmagic(py_Name name, int argc, py_Ref argv);
 
 bool pk_exec(CodeObject* co, py_Ref module);
+// create a `str` referencing `sv` in place, see `c11_string__ctor_view()`
+void pk_newstrview(py_OutRef out, c11_sv sv);
+// compile `source`, reusing the bytecode cache at `cache_path` and refreshing it if stale
+bool pk_compile_cached(CodeObject* out,
+                       const char* source,
+                       const char* filename,
+                       const char* cache_path) PY_RAISE;
 bool pk_execdyn(CodeObject* co, py_Ref module, py_Ref globals, py_Ref locals);
+bool _py_compile(CodeObject* out,
+                 const char* source,
+                 const char* filename,
+                 enum py_CompileMode mode,
+                 bool is_dynamic) PY_RAISE;
+// returns the source of module `path` or NULL, see `py_import()`
+const char* pk_load_module_source(const char* path, c11_string** filename, bool* need_free);
+
+/// Bundles of precompiled modules, see `bundle.c`.
+const BundleEntry* pk_find_bundled(const char* path);
+bool pk_exec_bundled(const BundleEntry* entry, py_Ref module) PY_RAISE;
+void pk_unmount_bundles();
 
 /// Assumes [a, b] are on the stack, performs a binary op.
 /// The result is stored in `self->last_retval`.
 /// The stack remains unchanged.
 bool pk_stack_binaryop(VM* self, py_Name op, py_Name rop);
 
+/// Returns a specialized opcode for `BINARY_OP` with `arg` on `lhs` and `rhs`.
+/// Returns `OP_BINARY_OP` if there is no specialization for the operands.
+Opcode pk_specialize_binaryop(uint16_t arg, py_Ref lhs, py_Ref rhs);
+
 void pk_print_stack(VM* self, py_Frame* frame, Bytecode byte);
 
 // type registration
@@ -1,10 +1,11 @@
 #pragma once
 
 #include "pocketpy/pocketpy.h"
+#include "pocketpy/common/utils.h"
 
 typedef struct PyObject PyObject;
 typedef struct VM VM;
-extern VM* pk_current_vm;
+extern c11__thread_local VM* pk_current_vm;
 
 typedef struct py_TValue {
     py_Type type;
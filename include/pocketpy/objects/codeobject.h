@@ -44,11 +44,14 @@ typedef enum Opcode {
 #undef OPCODE
 } Opcode;
 
+// a 32-bit instruction, wider operands are split across `EXTENDED_ARG` prefixes
 typedef struct Bytecode {
     uint8_t op;
     uint16_t arg;
 } Bytecode;
 
+static_assert(sizeof(Bytecode) == 4, "sizeof(Bytecode) != 4");
+
 void Bytecode__set_signed_arg(Bytecode* self, int arg);
 bool Bytecode__is_forward_jump(const Bytecode* self);
 
@@ -66,12 +69,38 @@ typedef struct BytecodeEx {
     int iblock;       // block index
 } BytecodeEx;
 
+// a run of the line table where decoding can start, see `CodeObject__line_info`
+typedef struct LinetableMark {
+    int ip;      // first instruction of the run
+    int offset;  // byte offset of the run in `linetable`
+    int lineno;  // line number of the previous run
+} LinetableMark;
+
+// the run of the line table around the last lookup, for lookups that mostly move forward
+typedef struct LinetableCursor {
+    int start;   // first instruction of the run
+    int end;     // end of the run, exclusive, 0 if nothing has been decoded
+    int offset;  // byte offset of the next run in `linetable`
+    BytecodeEx ex;
+} LinetableCursor;
+
+// per-instruction cache for LOAD_ATTR, LOAD_METHOD and STORE_ATTR
+typedef struct InlineCache {
+    py_Name name;        // the attribute name
+    py_Type type;        // receiver type of the cached lookup, 0 if empty
+    uint32_t version;    // `py_TypeInfo::version` of `type` when the entry was filled
+    int dict_index;      // hint: index of `name` in the receiver's __dict__
+    py_TValue* cls_var;  // cached result of `py_tpfindname(type, name)`, maybe NULL
+} InlineCache;
+
 typedef struct CodeObject {
     SourceData_ src;
     c11_string* name;
 
     c11_vector /*T=Bytecode*/ codes;
-    c11_vector /*T=CodeObjectByteCodeEx*/ codes_ex;
+    c11_vector /*T=BytecodeEx*/ codes_ex;  // only used by the compiler
+    c11_vector /*T=char*/ linetable;       // runs of `BytecodeEx`, see `CodeObject__line_info`
+    c11_vector /*T=LinetableMark*/ linetable_marks;  // one for every few runs of `linetable`
 
     c11_vector /*T=py_TValue*/ consts;  // constants
     c11_vector /*T=py_Name*/ varnames;  // local variables
@@ -81,6 +110,7 @@ typedef struct CodeObject {
 
     c11_vector /*T=CodeBlock*/ blocks;
     c11_vector /*T=FuncDecl_*/ func_decls;
+    c11_vector /*T=InlineCache*/ inline_caches;  // indexed by the arg of attribute opcodes
 
     int start_line;
     int end_line;
@@ -89,11 +119,39 @@ typedef struct CodeObject {
 void CodeObject__ctor(CodeObject* self, SourceData_ src, c11_sv name);
 void CodeObject__dtor(CodeObject* self);
 int CodeObject__add_varname(CodeObject* self, py_Name name);
+int CodeObject__add_inline_cache(CodeObject* self, py_Name name);
 void CodeObject__gc_mark(const CodeObject* self);
+// `codes_ex` is compressed into `linetable` when the compiler is done with it
+void CodeObject__pack_linetable(CodeObject* self);
+// builds `linetable_marks`, for a `linetable` that was not packed by the compiler
+void CodeObject__index_linetable(CodeObject* self);
+BytecodeEx CodeObject__line_info(const CodeObject* self, int ip, LinetableCursor* cursor);
+bool CodeObject__check_linetable(const CodeObject* self);
+void CodeObject__unpack_linetable(const CodeObject* self, c11_vector /*T=BytecodeEx*/* out);
+// bytecode cache (.pkc) and bundle (.pkb), see `codecache.c`
+typedef struct BundleModule {
+    const char* path;
+    const CodeObject* code;
+} BundleModule;
+
+typedef struct BundleEntry {
+    c11_sv path;
+    c11_sv filename;
+    c11_sv source;
+    const void* code;
+    int code_size;
+} BundleEntry;
+
+bool CodeObject__dumps(const CodeObject* self, c11_vector* out);
+bool CodeObject__loads(CodeObject* out, const void* data, int size, SourceData_ src);
+bool Bundle__dumps(const BundleModule* modules, int count, c11_vector* out);
+bool Bundle__parse(const void* data, int size, c11_vector /*T=BundleEntry*/* out);
+// `str` constants reference the bundle in place
+bool CodeObject__loads_bundled(CodeObject* out, const BundleEntry* entry, SourceData_ src);
 
 typedef struct FuncDeclKwArg {
     int index;        // index in co->varnames
-    uint16_t key;     // name of this argument
+    py_Name key;      // name of this argument
     py_TValue value;  // default value
 } FuncDeclKwArg;
 
@@ -6,12 +6,16 @@
 #include <stdint.h>
 
 #define SMALLMAP_T__HEADER
-#define K uint16_t
+#define K py_Name
 #define V py_TValue
 #define NAME NameDict
 #include "pocketpy/xmacros/smallmap.h"
 #undef SMALLMAP_T__HEADER
 
+// `hint` is the index where `key` was found last time; it is updated on every call
+py_TValue* NameDict__try_get_hinted(const NameDict* self, py_Name key, int* hint);
+void NameDict__set_hinted(NameDict* self, py_Name key, py_TValue value, int* hint);
+
 /* A simple binary tree for storing modules. */
 typedef struct ModuleDict {
     const char* path;
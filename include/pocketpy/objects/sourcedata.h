@@ -23,6 +23,13 @@ SourceData_ SourceData__rcnew(const char* source,
                                     const char* filename,
                                     enum py_CompileMode mode,
                                     bool is_dynamic);
+// fill `line_starts` without running the lexer
+void SourceData__index_lines(struct SourceData* self);
+// reference `source` in place, which must be null-terminated, have no '\r' and outlive the result
+SourceData_ SourceData__rcnew_view(c11_sv source,
+                                   const char* filename,
+                                   enum py_CompileMode mode,
+                                   bool is_dynamic);
 bool SourceData__get_line(const struct SourceData* self,
                              int lineno,
                              const char** st,
@@ -18,7 +18,7 @@ extern "C" {
 typedef struct py_TValue py_TValue;
 /// An integer that represents a python identifier. This is to achieve string pooling and fast name
 /// resolution.
-typedef uint16_t py_Name;
+typedef uint32_t py_Name;
 /// An integer that represents a python type. `0` is invalid.
 typedef int16_t py_Type;
 /// A 64-bit integer type. Corresponds to `int` in python.
@@ -90,10 +90,16 @@ enum py_CompileMode { EXEC_MODE, EVAL_MODE, SINGLE_MODE };
 PK_API void py_initialize();
 /// Finalize pocketpy and free all VMs.
 PK_API void py_finalize();
-/// Get the current VM index.
+/// Get the current VM index of the calling thread.
 PK_API int py_currentvm();
-/// Switch to a VM.
-/// @param index index of the VM ranging from 0 to 16 (exclusive). `0` is the default VM.
+/// Create a new VM and return its index. The current VM is not changed.
+PK_API int py_newvm();
+/// Delete a VM created by `py_newvm()` or `py_switchvm()`.
+/// It must not be the current VM of any thread.
+PK_API void py_deletevm(int index);
+/// Switch the calling thread to a VM. The VM is created if it does not exist.
+/// Each thread has its own current VM, and a VM must only be used by one thread at a time.
+/// @param index non-negative index of the VM. `0` is the default VM.
 PK_API void py_switchvm(int index);
 /// Reset the current VM.
 PK_API void py_resetvm();
@@ -105,6 +111,10 @@ PK_API void py_setvmctx(void* ctx);
 PK_API void py_sys_setargv(int argc, char** argv);
 /// Set the trace function for the current VM.
 PK_API void py_sys_settrace(py_TraceFunc func);
+/// Set the optimization level of the compiler for the current VM, `0` disables the optimizer.
+/// The default level is `1`, which folds constants, removes dead code, threads jumps
+/// and fuses common instruction sequences.
+PK_API void py_sys_setoptimize(int level);
 /// Setup the callbacks for the current VM.
 PK_API py_Callbacks* py_callbacks();
 
@@ -514,6 +524,20 @@ PK_API py_GlobalRef py_newmodule(const char* path);
 PK_API py_GlobalRef py_getmodule(const char* path);
 /// Reload an existing module.
 PK_API bool py_importlib_reload(py_GlobalRef module) PY_RAISE PY_RETURN;
+/// Set the directory of compiled bytecode (`.pkc`) files, or `NULL` to disable the cache.
+/// When set, `import` loads a module from `<path>/<module>.pkc` if the file was compiled
+/// from the same source, otherwise it compiles the source and writes the file.
+PK_API void py_importlib_setcachedir(const char* path);
+/// Compile a module into the bytecode cache without executing it.
+/// -1: error, 0: not found, 1: success
+PK_API int py_importlib_compile(const char* path) PY_RAISE;
+/// Compile `count` modules into a single bundle (`.pkb`) file at `path`.
+PK_API bool py_importlib_makebundle(const char* path, const char** modules, int count) PY_RAISE;
+/// Memory-map a bundle file, `import` then looks up its modules before `importfile`.
+/// Bundles are shared by all VMs and stay mounted until `py_finalize()`.
+PK_API bool py_importlib_mountbundle(const char* path) PY_RAISE;
+/// Mount a bundle from memory, `data` must stay valid until `py_finalize()`.
+PK_API bool py_importlib_mountbundlemem(const void* data, int size) PY_RAISE;
 
 /// Import a module.
 /// The result will be set to `py_retval()`.
@@ -674,6 +698,12 @@ c11_vec3 py_tovec3(py_Ref self);
 c11_vec2i py_tovec2i(py_Ref self);
 c11_vec3i py_tovec3i(py_Ref self);
 c11_mat3x3* py_tomat3x3(py_Ref self);
+/// Create a `vec2_array` of `length` zero vectors and return its packed data.
+c11_vec2* py_newvec2array(py_OutRef out, int length);
+/// Get the packed data of a `vec2_array` without copying.
+c11_vec2* py_tovec2array(py_Ref self, int* length);
+c11_vec3* py_newvec3array(py_OutRef out, int length);
+c11_vec3* py_tovec3array(py_Ref self, int* length);
 
 /************* Others *************/
 
@@ -767,6 +797,10 @@ enum py_PredefinedType {
     tp_array2d,
     tp_array2d_view,
     tp_chunked_array2d,
+    tp_array2d_packed,
+    /* linalg */
+    tp_vec2_array,
+    tp_vec3_array,
 };
 
 #ifdef __cplusplus
@@ -2,6 +2,7 @@
 
 /**************************/
 OPCODE(NO_OP)
+OPCODE(EXTENDED_ARG)
 /**************************/
 OPCODE(POP_TOP)
 OPCODE(DUP_TOP)
@@ -110,4 +111,29 @@ OPCODE(END_FINALLY)
 /**************************/
 OPCODE(FORMAT_STRING)
 /**************************/
+// superinstructions emitted by the optimizer, the arg holds two 8-bit operands
+OPCODE(LOAD_FAST_LOAD_FAST)
+OPCODE(LOAD_FAST_LOAD_ATTR)
+/**************************/
+// specialized forms of BINARY_OP, see `pk_specialize_binaryop`
+OPCODE(BINARY_ADD_INT)
+OPCODE(BINARY_SUB_INT)
+OPCODE(BINARY_MUL_INT)
+OPCODE(BINARY_FLOORDIV_INT)
+OPCODE(BINARY_MOD_INT)
+OPCODE(BINARY_LT_INT)
+OPCODE(BINARY_LE_INT)
+OPCODE(BINARY_GT_INT)
+OPCODE(BINARY_GE_INT)
+OPCODE(BINARY_EQ_INT)
+OPCODE(BINARY_NE_INT)
+OPCODE(BINARY_ADD_FLOAT)
+OPCODE(BINARY_SUB_FLOAT)
+OPCODE(BINARY_MUL_FLOAT)
+OPCODE(BINARY_TRUEDIV_FLOAT)
+OPCODE(BINARY_LT_FLOAT)
+OPCODE(BINARY_LE_FLOAT)
+OPCODE(BINARY_GT_FLOAT)
+OPCODE(BINARY_GE_FLOAT)
+/**************************/
 #endif
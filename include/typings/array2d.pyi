@@ -96,14 +96,37 @@ class array2d_like[T]:
         Returns a tuple `(x, y, width, height)` or raise `ValueError` if the value is not found.
         """
 
-    def convolve(self: array2d_like[int], kernel: array2d_like[int], padding: int) -> array2d[int]:
-        """Convolve the array with the given kernel."""
+    def convolve(self: array2d_like[int | float], kernel: array2d_like[int | float], padding: int | float) -> array2d[int | float]:
+        """Convolve the array with the given kernel.
+
+        The result is `float` if any cell, kernel entry or `padding` is `float`, otherwise `int`.
+        """
 
     def get_connected_components(self, value: T, neighborhood: Neighborhood) -> tuple[array2d[int], int]:
-        """Get connected components of the grid via BFS algorithm.
+        """Get connected components of the grid via two-pass union-find labeling.
 
         Returns the `visited` array and the number of connected components,
         where `0` means unvisited, and non-zero means the index of the connected component.
+        Components are numbered in row-major order of their first cell.
+        """
+
+    def flood_fill(self, pos: vec2i, value: T, neighborhood: Neighborhood = 'von Neumann') -> int:
+        """Replace the region connected to `pos` that has the same value as `self[pos]`.
+
+        Returns the number of cells changed.
+        """
+
+    def get_distance_field(self, sources: vec2i | list[vec2i], value: T, neighborhood: Neighborhood = 'von Neumann') -> array2d_packed[int]:
+        """Get the BFS step count from the nearest source, walking only through cells equal to `value`.
+
+        Returns an `int32` array where unreachable cells are `-1`.
+        """
+
+    def find_path(self, start: vec2i, goal: vec2i, value: T, neighborhood: Neighborhood = 'von Neumann', cost: array2d_like[float] | None = None) -> list[vec2i] | None:
+        """Find the cheapest path from `start` to `goal` via A* algorithm, walking only through cells equal to `value`.
+
+        `cost` gives the positive cost of entering each cell, default to `1`.
+        Returns the cells of the path including both ends, or `None` if `goal` is unreachable.
         """
 
 
@@ -124,6 +147,28 @@ class array2d[T](array2d_like[T]):
     def fromlist(data: list[list[T]]) -> array2d[T]: ...
 
 
+class array2d_packed[T: int | float | bool](array2d_like[T]):
+    """An array2d that stores unboxed cells of `dtype` in a contiguous buffer.
+
+    Element-wise operators, masking, `count`, `any/all` and `get_bounding_rect`
+    run over the raw buffer when both operands are `array2d_packed` of the same `dtype`
+    (or one side is a number), and return `array2d_packed`. Other cases fall back to `array2d`.
+    Integer arithmetic wraps around, `/` produces `float32`.
+    """
+    def __new__(
+            cls,
+            n_cols: int,
+            n_rows: int,
+            dtype: Literal['bool', 'int8', 'int32', 'float32'],
+            default: T | Callable[[vec2i], T] | None = None
+            ): ...
+
+    @property
+    def dtype(self) -> Literal['bool', 'int8', 'int32', 'float32']: ...
+
+    def copy(self) -> 'array2d_packed[T]': ...
+
+
 class chunked_array2d[T, TContext]:
     def __new__(
             cls,
@@ -138,6 +183,9 @@ class chunked_array2d[T, TContext]:
     def default(self) -> T: ...
     @property
     def context_builder(self) -> Callable[[vec2i], TContext] | None: ...
+    @property
+    def resident_chunks(self) -> int:
+        """Number of chunks whose cells are in memory."""
 
     def __getitem__(self, index: vec2i) -> T: ...
     def __setitem__(self, index: vec2i, value: T): ...
@@ -156,6 +204,19 @@ class chunked_array2d[T, TContext]:
     def move_chunk(self, src_chunk_pos: vec2i, dst_chunk_pos: vec2i) -> bool: ...
     def get_context(self, chunk_pos: vec2i) -> TContext | None: ...
 
+    def set_streaming(
+            self,
+            max_resident_chunks: int,
+            save: Callable[[vec2i, bytes], None] | None = None,
+            load: Callable[[vec2i], bytes] | None = None,
+            ) -> None:
+        """Keeps at most `max_resident_chunks` chunks in memory, `0` means unbounded.
+
+        When the limit is exceeded, the least recently used chunk is pickled and passed to `save`,
+        then its cells are released. Accessing it later calls `load` to get the data back.
+        Contexts always stay in memory. Unset cells are saved as `default`.
+        """
+
     def view(self) -> array2d_view[T]: ...
     def view_rect(self, pos: vec2i, width: int, height: int) -> array2d_view[T]: ...
     def view_chunk(self, chunk_pos: vec2i) -> array2d_view[T]: ...
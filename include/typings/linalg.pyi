@@ -95,6 +95,8 @@ class mat3x3:
     def __matmul__(self, other: mat3x3) -> mat3x3: ...
     @overload
     def __matmul__(self, other: vec3) -> vec3: ...
+    @overload
+    def __matmul__(self, other: vec3_array) -> vec3_array: ...
 
     def __invert__(self) -> mat3x3: ...
 
@@ -181,3 +183,48 @@ class vec3(_vecF['vec3']):
 
 
 
+
+class _vecF_array[T, TArray]:
+    """A fixed-length array of packed float vectors, e.g. `x0, y0, x1, y1, ...`."""
+    @overload
+    def __init__(self, length: int) -> None: ...
+    @overload
+    def __init__(self, data: list[T] | tuple[T, ...]) -> None: ...
+
+    def __len__(self) -> int: ...
+    def __getitem__(self, index: int) -> T: ...
+    def __setitem__(self, index: int, value: T) -> None: ...
+
+    def __add__(self, other: TArray | T | float) -> TArray: ...
+    def __sub__(self, other: TArray | T | float) -> TArray: ...
+    def __mul__(self, other: TArray | T | float) -> TArray: ...
+
+    def add_(self, other: TArray | T | float) -> None: ...
+    def sub_(self, other: TArray | T | float) -> None: ...
+    def mul_(self, other: TArray | T | float) -> None: ...
+
+    def dot(self, other: TArray | T) -> list[float]: ...
+    def length(self) -> list[float]: ...
+    def normalize(self) -> TArray:
+        """Zero vectors stay zero."""
+    def normalize_(self) -> None: ...
+    def lerp(self, other: TArray | T, t: float) -> TArray: ...
+
+    def copy(self) -> TArray: ...
+    def tolist(self) -> list[T]: ...
+    def tobytes(self) -> bytes:
+        """Returns the packed float32 data in native byte order."""
+    @staticmethod
+    def frombytes(data: bytes) -> TArray: ...
+
+
+class vec2_array(_vecF_array[vec2, 'vec2_array']):
+    def transform_point(self, m: mat3x3) -> vec2_array: ...
+    def transform_vector(self, m: mat3x3) -> vec2_array: ...
+    def transform_point_(self, m: mat3x3) -> None: ...
+    def transform_vector_(self, m: mat3x3) -> None: ...
+
+
+class vec3_array(_vecF_array[vec3, 'vec3_array']):
+    def transform_(self, m: mat3x3) -> None:
+        """Same as `self = m @ self`."""
@@ -1,7 +1,7 @@
 #include "pocketpy/common/smallmap.h"
 
 #define SMALLMAP_T__SOURCE
-#define K uint16_t
+#define K uint32_t
 #define V int
 #define NAME c11_smallmap_n2i
 #include "pocketpy/xmacros/smallmap.h"
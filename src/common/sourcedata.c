@@ -26,7 +26,7 @@ static void SourceData__ctor(struct SourceData* self,
     }
     self->source = c11_sbuf__submit(&ss);
     self->is_dynamic = is_dynamic;
-    c11_vector__push(const char*, &self->line_starts, self->source->data);
+    c11_vector__push(const char*, &self->line_starts, c11_string__sv(self->source).data);
 }
 
 static void SourceData__dtor(struct SourceData* self) {
@@ -35,6 +35,23 @@ static void SourceData__dtor(struct SourceData* self) {
     c11_vector__dtor(&self->line_starts);
 }
 
+SourceData_ SourceData__rcnew_view(c11_sv source,
+                                   const char* filename,
+                                   enum py_CompileMode mode,
+                                   bool is_dynamic) {
+    SourceData_ self = PK_MALLOC(sizeof(struct SourceData));
+    self->filename = c11_string__new(filename);
+    self->mode = mode;
+    c11_vector__ctor(&self->line_starts, sizeof(const char*));
+    self->source = PK_MALLOC(sizeof(c11_string) + sizeof(c11_string_ref));
+    c11_string__ctor_view(self->source, source);
+    self->is_dynamic = is_dynamic;
+    c11_vector__push(const char*, &self->line_starts, c11_string__sv(self->source).data);
+    self->rc.count = 1;
+    self->rc.dtor = (void (*)(void*))SourceData__dtor;
+    return self;
+}
+
 SourceData_ SourceData__rcnew(const char* source,
                               const char* filename,
                               enum py_CompileMode mode,
@@ -46,6 +63,16 @@ SourceData_ SourceData__rcnew(const char* source,
     return self;
 }
 
+void SourceData__index_lines(struct SourceData* self) {
+    c11_vector__clear(&self->line_starts);
+    c11_vector__push(const char*, &self->line_starts, c11_string__sv(self->source).data);
+    const char* p = c11_string__sv(self->source).data;
+    while((p = strchr(p, '\n')) != NULL) {
+        p++;
+        c11_vector__push(const char*, &self->line_starts, p);
+    }
+}
+
 bool SourceData__get_line(const struct SourceData* self,
                           int lineno,
                           const char** st,
@@ -53,6 +80,11 @@ bool SourceData__get_line(const struct SourceData* self,
     if(lineno < 0) return false;
     lineno -= 1;
     if(lineno < 0) lineno = 0;
+    if(lineno >= self->line_starts.length) {
+        // a code object loaded from cache does not run the lexer
+        SourceData__index_lines((struct SourceData*)self);
+        if(lineno >= self->line_starts.length) return false;
+    }
     const char* _start = c11__getitem(const char*, &self->line_starts, lineno);
     const char* i = _start;
     // max 300 chars
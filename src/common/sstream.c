@@ -156,6 +156,9 @@ c11_string* c11_sbuf__submit(c11_sbuf* self) {
     int arr_length;
     c11_string* retval = c11_vector__submit(&self->data, &arr_length);
     retval->size = arr_length - sizeof(c11_string) - 1;
+    retval->hash = 0;
+    retval->u8_kind = C11_U8_UNKNOWN;
+    retval->is_view = false;
     return retval;
 }
 
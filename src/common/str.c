@@ -8,6 +8,82 @@
 #include <ctype.h>
 #include <stdio.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PK_STR_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PK_STR_NEON 1
+#endif
+
+/* Vector kernels work on 16-byte blocks and leave the tail to the scalar loops.
+ * A match mask has one bit per byte for SSE2 and one bit per nibble for NEON. */
+#if PK_STR_NEON
+#define STR_LANE_SHIFT 2
+#define STR_ASCII_MASK 0x8888888888888888ULL
+#else
+#define STR_LANE_SHIFT 0
+#define STR_ASCII_MASK 0xFFFFULL
+#endif
+
+#if PK_STR_SSE2
+typedef __m128i StrBlock;
+#define StrBlock__load(p) _mm_loadu_si128((const __m128i*)(p))
+#define StrBlock__splat(c) _mm_set1_epi8((char)(c))
+#define StrBlock__eq(a, b) _mm_cmpeq_epi8((a), (b))
+#define StrBlock__and(a, b) _mm_and_si128((a), (b))
+
+static uint64_t StrBlock__mask(StrBlock cmp) { return (uint16_t)_mm_movemask_epi8(cmp); }
+#elif PK_STR_NEON
+typedef uint8x16_t StrBlock;
+#define StrBlock__load(p) vld1q_u8((const uint8_t*)(p))
+#define StrBlock__splat(c) vdupq_n_u8((uint8_t)(c))
+#define StrBlock__eq(a, b) vceqq_u8((a), (b))
+#define StrBlock__and(a, b) vandq_u8((a), (b))
+
+static uint64_t StrBlock__mask(StrBlock cmp) {
+    uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+}
+#endif
+
+// first occurrence of `needle` in `hay`, `m` must be at least 2
+static int c11__find(const char* hay, int n, const char* needle, int m) {
+    int i = 0;
+#if PK_STR_SSE2 || PK_STR_NEON
+    // compare the first and the last byte of 16 candidates at once
+    StrBlock first = StrBlock__splat(needle[0]);
+    StrBlock last = StrBlock__splat(needle[m - 1]);
+    for(; i + m - 1 + 16 <= n; i += 16) {
+        StrBlock a = StrBlock__eq(StrBlock__load(hay + i), first);
+        StrBlock b = StrBlock__eq(StrBlock__load(hay + i + m - 1), last);
+        uint64_t mask = StrBlock__mask(StrBlock__and(a, b));
+        while(mask) {
+            int k = i + (c11__ctz64(mask) >> STR_LANE_SHIFT);
+            if(memcmp(hay + k + 1, needle + 1, m - 2) == 0) return k;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    while(i <= n - m) {
+        const char* p = memchr(hay + i, needle[0], n - m - i + 1);
+        if(p == NULL) return -1;
+        i = (int)(p - hay);
+        if(memcmp(p + 1, needle + 1, m - 1) == 0) return i;
+        i++;
+    }
+    return -1;
+}
+
+#define U8_INDEX_STRIDE 64
+#define U8_INDEX_OFFSET(size) (((size) + 4) & ~3)  // after the null-terminator, aligned to 4
+#define U8_IS_CONT(c) (((c) & 0xC0) == 0x80)
+
+static int c11_u8index__sizeof(int size) {
+    int count = (size + U8_INDEX_STRIDE - 1) / U8_INDEX_STRIDE;
+    return sizeof(c11_u8index) + sizeof(int) * count;
+}
+
 c11_string* c11_string__new(const char* data) { return c11_string__new2(data, strlen(data)); }
 
 c11_string* c11_string__new2(const char* data, int size) {
@@ -32,28 +108,204 @@ void c11_string__ctor(c11_string* self, const char* data) {
 }
 
 void c11_string__ctor2(c11_string* self, const char* data, int size) {
-    self->size = size;
-    char* p = (char*)self->data;
-    memcpy(p, data, size);
-    p[size] = '\0';
+    c11_string__ctor3(self, size);
+    memcpy(self->data, data, size);
+}
+
+void c11_string__ctor_view(c11_string* self, c11_sv sv) {
+    assert(sv.data[sv.size] == '\0');
+    self->size = sv.size;
+    self->hash = 0;
+    self->u8_kind = C11_U8_UNKNOWN;
+    self->is_view = true;
+    c11_string_ref* ref = c11_string__ref(self);
+    ref->data = (char*)sv.data;
+    ref->capacity = sv.size + 1;
+    ref->u8_index = NULL;
+}
+
+c11_string_ref* c11_string__ref(c11_string* self) {
+    assert(self->is_view);
+    return (c11_string_ref*)self->data;
 }
 
 void c11_string__ctor3(c11_string* self, int size) {
     self->size = size;
-    char* p = (char*)self->data;
-    p[size] = '\0';
+    self->hash = 0;
+    self->u8_kind = C11_U8_UNKNOWN;
+    self->is_view = false;
+    self->data[size] = '\0';
+}
+
+int c11_string__sizeof(int size, bool ascii) {
+    if(ascii) return sizeof(c11_string) + size + 1;
+    return sizeof(c11_string) + U8_INDEX_OFFSET(size) + c11_u8index__sizeof(size);
+}
+
+void c11_string__ctor4(c11_string* self, int size, bool ascii) {
+    c11_string__ctor3(self, size);
+    if(ascii) {
+        self->u8_kind = C11_U8_ASCII;
+    } else {
+        // the bytes are not written yet, so the index is built on first use
+        self->u8_kind = C11_U8_INDEXED;
+        c11_u8index* index = (c11_u8index*)(self->data + U8_INDEX_OFFSET(size));
+        index->length = -1;
+    }
 }
 
 c11_string* c11_string__copy(c11_string* self) {
-    int total_size = sizeof(c11_string) + self->size + 1;
-    c11_string* retval = PK_MALLOC(total_size);
-    memcpy(retval, self, total_size);
+    c11_sv sv = c11_string__sv(self);
+    c11_string* retval = c11_string__new2(sv.data, sv.size);
+    retval->hash = self->hash;
+    if(self->u8_kind == C11_U8_ASCII) retval->u8_kind = C11_U8_ASCII;
     return retval;
 }
 
-void c11_string__delete(c11_string* self) { PK_FREE(self); }
+void c11_string__dtor(c11_string* self) {
+    if(!self->is_view) return;
+    c11_string_ref* ref = c11_string__ref(self);
+    PK_FREE(ref->u8_index);
+    ref->u8_index = NULL;
+}
+
+void c11_string__delete(c11_string* self) {
+    c11_string__dtor(self);
+    PK_FREE(self);
+}
+
+uint32_t c11_string__hash(c11_string* self) {
+    if(self->hash == 0) {
+        c11_sv sv = c11_string__sv(self);
+        uint64_t h = c11__hash_bytes(sv.data, sv.size);
+        uint32_t h29 = (uint32_t)(h ^ (h >> 32)) & 0x1FFFFFFF;  // the width of `hash`
+        self->hash = h29 ? h29 : 1;
+    }
+    return self->hash;
+}
+
+c11_sv c11_string__sv(c11_string* self) {
+    if(self->is_view) return (c11_sv){c11_string__ref(self)->data, self->size};
+    return (c11_sv){self->data, self->size};
+}
 
-c11_sv c11_string__sv(c11_string* self) { return (c11_sv){self->data, self->size}; }
+static c11_u8kind c11_string__u8_kind(c11_string* self) {
+    if(self->u8_kind == C11_U8_UNKNOWN) {
+        c11_sv sv = c11_string__sv(self);
+        if(c11__is_ascii(sv.data, sv.size)) {
+            self->u8_kind = C11_U8_ASCII;
+        } else {
+            // a view can allocate its index aside, an inline string has no room left for it
+            self->u8_kind = self->is_view ? C11_U8_INDEXED : C11_U8_UNINDEXED;
+        }
+    }
+    return self->u8_kind;
+}
+
+static c11_u8index* c11_string__u8_index(c11_string* self) {
+    assert(self->u8_kind == C11_U8_INDEXED);
+    c11_u8index* index;
+    if(self->is_view) {
+        c11_string_ref* ref = c11_string__ref(self);
+        if(ref->u8_index == NULL) {
+            ref->u8_index = PK_MALLOC(c11_u8index__sizeof(self->size));
+            ref->u8_index->length = -1;
+        }
+        index = ref->u8_index;
+    } else {
+        index = (c11_u8index*)(self->data + U8_INDEX_OFFSET(self->size));
+    }
+    if(index->length == -1) {
+        const char* data = c11_string__sv(self).data;
+        int k = 0;
+        for(int j = 0; j < self->size; j++) {
+            if(U8_IS_CONT(data[j])) continue;
+            if(k % U8_INDEX_STRIDE == 0) index->offsets[k / U8_INDEX_STRIDE] = j;
+            k++;
+        }
+        index->length = k;
+    }
+    return index;
+}
+
+int c11_string__u8_length(c11_string* self) {
+    switch(c11_string__u8_kind(self)) {
+        case C11_U8_ASCII: return self->size;
+        case C11_U8_INDEXED: return c11_string__u8_index(self)->length;
+        default: {
+            c11_sv sv = c11_string__sv(self);
+            return c11__byte_index_to_unicode(sv.data, sv.size);
+        }
+    }
+}
+
+bool c11_string__is_ascii(c11_string* self) { return c11_string__u8_kind(self) == C11_U8_ASCII; }
+
+int c11_string__u8_byte_index(c11_string* self, int i) {
+    c11_u8kind kind = c11_string__u8_kind(self);
+    if(kind == C11_U8_ASCII) return i;
+    const char* data = c11_string__sv(self).data;
+    if(kind == C11_U8_UNINDEXED) return c11__unicode_index_to_byte(data, i);
+    c11_u8index* index = c11_string__u8_index(self);
+    if(i >= index->length) return self->size;
+    int j = index->offsets[i / U8_INDEX_STRIDE];
+    for(int k = i % U8_INDEX_STRIDE; k > 0; k--) {
+        j++;
+        while(j < self->size && U8_IS_CONT(data[j]))
+            j++;
+    }
+    return j;
+}
+
+c11_sv c11_string__u8_getitem(c11_string* self, int i) {
+    const char* data = c11_string__sv(self).data;
+    int start = c11_string__u8_byte_index(self, i);
+    int stop = start + 1;
+    while(stop < self->size && U8_IS_CONT(data[stop]))
+        stop++;
+    return (c11_sv){data + start, stop - start};
+}
+
+c11_string* c11_string__u8_slice(c11_string* self, int start, int stop, int step) {
+    assert(step != 0);
+    const char* data = c11_string__sv(self).data;
+    if(step == 1) {
+        if(stop <= start) return c11_string__new2("", 0);
+        int i = c11_string__u8_byte_index(self, start);
+        int j = c11_string__u8_byte_index(self, stop);
+        return c11_string__new2(data + i, j - i);
+    }
+    c11_sbuf ss;
+    c11_sbuf__ctor(&ss);
+    if(c11_string__is_ascii(self)) {
+        for(int i = start; step > 0 ? i < stop : i > stop; i += step) {
+            c11_sbuf__write_char(&ss, data[i]);
+        }
+        return c11_sbuf__submit(&ss);
+    }
+    // walk the bytes from the first codepoint instead of indexing each one
+    int j = c11_string__u8_byte_index(self, start);
+    for(int i = start; step > 0 ? i < stop : i > stop; i += step) {
+        int next = j + 1;
+        while(next < self->size && U8_IS_CONT(data[next]))
+            next++;
+        c11_sbuf__write_sv(&ss, (c11_sv){data + j, next - j});
+        if(step > 0) {
+            for(int k = 0; k < step && j < self->size; k++) {
+                j++;
+                while(j < self->size && U8_IS_CONT(data[j]))
+                    j++;
+            }
+        } else {
+            for(int k = 0; k < -step && j > 0; k++) {
+                j--;
+                while(j > 0 && U8_IS_CONT(data[j]))
+                    j--;
+            }
+        }
+    }
+    return c11_sbuf__submit(&ss);
+}
 
 c11_string* c11_sv__replace(c11_sv self, char old, char new_) {
     c11_string* retval = c11_string__new2(self.data, self.size);
@@ -111,34 +363,35 @@ c11_sv c11_sv__slice2(c11_sv sv, int start, int stop) {
 }
 
 c11_sv c11_sv__strip(c11_sv sv, c11_sv chars, bool left, bool right) {
+    // walk codepoints by their byte offsets
     int L = 0;
-    int R = c11_sv__u8_length(sv);
+    int R = sv.size;
     if(left) {
         while(L < R) {
-            c11_sv tmp = c11_sv__u8_getitem(sv, L);
-            bool found = c11_sv__index2(chars, tmp, 0) != -1;
-            if(!found) break;
-            L++;
+            int next = L + 1;
+            while(next < R && U8_IS_CONT(sv.data[next]))
+                next++;
+            c11_sv tmp = {sv.data + L, next - L};
+            if(c11_sv__index2(chars, tmp, 0) == -1) break;
+            L = next;
         }
     }
     if(right) {
         while(L < R) {
-            c11_sv tmp = c11_sv__u8_getitem(sv, R - 1);
-            bool found = c11_sv__index2(chars, tmp, 0) != -1;
-            if(!found) break;
-            R--;
+            int prev = R - 1;
+            while(prev > L && U8_IS_CONT(sv.data[prev]))
+                prev--;
+            c11_sv tmp = {sv.data + prev, R - prev};
+            if(c11_sv__index2(chars, tmp, 0) == -1) break;
+            R = prev;
         }
     }
-    int start = c11__unicode_index_to_byte(sv.data, L);
-    int stop = c11__unicode_index_to_byte(sv.data, R);
-    return c11_sv__slice2(sv, start, stop);
+    return c11_sv__slice2(sv, L, R);
 }
 
 int c11_sv__index(c11_sv self, char c) {
-    for(int i = 0; i < self.size; i++) {
-        if(self.data[i] == c) return i;
-    }
-    return -1;
+    const char* p = memchr(self.data, c, self.size);
+    return p ? (int)(p - self.data) : -1;
 }
 
 int c11_sv__rindex(c11_sv self, char c) {
@@ -150,12 +403,16 @@ int c11_sv__rindex(c11_sv self, char c) {
 
 int c11_sv__index2(c11_sv self, c11_sv sub, int start) {
     if(sub.size == 0) return start;
-    int max_end = self.size - sub.size;
-    for(int i = start; i <= max_end; i++) {
-        int res = memcmp(self.data + i, sub.data, sub.size);
-        if(res == 0) return i;
+    if(start < 0) start = 0;
+    if(self.size - start < sub.size) return -1;
+    int res;
+    if(sub.size == 1) {
+        const char* p = memchr(self.data + start, sub.data[0], self.size - start);
+        res = p ? (int)(p - (self.data + start)) : -1;
+    } else {
+        res = c11__find(self.data + start, self.size - start, sub.data, sub.size);
     }
-    return -1;
+    return res == -1 ? -1 : start + res;
 }
 
 int c11_sv__count(c11_sv self, c11_sv sub) {
@@ -186,13 +443,13 @@ c11_vector /* T=c11_sv */ c11_sv__split(c11_sv self, char sep) {
     c11_vector__ctor(&retval, sizeof(c11_sv));
     const char* data = self.data;
     int i = 0;
-    for(int j = 0; j < self.size; j++) {
-        if(data[j] == sep) {
-            assert(j >= i);
-            c11_sv tmp = {data + i, j - i};
-            c11_vector__push(c11_sv, &retval, tmp);
-            i = j + 1;
-        }
+    while(true) {
+        const char* p = memchr(data + i, sep, self.size - i);
+        if(p == NULL) break;
+        int j = (int)(p - data);
+        c11_sv tmp = {data + i, j - i};
+        c11_vector__push(c11_sv, &retval, tmp);
+        i = j + 1;
     }
     if(i <= self.size) {
         c11_sv tmp = {data + i, self.size - i};
@@ -229,13 +486,101 @@ int c11__unicode_index_to_byte(const char* data, int i) {
 }
 
 int c11__byte_index_to_unicode(const char* data, int n) {
+    // count the bytes which are not continuation bytes, i.e. greater than (int8_t)0xBF
     int cnt = 0;
-    for(int i = 0; i < n; i++) {
-        if((data[i] & 0xC0) != 0x80) cnt++;
+    int i = 0;
+#if PK_STR_SSE2
+    const __m128i cont_max = _mm_set1_epi8((char)0xBF);
+    while(i + 16 <= n) {
+        // per-lane counters are flushed before they can overflow
+        __m128i acc = _mm_setzero_si128();
+        for(int k = 0; k < 255 && i + 16 <= n; k++, i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+            acc = _mm_sub_epi8(acc, _mm_cmpgt_epi8(v, cont_max));
+        }
+        __m128i sum = _mm_sad_epu8(acc, _mm_setzero_si128());
+        cnt += _mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8));
+    }
+#elif PK_STR_NEON
+    const int8x16_t cont_max = vdupq_n_s8((int8_t)0xBF);
+    while(i + 16 <= n) {
+        uint8x16_t acc = vdupq_n_u8(0);
+        for(int k = 0; k < 255 && i + 16 <= n; k++, i += 16) {
+            int8x16_t v = vld1q_s8((const int8_t*)(data + i));
+            acc = vsubq_u8(acc, vcgtq_s8(v, cont_max));
+        }
+        uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(acc)));
+        cnt += (int)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+    }
+#endif
+    for(; i < n; i++) {
+        if(!U8_IS_CONT(data[i])) cnt++;
     }
     return cnt;
 }
 
+bool c11__u8_validate(const char* data, int n) {
+    const unsigned char* p = (const unsigned char*)data;
+    int i = 0;
+    while(i < n) {
+#if PK_STR_SSE2 || PK_STR_NEON
+        // skip ascii blocks, a byte is ascii iff its high bit is clear
+        const StrBlock high = StrBlock__splat(0x80);
+        const StrBlock zero = StrBlock__splat(0);
+        while(i + 16 <= n) {
+            StrBlock v = StrBlock__and(StrBlock__load(p + i), high);
+            if(StrBlock__mask(StrBlock__eq(v, zero)) != STR_ASCII_MASK) break;
+            i += 16;
+        }
+        if(i >= n) break;
+#endif
+        unsigned char c = p[i];
+        if(c < 0x80) {
+            i++;
+            continue;
+        }
+        int size;
+        uint32_t min_value;
+        uint32_t value;
+        if((c & 0xE0) == 0xC0) {
+            size = 2, min_value = 0x80, value = c & 0x1F;
+        } else if((c & 0xF0) == 0xE0) {
+            size = 3, min_value = 0x800, value = c & 0x0F;
+        } else if((c & 0xF8) == 0xF0) {
+            size = 4, min_value = 0x10000, value = c & 0x07;
+        } else {
+            return false;
+        }
+        if(i + size > n) return false;
+        for(int k = 1; k < size; k++) {
+            if(!U8_IS_CONT(p[i + k])) return false;
+            value = (value << 6) | (p[i + k] & 0x3F);
+        }
+        // reject overlong forms, surrogates and values beyond U+10FFFF
+        if(value < min_value || value > 0x10FFFF) return false;
+        if(value >= 0xD800 && value <= 0xDFFF) return false;
+        i += size;
+    }
+    return true;
+}
+
+bool c11__is_ascii(const char* data, int n) {
+    const unsigned char* p = (const unsigned char*)data;
+    int i = 0;
+#if PK_STR_SSE2 || PK_STR_NEON
+    const StrBlock high = StrBlock__splat(0x80);
+    const StrBlock zero = StrBlock__splat(0);
+    for(; i + 16 <= n; i += 16) {
+        StrBlock v = StrBlock__and(StrBlock__load(p + i), high);
+        if(StrBlock__mask(StrBlock__eq(v, zero)) != STR_ASCII_MASK) return false;
+    }
+#endif
+    for(; i < n; i++) {
+        if(p[i] >= 0x80) return false;
+    }
+    return true;
+}
+
 //////////////
 bool c11_bytes__eq(c11_bytes* self, c11_bytes* other) {
     if(self->size != other->size) return false;
@@ -437,4 +782,100 @@ IntParsingResult c11__parse_uint(c11_sv text, int64_t* out, int base) {
         return IntParsing_SUCCESS;
     }
     return IntParsing_FAILURE;
-}
\ No newline at end of file
+}
+
+static void wyhash__mum(uint64_t* a, uint64_t* b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+    uint64_t c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    *a = lo;
+    *b = hi;
+#endif
+}
+
+static uint64_t wyhash__mix(uint64_t a, uint64_t b) {
+    wyhash__mum(&a, &b);
+    return a ^ b;
+}
+
+static uint64_t wyhash__r8(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static uint64_t wyhash__r4(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static uint64_t wyhash__r3(const uint8_t* p, size_t k) {
+    return (((uint64_t)p[0]) << 16) | (((uint64_t)p[k >> 1]) << 8) | p[k - 1];
+}
+
+uint64_t c11__hash_bytes(const void* data, int size) {
+    static const uint64_t secret[4] = {0xa0761d6478bd642full,
+                                       0xe7037ed1a0b428dbull,
+                                       0x8ebc6af09c88c6e3ull,
+                                       0x589965cc75374cc3ull};
+    const uint8_t* p = (const uint8_t*)data;
+    size_t len = (size_t)size;
+    uint64_t seed = wyhash__mix(secret[0], secret[1]);
+    uint64_t a, b;
+    if(len <= 16) {
+        if(len >= 4) {
+            a = (wyhash__r4(p) << 32) | wyhash__r4(p + ((len >> 3) << 2));
+            b = (wyhash__r4(p + len - 4) << 32) | wyhash__r4(p + len - 4 - ((len >> 3) << 2));
+        } else if(len > 0) {
+            a = wyhash__r3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if(i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wyhash__mix(wyhash__r8(p) ^ secret[1], wyhash__r8(p + 8) ^ seed);
+                see1 = wyhash__mix(wyhash__r8(p + 16) ^ secret[2], wyhash__r8(p + 24) ^ see1);
+                see2 = wyhash__mix(wyhash__r8(p + 32) ^ secret[3], wyhash__r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while(i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while(i > 16) {
+            seed = wyhash__mix(wyhash__r8(p) ^ secret[1], wyhash__r8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wyhash__r8(p + i - 16);
+        b = wyhash__r8(p + i - 8);
+    }
+    a ^= secret[1];
+    b ^= seed;
+    wyhash__mum(&a, &b);
+    return wyhash__mix(a ^ secret[0] ^ len, b ^ secret[1]);
+}
+
+#undef U8_INDEX_STRIDE
+#undef U8_INDEX_OFFSET
+#undef U8_IS_CONT
+#undef PK_STR_SSE2
+#undef PK_STR_NEON
+#undef STR_LANE_SHIFT
+#undef STR_ASCII_MASK
+#undef StrBlock__load
+#undef StrBlock__splat
+#undef StrBlock__eq
+#undef StrBlock__and
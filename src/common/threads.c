@@ -0,0 +1,108 @@
+#include "pocketpy/common/threads.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef WIN32_LEAN_AND_MEAN
+
+void c11_thrd__yield() { SwitchToThread(); }
+#else
+#include <sched.h>
+
+void c11_thrd__yield() { sched_yield(); }
+#endif
+
+void c11_spinlock__lock(c11_spinlock* self) {
+    while(!c11__atomic_cas(&self->value, 0, 1)) {
+        while(c11__atomic_load(&self->value) != 0)
+            c11_thrd__yield();
+    }
+}
+
+void c11_spinlock__unlock(c11_spinlock* self) { c11__atomic_store(&self->value, 0); }
+
+#if PK_ENABLE_THREADS
+
+#ifdef _WIN32
+#include <process.h>
+
+static unsigned __stdcall c11_thrd__entry(void* arg) {
+    c11_thrd* self = arg;
+    self->func(self->arg);
+    return 0;
+}
+
+bool c11_thrd__create(c11_thrd* self, void (*func)(void*), void* arg) {
+    self->func = func;
+    self->arg = arg;
+    self->handle = (void*)_beginthreadex(NULL, 0, c11_thrd__entry, self, 0, NULL);
+    return self->handle != NULL;
+}
+
+void c11_thrd__join(c11_thrd* self) {
+    WaitForSingleObject((HANDLE)self->handle, INFINITE);
+    CloseHandle((HANDLE)self->handle);
+}
+
+void c11_mtx__ctor(c11_mtx* self) { InitializeSRWLock((PSRWLOCK)&self->handle); }
+
+void c11_mtx__dtor(c11_mtx* self) {}
+
+void c11_mtx__lock(c11_mtx* self) { AcquireSRWLockExclusive((PSRWLOCK)&self->handle); }
+
+void c11_mtx__unlock(c11_mtx* self) { ReleaseSRWLockExclusive((PSRWLOCK)&self->handle); }
+
+void c11_cnd__ctor(c11_cnd* self) {
+    InitializeConditionVariable((PCONDITION_VARIABLE)&self->handle);
+}
+
+void c11_cnd__dtor(c11_cnd* self) {}
+
+void c11_cnd__wait(c11_cnd* self, c11_mtx* mtx) {
+    SleepConditionVariableSRW((PCONDITION_VARIABLE)&self->handle,
+                              (PSRWLOCK)&mtx->handle,
+                              INFINITE,
+                              0);
+}
+
+void c11_cnd__signal(c11_cnd* self) { WakeConditionVariable((PCONDITION_VARIABLE)&self->handle); }
+
+void c11_cnd__broadcast(c11_cnd* self) {
+    WakeAllConditionVariable((PCONDITION_VARIABLE)&self->handle);
+}
+
+#else
+static void* c11_thrd__entry(void* arg) {
+    c11_thrd* self = arg;
+    self->func(self->arg);
+    return NULL;
+}
+
+bool c11_thrd__create(c11_thrd* self, void (*func)(void*), void* arg) {
+    self->func = func;
+    self->arg = arg;
+    return pthread_create(&self->handle, NULL, c11_thrd__entry, self) == 0;
+}
+
+void c11_thrd__join(c11_thrd* self) { pthread_join(self->handle, NULL); }
+
+void c11_mtx__ctor(c11_mtx* self) { pthread_mutex_init(&self->handle, NULL); }
+
+void c11_mtx__dtor(c11_mtx* self) { pthread_mutex_destroy(&self->handle); }
+
+void c11_mtx__lock(c11_mtx* self) { pthread_mutex_lock(&self->handle); }
+
+void c11_mtx__unlock(c11_mtx* self) { pthread_mutex_unlock(&self->handle); }
+
+void c11_cnd__ctor(c11_cnd* self) { pthread_cond_init(&self->handle, NULL); }
+
+void c11_cnd__dtor(c11_cnd* self) { pthread_cond_destroy(&self->handle); }
+
+void c11_cnd__wait(c11_cnd* self, c11_mtx* mtx) { pthread_cond_wait(&self->handle, &mtx->handle); }
+
+void c11_cnd__signal(c11_cnd* self) { pthread_cond_signal(&self->handle); }
+
+void c11_cnd__broadcast(c11_cnd* self) { pthread_cond_broadcast(&self->handle); }
+#endif
+
+#endif
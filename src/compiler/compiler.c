@@ -73,10 +73,12 @@ static void Ctx__dtor(Ctx* self);
 static int Ctx__prepare_loop_divert(Ctx* self, int line, bool is_break);
 static int Ctx__enter_block(Ctx* self, CodeBlockType type);
 static void Ctx__exit_block(Ctx* self);
-static int Ctx__emit_(Ctx* self, Opcode opcode, uint16_t arg, int line);
-static int Ctx__emit_virtual(Ctx* self, Opcode opcode, uint16_t arg, int line, bool virtual);
+static int Ctx__emit_(Ctx* self, Opcode opcode, int arg, int line);
+static int Ctx__emit_virtual(Ctx* self, Opcode opcode, int arg, int line, bool virtual);
 static void Ctx__revert_last_emit_(Ctx* self);
 static int Ctx__emit_int(Ctx* self, int64_t value, int line);
+static int Ctx__emit_attr(Ctx* self, Opcode opcode, py_Name name, int line);
+static int Ctx__emit_name(Ctx* self, Opcode opcode, py_Name name, int line);
 static void Ctx__patch_jump(Ctx* self, int index);
 static void Ctx__emit_jump(Ctx* self, int target, int line);
 static int Ctx__add_varname(Ctx* self, py_Name name);
@@ -117,7 +119,7 @@ void NameExpr__emit_(Expr* self_, Ctx* ctx) {
                 }
             }
         }
-        Ctx__emit_(ctx, op, self->name, self->line);
+        Ctx__emit_name(ctx, op, self->name, self->line);
     }
 }
 
@@ -129,7 +131,7 @@ bool NameExpr__emit_del(Expr* self_, Ctx* ctx) {
             break;
         case NAME_GLOBAL: {
             Opcode op = ctx->co->src->is_dynamic ? OP_DELETE_NAME : OP_DELETE_GLOBAL;
-            Ctx__emit_(ctx, op, self->name, self->line);
+            Ctx__emit_name(ctx, op, self->name, self->line);
             break;
         }
         default: c11__unreachable();
@@ -140,7 +142,7 @@ bool NameExpr__emit_del(Expr* self_, Ctx* ctx) {
 bool NameExpr__emit_store(Expr* self_, Ctx* ctx) {
     NameExpr* self = (NameExpr*)self_;
     if(ctx->is_compiling_class) {
-        Ctx__emit_(ctx, OP_STORE_CLASS_ATTR, self->name, self->line);
+        Ctx__emit_name(ctx, OP_STORE_CLASS_ATTR, self->name, self->line);
         return true;
     }
     Ctx__emit_store_name(ctx, self->scope, self->name, self->line);
@@ -479,8 +481,11 @@ bool TupleExpr__emit_store(Expr* self_, Ctx* ctx) {
     }
 
     if(starred_i == -1) {
-        Bytecode* prev = c11__at(Bytecode, &ctx->co->codes, ctx->co->codes.length - 1);
-        if(prev->op == OP_BUILD_TUPLE && prev->arg == self->itemCount) {
+        c11_vector* codes = &ctx->co->codes;
+        Bytecode* prev = c11__at(Bytecode, codes, codes->length - 1);
+        int prev_arg = prev->arg;
+        if(codes->length >= 2 && prev[-1].op == OP_EXTENDED_ARG) prev_arg |= prev[-1].arg << 16;
+        if(prev->op == OP_BUILD_TUPLE && prev_arg == self->itemCount) {
             // build tuple and unpack it is meaningless
             Ctx__revert_last_emit_(ctx);
         } else {
@@ -951,20 +956,20 @@ void AttribExpr__dtor(Expr* self_) {
 void AttribExpr__emit_(Expr* self_, Ctx* ctx) {
     AttribExpr* self = (AttribExpr*)self_;
     vtemit_(self->child, ctx);
-    Ctx__emit_(ctx, OP_LOAD_ATTR, self->name, self->line);
+    Ctx__emit_attr(ctx, OP_LOAD_ATTR, self->name, self->line);
 }
 
 bool AttribExpr__emit_del(Expr* self_, Ctx* ctx) {
     AttribExpr* self = (AttribExpr*)self_;
     vtemit_(self->child, ctx);
-    Ctx__emit_(ctx, OP_DELETE_ATTR, self->name, self->line);
+    Ctx__emit_name(ctx, OP_DELETE_ATTR, self->name, self->line);
     return true;
 }
 
 bool AttribExpr__emit_store(Expr* self_, Ctx* ctx) {
     AttribExpr* self = (AttribExpr*)self_;
     vtemit_(self->child, ctx);
-    Ctx__emit_(ctx, OP_STORE_ATTR, self->name, self->line);
+    Ctx__emit_attr(ctx, OP_STORE_ATTR, self->name, self->line);
     return true;
 }
 
@@ -972,14 +977,14 @@ void AttribExpr__emit_inplace(Expr* self_, Ctx* ctx) {
     AttribExpr* self = (AttribExpr*)self_;
     vtemit_(self->child, ctx);
     Ctx__emit_(ctx, OP_DUP_TOP, BC_NOARG, self->line);
-    Ctx__emit_(ctx, OP_LOAD_ATTR, self->name, self->line);
+    Ctx__emit_attr(ctx, OP_LOAD_ATTR, self->name, self->line);
 }
 
 bool AttribExpr__emit_istore(Expr* self_, Ctx* ctx) {
     // [a, val] -> [val, a]
     AttribExpr* self = (AttribExpr*)self_;
     Ctx__emit_(ctx, OP_ROT_TWO, BC_NOARG, self->line);
-    Ctx__emit_(ctx, OP_STORE_ATTR, self->name, self->line);
+    Ctx__emit_attr(ctx, OP_STORE_ATTR, self->name, self->line);
     return true;
 }
 
@@ -1037,7 +1042,7 @@ void CallExpr__emit_(Expr* self_, Ctx* ctx) {
     if(self->callable->vt->is_attrib) {
         AttribExpr* p = (AttribExpr*)self->callable;
         vtemit_(p->child, ctx);
-        Ctx__emit_(ctx, OP_LOAD_METHOD, p->name, p->line);
+        Ctx__emit_attr(ctx, OP_LOAD_METHOD, p->name, p->line);
     } else {
         vtemit_(self->callable, ctx);
         Ctx__emit_(ctx, OP_LOAD_NULL, BC_NOARG, BC_KEEPLINE);
@@ -1152,8 +1157,10 @@ static void Ctx__s_emit_decorators(Ctx* self, int count) {
     }
 }
 
-static int Ctx__emit_virtual(Ctx* self, Opcode opcode, uint16_t arg, int line, bool is_virtual) {
-    Bytecode bc = {(uint8_t)opcode, arg};
+static int Ctx__emit_virtual(Ctx* self, Opcode opcode, int arg, int line, bool is_virtual) {
+    assert(arg >= 0);
+    if(arg > UINT16_MAX) Ctx__emit_virtual(self, OP_EXTENDED_ARG, arg >> 16, line, is_virtual);
+    Bytecode bc = {(uint8_t)opcode, (uint16_t)arg};
     BytecodeEx bcx = {line, is_virtual, self->curr_iblock};
     c11_vector__push(Bytecode, &self->co->codes, bc);
     c11_vector__push(BytecodeEx, &self->co->codes_ex, bcx);
@@ -1163,13 +1170,17 @@ static int Ctx__emit_virtual(Ctx* self, Opcode opcode, uint16_t arg, int line, b
     return i;
 }
 
-static int Ctx__emit_(Ctx* self, Opcode opcode, uint16_t arg, int line) {
+static int Ctx__emit_(Ctx* self, Opcode opcode, int arg, int line) {
     return Ctx__emit_virtual(self, opcode, arg, line, false);
 }
 
 static void Ctx__revert_last_emit_(Ctx* self) {
-    c11_vector__pop(&self->co->codes);
-    c11_vector__pop(&self->co->codes_ex);
+    c11_vector* codes = &self->co->codes;
+    // drop the `EXTENDED_ARG` prefix along with the instruction
+    do {
+        c11_vector__pop(codes);
+        c11_vector__pop(&self->co->codes_ex);
+    } while(codes->length > 0 && c11_vector__back(Bytecode, codes).op == OP_EXTENDED_ARG);
 }
 
 static int Ctx__emit_int(Ctx* self, int64_t value, int line) {
@@ -1182,6 +1193,16 @@ static int Ctx__emit_int(Ctx* self, int64_t value, int line) {
     }
 }
 
+// LOAD_ATTR, LOAD_METHOD and STORE_ATTR refer to an inline cache which holds the name
+static int Ctx__emit_attr(Ctx* self, Opcode opcode, py_Name name, int line) {
+    int index = CodeObject__add_inline_cache(self->co, name);
+    return Ctx__emit_(self, opcode, index, line);
+}
+
+static int Ctx__emit_name(Ctx* self, Opcode opcode, py_Name name, int line) {
+    return Ctx__emit_(self, opcode, name, line);
+}
+
 static void Ctx__patch_jump(Ctx* self, int index) {
     Bytecode* co_codes = (Bytecode*)self->co->codes.data;
     int target = self->co->codes.length;
@@ -1209,9 +1230,12 @@ static int Ctx__add_const_string(Ctx* self, c11_sv key) {
         py_newstrv(&tmp, key);
         c11_vector__push(py_TValue, &self->co->consts, tmp);
         int index = self->co->consts.length - 1;
-        c11_smallmap_s2n__set(&self->co_consts_string_dedup_map,
-                              c11_string__sv(PyObject__userdata(tmp._obj)),
-                              index);
+        // the map holds 16-bit indices, later strings are not deduplicated
+        if(index <= UINT16_MAX) {
+            c11_smallmap_s2n__set(&self->co_consts_string_dedup_map,
+                                  c11_string__sv(PyObject__userdata(tmp._obj)),
+                                  index);
+        }
         return index;
     }
 }
@@ -1227,7 +1251,7 @@ static void Ctx__emit_store_name(Ctx* self, NameScope scope, py_Name name, int l
         case NAME_LOCAL: Ctx__emit_(self, OP_STORE_FAST, Ctx__add_varname(self, name), line); break;
         case NAME_GLOBAL: {
             Opcode op = self->co->src->is_dynamic ? OP_STORE_NAME : OP_STORE_GLOBAL;
-            Ctx__emit_(self, op, name, line);
+            Ctx__emit_name(self, op, name, line);
         } break;
         default: c11__unreachable();
     }
@@ -1270,6 +1294,346 @@ static Expr* Ctx__s_popx(Ctx* self) {
     return top;
 }
 
+/* peephole optimizer */
+// returns true if `bc` pushes a constant, which is stored in `out`
+static bool Ctx__const_of(Ctx* self, Bytecode bc, py_TValue* out) {
+    switch(bc.op) {
+        case OP_LOAD_CONST: *out = c11__getitem(py_TValue, &self->co->consts, bc.arg); return true;
+        case OP_LOAD_NONE: py_newnone(out); return true;
+        case OP_LOAD_TRUE: py_newbool(out, true); return true;
+        case OP_LOAD_FALSE: py_newbool(out, false); return true;
+        case OP_LOAD_SMALL_INT: py_newint(out, (int16_t)bc.arg); return true;
+        case OP_LOAD_ELLIPSIS: py_newellipsis(out); return true;
+        default: return false;
+    }
+}
+
+// returns false if there are too many constants
+static bool Ctx__load_const(Ctx* self, py_Ref val, Bytecode* out) {
+    switch(val->type) {
+        case tp_bool:
+            *out = (Bytecode){py_tobool(val) ? OP_LOAD_TRUE : OP_LOAD_FALSE, BC_NOARG};
+            break;
+        case tp_int: {
+            py_i64 v = py_toint(val);
+            if(INT16_MIN <= v && v <= INT16_MAX) {
+                *out = (Bytecode){OP_LOAD_SMALL_INT, (uint16_t)v};
+                return true;
+            }
+        }  // fallthrough
+        default: {
+            // the folded instruction has no room for an `EXTENDED_ARG` prefix
+            if(self->co->consts.length > UINT16_MAX) return false;
+            int index = val->type == tp_str ? Ctx__add_const_string(self, py_tosv(val))
+                                            : Ctx__add_const(self, val);
+            *out = (Bytecode){OP_LOAD_CONST, (uint16_t)index};
+        }
+    }
+    return true;
+}
+
+// only folds operations which cannot raise or produce huge objects
+static bool Ctx__fold_binaryop(uint16_t arg, py_Ref lhs, py_Ref rhs, py_OutRef out) {
+    py_Name op = arg & 0xFF;
+    bool is_num = (lhs->type == tp_int || lhs->type == tp_float) &&
+                  (rhs->type == tp_int || rhs->type == tp_float);
+    bool is_int = lhs->type == tp_int && rhs->type == tp_int;
+    if(op == __add__ || op == __sub__ || op == __mul__ || op == __truediv__) {
+        if(!is_num) {
+            if(op == __add__ && lhs->type == tp_str && rhs->type == tp_str) {
+                if(py_tosv(lhs).size + py_tosv(rhs).size > 1024) return false;
+            } else if(op == __mul__ && lhs->type == tp_str && rhs->type == tp_int) {
+                py_i64 n = py_toint(rhs);
+                if(n < 0 || n > 1024 || n * py_tosv(lhs).size > 1024) return false;
+            } else {
+                return false;
+            }
+        }
+    } else if(op == __floordiv__ || op == __mod__) {
+        if(!is_num) return false;
+        if(rhs->type == tp_int ? py_toint(rhs) == 0 : py_tofloat(rhs) == 0.0) return false;
+        if(is_int && py_toint(rhs) == -1) return false;  // INT64_MIN // -1 traps
+    } else if(op == __pow__) {
+        if(!is_int || py_toint(rhs) < 0) return false;
+    } else if(op == __lshift__ || op == __rshift__) {
+        if(!is_int || py_toint(rhs) < 0 || py_toint(rhs) >= 64) return false;
+    } else if(op == __and__ || op == __or__ || op == __xor__) {
+        if(!is_int) return false;
+    } else {
+        return false;
+    }
+    // the result is left in `py_retval()`, which the caller of the compiler may still use
+    py_TValue retval = *py_retval();
+    bool ok = py_binaryop(lhs, rhs, op, arg >> 8);
+    assert(ok);
+    *out = *py_retval();
+    *py_retval() = retval;
+    return ok;
+}
+
+static bool Ctx__fold_unaryop(Opcode opcode, py_Ref val, py_OutRef out) {
+    switch(opcode) {
+        case OP_UNARY_NEGATIVE:
+            if(val->type == tp_int) {
+                py_newint(out, -py_toint(val));
+            } else if(val->type == tp_float) {
+                py_newfloat(out, -py_tofloat(val));
+            } else {
+                return false;
+            }
+            return true;
+        case OP_UNARY_INVERT:
+            if(val->type != tp_int) return false;
+            py_newint(out, ~py_toint(val));
+            return true;
+        case OP_UNARY_NOT:
+            switch(val->type) {
+                case tp_NoneType: py_newbool(out, true); return true;
+                case tp_bool: py_newbool(out, !py_tobool(val)); return true;
+                case tp_int: py_newbool(out, py_toint(val) == 0); return true;
+                case tp_float: py_newbool(out, py_tofloat(val) == 0.0); return true;
+                case tp_str: py_newbool(out, py_tosv(val).size == 0); return true;
+                default: return false;
+            }
+        default: return false;
+    }
+}
+
+static int Bytecode__jump_target(const Bytecode* self, int i) {
+    return Bytecode__is_forward_jump(self) ? i + (int16_t)self->arg : -1;
+}
+
+static bool Bytecode__is_unconditional_jump(const Bytecode* self) {
+    return self->op == OP_JUMP_FORWARD || self->op == OP_LOOP_CONTINUE ||
+           self->op == OP_LOOP_BREAK;
+}
+
+static bool Bytecode__is_terminal(const Bytecode* self) {
+    if(Bytecode__is_unconditional_jump(self)) return true;
+    switch(self->op) {
+        case OP_RETURN_VALUE:
+        case OP_RAISE:
+        case OP_RAISE_ASSERT: return true;
+        default: return false;
+    }
+}
+
+// jumps to an unconditional jump go to its target directly
+static void Ctx__thread_jumps(Ctx* self) {
+    Bytecode* codes = self->co->codes.data;
+    int n = self->co->codes.length;
+    for(int i = 0; i < n; i++) {
+        int target = Bytecode__jump_target(&codes[i], i);
+        if(target < 0) continue;
+        for(int depth = 0; depth < 8 && target < n; depth++) {
+            if(codes[target].op == OP_NO_OP) {
+                target++;
+            } else if(Bytecode__is_unconditional_jump(&codes[target])) {
+                target += (int16_t)codes[target].arg;
+            } else {
+                break;
+            }
+        }
+        int offset = target - i;
+        if((int16_t)offset == offset) codes[i].arg = (int16_t)offset;
+        if(Bytecode__is_unconditional_jump(&codes[i]) && offset == 1) codes[i].op = OP_NO_OP;
+    }
+}
+
+// `is_target` marks instructions which can be entered other than from the previous one
+static void Ctx__mark_jump_targets(Ctx* self, bool* is_target) {
+    Bytecode* codes = self->co->codes.data;
+    int n = self->co->codes.length;
+    memset(is_target, 0, n + 1);
+    for(int i = 0; i < n; i++) {
+        if(codes[i].op == OP_NO_OP) continue;
+        int target = Bytecode__jump_target(&codes[i], i);
+        if(target >= 0 && target <= n) is_target[target] = true;
+    }
+    // exception handlers
+    c11__foreach(CodeBlock, &self->co->blocks, block) {
+        if(block->type == CodeBlockType_TRY && block->end >= 0) is_target[block->end] = true;
+    }
+}
+
+static void Ctx__remove_unreachable(Ctx* self, bool* visited) {
+    Bytecode* codes = self->co->codes.data;
+    int n = self->co->codes.length;
+    c11_vector /*T=int*/ stack;
+    c11_vector__ctor(&stack, sizeof(int));
+    memset(visited, 0, n + 1);
+    c11_vector__push(int, &stack, 0);
+    c11__foreach(CodeBlock, &self->co->blocks, block) {
+        if(block->type == CodeBlockType_TRY && block->end >= 0) {
+            c11_vector__push(int, &stack, block->end);
+        }
+    }
+    while(stack.length > 0) {
+        int i = c11_vector__back(int, &stack);
+        c11_vector__pop(&stack);
+        while(i < n && !visited[i]) {
+            visited[i] = true;
+            int target = Bytecode__jump_target(&codes[i], i);
+            if(target >= 0) c11_vector__push(int, &stack, target);
+            if(Bytecode__is_terminal(&codes[i])) break;
+            i++;
+        }
+    }
+    c11_vector__dtor(&stack);
+    for(int i = 0; i < n; i++) {
+        if(!visited[i]) codes[i].op = OP_NO_OP;
+    }
+}
+
+// returns the index of the previous instruction which is not `NO_OP`, or -1
+static int Ctx__prev_op(Ctx* self, int i, const bool* is_target, bool* is_entered) {
+    Bytecode* codes = self->co->codes.data;
+    *is_entered = *is_entered || is_target[i];
+    while(--i >= 0) {
+        if(codes[i].op != OP_NO_OP) return i;
+        *is_entered = *is_entered || is_target[i];
+    }
+    return -1;
+}
+
+static void Ctx__fold_constants(Ctx* self, const bool* is_target) {
+    Bytecode* codes = self->co->codes.data;
+    int n = self->co->codes.length;
+    py_TValue items[16];
+    for(int i = 0; i < n; i++) {
+        Bytecode bc = codes[i];
+        int argc;
+        switch(bc.op) {
+            case OP_BINARY_OP: argc = 2; break;
+            case OP_UNARY_NEGATIVE:
+            case OP_UNARY_INVERT:
+            case OP_UNARY_NOT:
+            case OP_POP_JUMP_IF_FALSE:
+            case OP_POP_JUMP_IF_TRUE:
+            case OP_POP_TOP: argc = 1; break;
+            case OP_BUILD_TUPLE: argc = bc.arg; break;
+            default: continue;
+        }
+        if(i > 0 && codes[i - 1].op == OP_EXTENDED_ARG) continue;
+        if(argc == 0 || argc > 16) continue;
+        // all operands must be constants pushed by the preceding instructions
+        int j = i;
+        bool is_const = true;
+        bool is_entered = false;
+        for(int k = argc - 1; k >= 0 && is_const; k--) {
+            j = Ctx__prev_op(self, j, is_target, &is_entered);
+            is_const = j >= 0 && Ctx__const_of(self, codes[j], &items[k]);
+        }
+        if(!is_const || is_entered) continue;
+        if(j > 0 && codes[j - 1].op == OP_EXTENDED_ARG) continue;
+
+        py_TValue res;
+        if(bc.op == OP_POP_TOP) {
+            codes[i].op = OP_NO_OP;
+        } else if(bc.op == OP_POP_JUMP_IF_FALSE || bc.op == OP_POP_JUMP_IF_TRUE) {
+            // e.g. `while True:`
+            if(!Ctx__fold_unaryop(OP_UNARY_NOT, &items[0], &res)) continue;
+            bool is_taken = py_tobool(&res) == (bc.op == OP_POP_JUMP_IF_FALSE);
+            codes[i].op = is_taken ? OP_JUMP_FORWARD : OP_NO_OP;
+        } else {
+            bool ok;
+            if(bc.op == OP_BINARY_OP) {
+                ok = Ctx__fold_binaryop(bc.arg, &items[0], &items[1], &res);
+            } else if(bc.op == OP_BUILD_TUPLE) {
+                py_Ref p = py_newtuple(&res, argc);
+                for(int k = 0; k < argc; k++)
+                    p[k] = items[k];
+                ok = true;
+            } else {
+                ok = Ctx__fold_unaryop(bc.op, &items[0], &res);
+            }
+            if(!ok || !Ctx__load_const(self, &res, &codes[i])) continue;
+        }
+        for(int k = j; k < i; k++)
+            codes[k].op = OP_NO_OP;
+    }
+}
+
+// fuses LOAD_FAST with the next LOAD_FAST or LOAD_ATTR into a single instruction
+static void Ctx__fuse_superinstructions(Ctx* self, const bool* is_target) {
+    Bytecode* codes = self->co->codes.data;
+    BytecodeEx* codes_ex = self->co->codes_ex.data;
+    int n = self->co->codes.length;
+    for(int i = 0; i < n; i++) {
+        if(codes[i].op != OP_LOAD_FAST || codes[i].arg > 0xFF) continue;
+        int j = i + 1;
+        while(j < n && codes[j].op == OP_NO_OP && !is_target[j])
+            j++;
+        if(j == n || is_target[j] || codes[j].arg > 0xFF) continue;
+        if(codes_ex[j].lineno != codes_ex[i].lineno || codes_ex[j].iblock != codes_ex[i].iblock) {
+            continue;
+        }
+        Opcode op;
+        if(codes[j].op == OP_LOAD_ATTR) {
+            op = OP_LOAD_FAST_LOAD_ATTR;
+        } else if(codes[j].op == OP_LOAD_FAST) {
+            // prefer `a, b.x` -> LOAD_FAST, LOAD_FAST_LOAD_ATTR
+            if(j + 1 < n && codes[j + 1].op == OP_LOAD_ATTR && !is_target[j + 1]) continue;
+            op = OP_LOAD_FAST_LOAD_FAST;
+        } else {
+            continue;
+        }
+        codes[i] = (Bytecode){(uint8_t)op, (uint16_t)(codes[i].arg << 8 | codes[j].arg)};
+        codes[j].op = OP_NO_OP;
+        i = j;
+    }
+}
+
+// removes `NO_OP`s and relocates jumps and blocks
+static void Ctx__remove_nops(Ctx* self) {
+    CodeObject* co = self->co;
+    Bytecode* codes = co->codes.data;
+    BytecodeEx* codes_ex = co->codes_ex.data;
+    int n = co->codes.length;
+    // new_index[i] is the number of instructions kept before `i`
+    int* new_index = PK_MALLOC(sizeof(int) * (n + 1));
+    int count = 0;
+    for(int i = 0; i < n; i++) {
+        new_index[i] = count;
+        if(codes[i].op != OP_NO_OP) count++;
+    }
+    new_index[n] = count;
+    if(count == n) {
+        PK_FREE(new_index);
+        return;
+    }
+    for(int i = 0; i < n; i++) {
+        if(codes[i].op == OP_NO_OP) continue;
+        int target = Bytecode__jump_target(&codes[i], i);
+        if(target >= 0) {
+            Bytecode__set_signed_arg(&codes[i], new_index[target] - new_index[i]);
+        }
+        codes[new_index[i]] = codes[i];
+        codes_ex[new_index[i]] = codes_ex[i];
+    }
+    co->codes.length = count;
+    co->codes_ex.length = count;
+    c11__foreach(CodeBlock, &co->blocks, block) {
+        if(block->start >= 0) block->start = new_index[block->start];
+        if(block->end >= 0) block->end = new_index[block->end];
+        if(block->end2 >= 0) block->end2 = new_index[block->end2];
+    }
+    PK_FREE(new_index);
+}
+
+static void Ctx__optimize(Ctx* self) {
+    int n = self->co->codes.length;
+    bool* is_target = PK_MALLOC(n + 1);
+    Ctx__mark_jump_targets(self, is_target);
+    Ctx__fold_constants(self, is_target);
+    Ctx__thread_jumps(self);
+    Ctx__remove_unreachable(self, is_target);
+    Ctx__mark_jump_targets(self, is_target);
+    Ctx__fuse_superinstructions(self, is_target);
+    Ctx__remove_nops(self);
+    PK_FREE(is_target);
+}
+
 /* compiler.c */
 typedef struct Compiler Compiler;
 typedef Error* (*PrattCallback)(Compiler* self);
@@ -1288,12 +1652,18 @@ typedef struct Compiler {
     Token* tokens;
     int tokens_length;
 
-    int i;  // current token index
+    int i;         // current token index
+    int optimize;  // optimization level, 0 to disable `Ctx__optimize`
     c11_vector /*T=CodeEmitContext*/ contexts;
 } Compiler;
 
-static void Compiler__ctor(Compiler* self, SourceData_ src, Token* tokens, int tokens_length) {
+static void Compiler__ctor(Compiler* self,
+                           SourceData_ src,
+                           int optimize,
+                           Token* tokens,
+                           int tokens_length) {
     self->src = src;
+    self->optimize = optimize;
     self->tokens = tokens;
     self->tokens_length = tokens_length;
     self->i = 0;
@@ -1481,9 +1851,6 @@ static Error* pop_context(Compiler* self) {
     if(co->nlocals > PK_MAX_CO_VARNAMES) {
         return SyntaxError(self, "maximum number of local variables exceeded");
     }
-    if(co->consts.length > 65530) {
-        return SyntaxError(self, "maximum number of constants exceeded");
-    }
     // pre-compute block.end or block.end2
     for(int i = 0; i < codes->length; i++) {
         Bytecode* bc = c11__at(Bytecode, codes, i);
@@ -1498,8 +1865,22 @@ static Error* pop_context(Compiler* self) {
             Bytecode__set_signed_arg(bc, block->end - i);
         }
     }
-    // pre-compute func->is_simple
     FuncDecl* func = ctx()->func;
+    if(func && codes->length >= 2) {
+        Bytecode* bc = codes->data;
+        if(bc[0].op == OP_LOAD_CONST && bc[1].op == OP_POP_TOP) {
+            // handle optional docstring
+            py_TValue* c = c11__at(py_TValue, &co->consts, bc[0].arg);
+            if(py_isstr(c)) {
+                func->docstring = py_tostr(c);
+                bc[0].op = OP_NO_OP;
+                bc[1].op = OP_NO_OP;
+            }
+        }
+    }
+    if(self->optimize > 0) Ctx__optimize(ctx());
+    CodeObject__pack_linetable(co);
+    // pre-compute func->is_simple
     if(func) {
         // check generator
         Bytecode* codes = func->code.codes.data;
@@ -2278,21 +2659,6 @@ static Error* compile_function(Compiler* self, int decorators) {
     check(compile_block_body(self, compile_stmt));
     check(pop_context(self));
 
-    if(decl->code.codes.length >= 2) {
-        Bytecode* codes = (Bytecode*)decl->code.codes.data;
-
-        if(codes[0].op == OP_LOAD_CONST && codes[1].op == OP_POP_TOP) {
-            // handle optional docstring
-            py_TValue* consts = decl->code.consts.data;
-            py_TValue* c = &consts[codes[0].arg];
-            if(py_isstr(c)) {
-                decl->docstring = py_tostr(c);
-                codes[0].op = OP_NO_OP;
-                codes[1].op = OP_NO_OP;
-            }
-        }
-    }
-
     Ctx__emit_(ctx(), OP_LOAD_FUNCTION, decl_index, prev()->line);
     Ctx__s_emit_decorators(ctx(), decorators);
 
@@ -2306,7 +2672,7 @@ static Error* compile_function(Compiler* self, int decorators) {
             }
         }
 
-        Ctx__emit_(ctx(), OP_STORE_CLASS_ATTR, decl_name, prev()->line);
+        Ctx__emit_name(ctx(), OP_STORE_CLASS_ATTR, decl_name, prev()->line);
     } else {
         NameExpr* e = NameExpr__new(prev()->line, decl_name, name_scope(self));
         vtemit_store((Expr*)e, ctx());
@@ -2334,7 +2700,7 @@ static Error* compile_class(Compiler* self, int decorators) {
     } else {
         Ctx__s_emit_top(ctx());  // []
     }
-    Ctx__emit_(ctx(), OP_BEGIN_CLASS, name, BC_KEEPLINE);
+    Ctx__emit_name(ctx(), OP_BEGIN_CLASS, name, BC_KEEPLINE);
 
     c11__foreach(Ctx, &self->contexts, it) {
         if(it->is_compiling_class) return SyntaxError(self, "nested class is not allowed");
@@ -2344,7 +2710,7 @@ static Error* compile_class(Compiler* self, int decorators) {
     ctx()->is_compiling_class = false;
 
     Ctx__s_emit_decorators(ctx(), decorators);
-    Ctx__emit_(ctx(), OP_END_CLASS, name, BC_KEEPLINE);
+    Ctx__emit_name(ctx(), OP_END_CLASS, name, BC_KEEPLINE);
     return NULL;
 }
 
@@ -2452,7 +2818,7 @@ __EAT_DOTS_END:
         Ctx__emit_(ctx(), OP_DUP_TOP, BC_NOARG, BC_KEEPLINE);
         consume(TK_ID);
         c11_sv name = Token__sv(prev());
-        Ctx__emit_(ctx(), OP_LOAD_ATTR, py_namev(name), prev()->line);
+        Ctx__emit_attr(ctx(), OP_LOAD_ATTR, py_namev(name), prev()->line);
         if(match(TK_AS)) {
             consume(TK_ID);
             name = Token__sv(prev());
@@ -2473,8 +2839,8 @@ static Error* compile_try_except(Compiler* self) {
     int patches[8];
     int patches_length = 0;
 
-    Ctx__enter_block(ctx(), CodeBlockType_TRY);
-    Ctx__emit_(ctx(), OP_TRY_ENTER, BC_NOARG, prev()->line);
+    int iblock = Ctx__enter_block(ctx(), CodeBlockType_TRY);
+    Ctx__emit_(ctx(), OP_TRY_ENTER, iblock, prev()->line);
     check(compile_block_body(self, compile_stmt));
 
     // https://docs.python.org/3/reference/compound_stmts.html#finally-clause
@@ -2711,7 +3077,7 @@ static Error* compile_stmt(Compiler* self) {
                         NameExpr* ne = (NameExpr*)Ctx__s_top(ctx());
                         int index = Ctx__add_const_string(ctx(), type_hint);
                         Ctx__emit_(ctx(), OP_LOAD_CONST, index, BC_KEEPLINE);
-                        Ctx__emit_(ctx(), OP_ADD_CLASS_ANNOTATION, ne->name, BC_KEEPLINE);
+                        Ctx__emit_name(ctx(), OP_ADD_CLASS_ANNOTATION, ne->name, BC_KEEPLINE);
                     }
                 }
             }
@@ -2770,7 +3136,7 @@ Error* Compiler__compile(Compiler* self, CodeObject* out) {
     return NULL;
 }
 
-Error* pk_compile(SourceData_ src, CodeObject* out) {
+Error* pk_compile(SourceData_ src, int optimize, CodeObject* out) {
     Token* tokens;
     int tokens_length;
     Error* err = Lexer__process(src, &tokens, &tokens_length);
@@ -2797,7 +3163,7 @@ Error* pk_compile(SourceData_ src, CodeObject* out) {
 #endif
 
     Compiler compiler;
-    Compiler__ctor(&compiler, src, tokens, tokens_length);
+    Compiler__ctor(&compiler, src, optimize, tokens, tokens_length);
     CodeObject__ctor(out, src, c11_string__sv(src->filename));
     err = Compiler__compile(&compiler, out);
     if(err) {
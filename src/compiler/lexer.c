@@ -25,7 +25,7 @@ static Error* lex_one_token(Lexer* self, bool* eof, bool is_fstring);
 static void Lexer__ctor(Lexer* self, SourceData_ src) {
     PK_INCREF(src);
     self->src = src;
-    self->curr_char = self->token_start = src->source->data;
+    self->curr_char = self->token_start = c11_string__sv(src->source).data;
     self->current_line = 1;
     self->brackets_level = 0;
     c11_vector__ctor(&self->nexts, sizeof(Token));
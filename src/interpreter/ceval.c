@@ -13,20 +13,47 @@ static bool stack_format_object(VM* self, c11_sv spec);
 #define CHECK_RETURN_FROM_EXCEPT_OR_FINALLY()                                                      \
     if(self->is_curr_exc_handled) py_clearexc(NULL)
 
+#define FETCH_BYTE()                                                                               \
+    do {                                                                                           \
+        Bytecode __bc = codes[frame->ip];                                                          \
+        byte.op = __bc.op;                                                                         \
+        byte.arg = __bc.arg;                                                                       \
+    } while(0)
+
+#if PK_ENABLE_COMPUTED_GOTO
+// each handler jumps straight to the next one through `dispatch`
+#define CASE(op)                                                                                   \
+    case OP_##op:                                                                                  \
+    __OP_##op
+#define DISPATCH_NEXT()                                                                            \
+    do {                                                                                           \
+        FETCH_BYTE();                                                                              \
+        goto* dispatch[byte.op];                                                                   \
+    } while(0)
+// tracing routes every opcode through `__TRACE_STEP`, the choice is refreshed on frame
+// switches and after native calls, where a trace function is usually installed
+#define SELECT_DISPATCH_TABLE()                                                                    \
+    dispatch = self->trace_info.func ? trace_dispatch_table : dispatch_table
+#else
+#define CASE(op) case OP_##op
+#define DISPATCH_NEXT() goto __NEXT_STEP
+#define SELECT_DISPATCH_TABLE() (void)0
+#endif
+
 #define DISPATCH()                                                                                 \
     do {                                                                                           \
         frame->ip++;                                                                               \
-        goto __NEXT_STEP;                                                                          \
+        DISPATCH_NEXT();                                                                           \
     } while(0)
 #define DISPATCH_JUMP(__offset)                                                                    \
     do {                                                                                           \
         frame->ip += __offset;                                                                     \
-        goto __NEXT_STEP;                                                                          \
+        DISPATCH_NEXT();                                                                           \
     } while(0)
 #define DISPATCH_JUMP_ABSOLUTE(__target)                                                           \
     do {                                                                                           \
         frame->ip = __target;                                                                      \
-        goto __NEXT_STEP;                                                                          \
+        DISPATCH_NEXT();                                                                           \
     } while(0)
 
 /* Stack manipulation macros */
@@ -58,7 +85,10 @@ static bool stack_format_object(VM* self, c11_sv spec);
     do {                                                                                           \
         FrameResult res = VM__vectorcall(self, (argc), (kwargc), true);                            \
         switch(res) {                                                                              \
-            case RES_RETURN: PUSH(&self->last_retval); break;                                      \
+            case RES_RETURN:                                                                       \
+                PUSH(&self->last_retval);                                                          \
+                SELECT_DISPATCH_TABLE();                                                           \
+                break;                                                                             \
             case RES_CALL: frame = self->top_frame; goto __NEXT_FRAME;                             \
             case RES_ERROR: goto __ERROR;                                                          \
             default: c11__unreachable();                                                           \
@@ -77,14 +107,55 @@ static bool unpack_dict_to_buffer(py_Ref key, py_Ref val, void* ctx) {
     return TypeError("keywords must be strings, not '%t'", key->type);
 }
 
+// accepts (float, float), (float, int) and (int, float)
+static bool pk__float_operands(py_Ref a, py_Ref b, py_f64* lhs, py_f64* rhs) {
+    if(a->type == tp_float) {
+        *lhs = a->_f64;
+        if(b->type == tp_float) {
+            *rhs = b->_f64;
+        } else if(b->type == tp_int) {
+            *rhs = (py_f64)b->_i64;
+        } else {
+            return false;
+        }
+        return true;
+    }
+    if(a->type == tp_int && b->type == tp_float) {
+        *lhs = (py_f64)a->_i64;
+        *rhs = b->_f64;
+        return true;
+    }
+    return false;
+}
+
 FrameResult VM__run_top_frame(VM* self) {
     py_Frame* frame = self->top_frame;
     Bytecode* codes;
 
     const py_Frame* base_frame = frame;
 
+#if PK_ENABLE_COMPUTED_GOTO
+    static const void* const dispatch_table[] = {
+#define OPCODE(name) &&__OP_##name,
+#include "pocketpy/xmacros/opcodes.h"
+#undef OPCODE
+    };
+    static const void* const trace_dispatch_table[] = {
+#define OPCODE(name) &&__TRACE_STEP,
+#include "pocketpy/xmacros/opcodes.h"
+#undef OPCODE
+    };
+    const void* const* dispatch = dispatch_table;
+#endif
+
     while(true) {
-        Bytecode byte;
+        // the current instruction, `arg` includes the bits of an `EXTENDED_ARG` prefix
+        // arguments stay below 2^31, so `arg` is signed like the counts it is compared with
+        struct {
+            uint8_t op;
+            int arg;
+        } byte;
+
     __NEXT_FRAME:
         if(self->recursion_depth >= self->max_recursion_depth) {
             py_exception(tp_RecursionError, "maximum recursion depth exceeded");
@@ -92,9 +163,19 @@ FrameResult VM__run_top_frame(VM* self) {
         }
         codes = frame->co->codes.data;
         frame->ip++;
+        SELECT_DISPATCH_TABLE();
 
     __NEXT_STEP:
-        byte = codes[frame->ip];
+        FETCH_BYTE();
+#if PK_ENABLE_COMPUTED_GOTO
+        goto* dispatch[byte.op];
+
+    __TRACE_STEP:
+        if(self->trace_info.func == NULL) {
+            dispatch = dispatch_table;
+            goto* dispatch[byte.op];
+        }
+#endif
 
         if(self->trace_info.func) {
             SourceLocation loc = Frame__source_location(frame);
@@ -108,26 +189,34 @@ FrameResult VM__run_top_frame(VM* self) {
         }
 
 #ifndef NDEBUG
-        pk_print_stack(self, frame, byte);
+        pk_print_stack(self, frame, codes[frame->ip]);
 #endif
 
+    __DISPATCH_BYTE:
         switch((Opcode)byte.op) {
-            case OP_NO_OP: DISPATCH();
+            CASE(NO_OP): DISPATCH();
+            CASE(EXTENDED_ARG): {
+                int hi = byte.arg << 16;
+                frame->ip++;
+                FETCH_BYTE();
+                byte.arg |= hi;
+                goto __DISPATCH_BYTE;
+            }
             /*****************************************/
-            case OP_POP_TOP: POP(); DISPATCH();
-            case OP_DUP_TOP: PUSH(TOP()); DISPATCH();
-            case OP_DUP_TOP_TWO:
+            CASE(POP_TOP): POP(); DISPATCH();
+            CASE(DUP_TOP): PUSH(TOP()); DISPATCH();
+            CASE(DUP_TOP_TWO):
                 // [a, b]
                 PUSH(SECOND());  // [a, b, a]
                 PUSH(SECOND());  // [a, b, a, b]
                 DISPATCH();
-            case OP_ROT_TWO: {
+            CASE(ROT_TWO): {
                 py_TValue tmp = *TOP();
                 *TOP() = *SECOND();
                 *SECOND() = tmp;
                 DISPATCH();
             }
-            case OP_ROT_THREE: {
+            CASE(ROT_THREE): {
                 // [a, b, c] -> [c, a, b]
                 py_TValue tmp = *TOP();
                 *TOP() = *SECOND();
@@ -135,7 +224,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 *THIRD() = tmp;
                 DISPATCH();
             }
-            case OP_PRINT_EXPR:
+            CASE(PRINT_EXPR):
                 if(TOP()->type != tp_NoneType) {
                     bool ok = py_repr(TOP());
                     if(!ok) goto __ERROR;
@@ -145,33 +234,33 @@ FrameResult VM__run_top_frame(VM* self) {
                 POP();
                 DISPATCH();
             /*****************************************/
-            case OP_LOAD_CONST: {
+            CASE(LOAD_CONST): {
                 PUSH(c11__at(py_TValue, &frame->co->consts, byte.arg));
                 DISPATCH();
             }
-            case OP_LOAD_NONE: {
+            CASE(LOAD_NONE): {
                 py_newnone(SP()++);
                 DISPATCH();
             }
-            case OP_LOAD_TRUE: {
+            CASE(LOAD_TRUE): {
                 py_newbool(SP()++, true);
                 DISPATCH();
             }
-            case OP_LOAD_FALSE: {
+            CASE(LOAD_FALSE): {
                 py_newbool(SP()++, false);
                 DISPATCH();
             }
             /*****************************************/
-            case OP_LOAD_SMALL_INT: {
+            CASE(LOAD_SMALL_INT): {
                 py_newint(SP()++, (int16_t)byte.arg);
                 DISPATCH();
             }
             /*****************************************/
-            case OP_LOAD_ELLIPSIS: {
+            CASE(LOAD_ELLIPSIS): {
                 py_newellipsis(SP()++);
                 DISPATCH();
             }
-            case OP_LOAD_FUNCTION: {
+            CASE(LOAD_FUNCTION): {
                 FuncDecl_ decl = c11__getitem(FuncDecl_, &frame->co->func_decls, byte.arg);
                 Function* ud = py_newobject(SP(), tp_function, 0, sizeof(Function));
                 Function__ctor(ud, decl, frame->module, frame->globals);
@@ -188,22 +277,50 @@ FrameResult VM__run_top_frame(VM* self) {
                 SP()++;
                 DISPATCH();
             }
-            case OP_LOAD_NULL:
+            CASE(LOAD_NULL):
                 py_newnil(SP()++);
                 DISPATCH();
                 /*****************************************/
-            case OP_LOAD_FAST: {
+            CASE(LOAD_FAST): {
                 assert(!frame->is_locals_special);
                 py_Ref val = &frame->locals[byte.arg];
                 if(!py_isnil(val)) {
                     PUSH(val);
                     DISPATCH();
                 }
-                py_Name name = c11__getitem(uint16_t, &frame->co->varnames, byte.arg);
+                py_Name name = c11__getitem(py_Name, &frame->co->varnames, byte.arg);
                 UnboundLocalError(name);
                 goto __ERROR;
             }
-            case OP_LOAD_NAME: {
+            CASE(LOAD_FAST_LOAD_FAST): {
+                assert(!frame->is_locals_special);
+                int index[2] = {byte.arg >> 8, byte.arg & 0xFF};
+                for(int i = 0; i < 2; i++) {
+                    py_Ref val = &frame->locals[index[i]];
+                    if(py_isnil(val)) {
+                        UnboundLocalError(c11__getitem(py_Name, &frame->co->varnames, index[i]));
+                        goto __ERROR;
+                    }
+                    PUSH(val);
+                }
+                DISPATCH();
+            }
+            CASE(LOAD_FAST_LOAD_ATTR): {
+                assert(!frame->is_locals_special);
+                int index = byte.arg >> 8;
+                py_Ref val = &frame->locals[index];
+                if(py_isnil(val)) {
+                    UnboundLocalError(c11__getitem(py_Name, &frame->co->varnames, index));
+                    goto __ERROR;
+                }
+                PUSH(val);
+                index = byte.arg & 0xFF;
+                InlineCache* cache = c11__at(InlineCache, &frame->co->inline_caches, index);
+                if(!pk_getattr_cached(TOP(), cache)) goto __ERROR;
+                py_assign(TOP(), py_retval());
+                DISPATCH();
+            }
+            CASE(LOAD_NAME): {
                 assert(frame->is_locals_special);
                 py_Name name = byte.arg;
                 // locals
@@ -248,7 +365,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 NameError(name);
                 goto __ERROR;
             }
-            case OP_LOAD_NONLOCAL: {
+            CASE(LOAD_NONLOCAL): {
                 py_Name name = byte.arg;
                 py_Ref tmp = Frame__getclosure(frame, name);
                 if(tmp != NULL) {
@@ -270,7 +387,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 NameError(name);
                 goto __ERROR;
             }
-            case OP_LOAD_GLOBAL: {
+            CASE(LOAD_GLOBAL): {
                 py_Name name = byte.arg;
                 int res = Frame__getglobal(frame, name);
                 if(res == 1) {
@@ -286,15 +403,16 @@ FrameResult VM__run_top_frame(VM* self) {
                 NameError(name);
                 goto __ERROR;
             }
-            case OP_LOAD_ATTR: {
-                if(py_getattr(TOP(), byte.arg)) {
+            CASE(LOAD_ATTR): {
+                InlineCache* cache = c11__at(InlineCache, &frame->co->inline_caches, byte.arg);
+                if(pk_getattr_cached(TOP(), cache)) {
                     py_assign(TOP(), py_retval());
                 } else {
                     goto __ERROR;
                 }
                 DISPATCH();
             }
-            case OP_LOAD_CLASS_GLOBAL: {
+            CASE(LOAD_CLASS_GLOBAL): {
                 assert(self->curr_class);
                 py_Name name = byte.arg;
                 py_Ref tmp = py_getdict(self->curr_class, name);
@@ -317,12 +435,15 @@ FrameResult VM__run_top_frame(VM* self) {
                 NameError(name);
                 goto __ERROR;
             }
-            case OP_LOAD_METHOD: {
+            CASE(LOAD_METHOD): {
                 // [self] -> [unbound, self]
-                bool ok = py_pushmethod(byte.arg);
-                if(!ok) {
+                InlineCache* cache = c11__at(InlineCache, &frame->co->inline_caches, byte.arg);
+                bool ok = pk_loadmethod_cached(TOP(), cache);
+                if(ok) {
+                    STACK_GROW(1);
+                } else {
                     // fallback to getattr
-                    if(py_getattr(TOP(), byte.arg)) {
+                    if(pk_getattr_cached(TOP(), cache)) {
                         py_assign(TOP(), py_retval());
                         py_newnil(SP()++);
                     } else {
@@ -331,7 +452,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
                 DISPATCH();
             }
-            case OP_LOAD_SUBSCR: {
+            CASE(LOAD_SUBSCR): {
                 // [a, b] -> a[b]
                 py_Ref magic = py_tpfindmagic(SECOND()->type, __getitem__);
                 if(magic) {
@@ -349,12 +470,12 @@ FrameResult VM__run_top_frame(VM* self) {
                 TypeError("'%t' object is not subscriptable", SECOND()->type);
                 goto __ERROR;
             }
-            case OP_STORE_FAST: {
+            CASE(STORE_FAST): {
                 assert(!frame->is_locals_special);
                 frame->locals[byte.arg] = POPX();
                 DISPATCH();
             }
-            case OP_STORE_NAME: {
+            CASE(STORE_NAME): {
                 assert(frame->is_locals_special);
                 py_Name name = byte.arg;
                 switch(frame->locals->type) {
@@ -382,18 +503,19 @@ FrameResult VM__run_top_frame(VM* self) {
                     default: c11__unreachable();
                 }
             }
-            case OP_STORE_GLOBAL: {
+            CASE(STORE_GLOBAL): {
                 if(!Frame__setglobal(frame, byte.arg, TOP())) goto __ERROR;
                 POP();
                 DISPATCH();
             }
-            case OP_STORE_ATTR: {
+            CASE(STORE_ATTR): {
                 // [val, a] -> a.b = val
-                if(!py_setattr(TOP(), byte.arg, SECOND())) goto __ERROR;
+                InlineCache* cache = c11__at(InlineCache, &frame->co->inline_caches, byte.arg);
+                if(!pk_setattr_cached(TOP(), cache, SECOND())) goto __ERROR;
                 STACK_SHRINK(2);
                 DISPATCH();
             }
-            case OP_STORE_SUBSCR: {
+            CASE(STORE_SUBSCR): {
                 // [val, a, b] -> a[b] = val
                 py_Ref magic = py_tpfindmagic(SECOND()->type, __setitem__);
                 if(magic) {
@@ -410,7 +532,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 TypeError("'%t' object does not support item assignment", SECOND()->type);
                 goto __ERROR;
             }
-            case OP_DELETE_FAST: {
+            CASE(DELETE_FAST): {
                 assert(!frame->is_locals_special);
                 py_Ref tmp = &frame->locals[byte.arg];
                 if(py_isnil(tmp)) {
@@ -421,7 +543,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 py_newnil(tmp);
                 DISPATCH();
             }
-            case OP_DELETE_NAME: {
+            CASE(DELETE_NAME): {
                 assert(frame->is_locals_special);
                 py_Name name = byte.arg;
                 switch(frame->locals->type) {
@@ -451,7 +573,7 @@ FrameResult VM__run_top_frame(VM* self) {
                     default: c11__unreachable();
                 }
             }
-            case OP_DELETE_GLOBAL: {
+            CASE(DELETE_GLOBAL): {
                 py_Name name = byte.arg;
                 int res = Frame__delglobal(frame, name);
                 if(res == 1) DISPATCH();
@@ -460,12 +582,12 @@ FrameResult VM__run_top_frame(VM* self) {
                 goto __ERROR;
             }
 
-            case OP_DELETE_ATTR: {
+            CASE(DELETE_ATTR): {
                 if(!py_delattr(TOP(), byte.arg)) goto __ERROR;
                 DISPATCH();
             }
 
-            case OP_DELETE_SUBSCR: {
+            CASE(DELETE_SUBSCR): {
                 // [a, b] -> del a[b]
                 py_Ref magic = py_tpfindmagic(SECOND()->type, __delitem__);
                 if(magic) {
@@ -483,7 +605,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 goto __ERROR;
             }
             /*****************************************/
-            case OP_BUILD_IMAG: {
+            CASE(BUILD_IMAG): {
                 // [x]
                 py_Ref f = py_getdict(&self->builtins, py_name("complex"));
                 assert(f != NULL);
@@ -495,7 +617,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 vectorcall_opcall(2, 0);
                 DISPATCH();
             }
-            case OP_BUILD_BYTES: {
+            CASE(BUILD_BYTES): {
                 int size;
                 py_Ref string = c11__at(py_TValue, &frame->co->consts, byte.arg);
                 const char* data = py_tostrn(string, &size);
@@ -503,7 +625,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 memcpy(p, data, size);
                 DISPATCH();
             }
-            case OP_BUILD_TUPLE: {
+            CASE(BUILD_TUPLE): {
                 py_TValue tmp;
                 py_Ref p = py_newtuple(&tmp, byte.arg);
                 py_TValue* begin = SP() - byte.arg;
@@ -513,7 +635,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 PUSH(&tmp);
                 DISPATCH();
             }
-            case OP_BUILD_LIST: {
+            CASE(BUILD_LIST): {
                 py_TValue tmp;
                 py_newlistn(&tmp, byte.arg);
                 py_TValue* begin = SP() - byte.arg;
@@ -524,7 +646,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 PUSH(&tmp);
                 DISPATCH();
             }
-            case OP_BUILD_DICT: {
+            CASE(BUILD_DICT): {
                 py_TValue* begin = SP() - byte.arg * 2;
                 py_Ref tmp = py_pushtmp();
                 py_newdict(tmp);
@@ -536,7 +658,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 PUSH(tmp);
                 DISPATCH();
             }
-            case OP_BUILD_SET: {
+            CASE(BUILD_SET): {
                 py_TValue* begin = SP() - byte.arg;
                 py_Ref typeobject_set = py_getdict(&self->builtins, py_name("set"));
                 assert(typeobject_set != NULL);
@@ -558,7 +680,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 PUSH(&tmp);
                 DISPATCH();
             }
-            case OP_BUILD_SLICE: {
+            CASE(BUILD_SLICE): {
                 // [start, stop, step]
                 py_TValue tmp;
                 py_newslice(&tmp);
@@ -569,7 +691,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 PUSH(&tmp);
                 DISPATCH();
             }
-            case OP_BUILD_STRING: {
+            CASE(BUILD_STRING): {
                 py_TValue* begin = SP() - byte.arg;
                 c11_sbuf ss;
                 c11_sbuf__ctor(&ss);
@@ -582,7 +704,13 @@ FrameResult VM__run_top_frame(VM* self) {
                 DISPATCH();
             }
             /*****************************/
-            case OP_BINARY_OP: {
+            CASE(BINARY_OP): {
+                // quickening: rewrite this site into a typed variant and re-dispatch
+                Opcode spec = pk_specialize_binaryop(byte.arg, SECOND(), TOP());
+                if(spec != OP_BINARY_OP) {
+                    codes[frame->ip].op = spec;
+                    goto __NEXT_STEP;
+                }
                 py_Name op = byte.arg & 0xFF;
                 py_Name rop = byte.arg >> 8;
                 if(!pk_stack_binaryop(self, op, rop)) goto __ERROR;
@@ -590,14 +718,98 @@ FrameResult VM__run_top_frame(VM* self) {
                 *TOP() = self->last_retval;
                 DISPATCH();
             }
-            case OP_IS_OP: {
+#define CASE_BINARY_INT(opname, expr)                                                              \
+    CASE(BINARY_##opname##_INT): {                                                                 \
+        if(SECOND()->type != tp_int || TOP()->type != tp_int) goto __DEOPT_BINARY_OP;              \
+        py_i64 lhs = SECOND()->_i64;                                                               \
+        py_i64 rhs = TOP()->_i64;                                                                  \
+        POP();                                                                                     \
+        py_newint(TOP(), expr);                                                                    \
+        DISPATCH();                                                                                \
+    }
+#define CASE_BINARY_FLOAT(opname, expr)                                                            \
+    CASE(BINARY_##opname##_FLOAT): {                                                               \
+        py_f64 lhs, rhs;                                                                           \
+        if(!pk__float_operands(SECOND(), TOP(), &lhs, &rhs)) goto __DEOPT_BINARY_OP;               \
+        POP();                                                                                     \
+        py_newfloat(TOP(), expr);                                                                  \
+        DISPATCH();                                                                                \
+    }
+// comparisons feeding POP_JUMP_IF_FALSE jump directly without creating a bool
+#define COMPARE_AND_DISPATCH(res)                                                                  \
+    do {                                                                                           \
+        Bytecode next = codes[frame->ip + 1];                                                      \
+        if(next.op == OP_POP_JUMP_IF_FALSE) {                                                      \
+            STACK_SHRINK(2);                                                                       \
+            if(!res) DISPATCH_JUMP(1 + (int16_t)next.arg);                                         \
+            DISPATCH_JUMP(2);                                                                      \
+        }                                                                                          \
+        POP();                                                                                     \
+        py_newbool(TOP(), res);                                                                    \
+        DISPATCH();                                                                                \
+    } while(0)
+#define CASE_COMPARE_INT(opname, op)                                                               \
+    CASE(BINARY_##opname##_INT): {                                                                 \
+        if(SECOND()->type != tp_int || TOP()->type != tp_int) goto __DEOPT_BINARY_OP;              \
+        bool res = SECOND()->_i64 op TOP()->_i64;                                                  \
+        COMPARE_AND_DISPATCH(res);                                                                 \
+    }
+#define CASE_COMPARE_FLOAT(opname, op)                                                             \
+    CASE(BINARY_##opname##_FLOAT): {                                                               \
+        py_f64 lhs, rhs;                                                                           \
+        if(!pk__float_operands(SECOND(), TOP(), &lhs, &rhs)) goto __DEOPT_BINARY_OP;               \
+        bool res = lhs op rhs;                                                                     \
+        COMPARE_AND_DISPATCH(res);                                                                 \
+    }
+
+            CASE_BINARY_INT(ADD, lhs + rhs)
+            CASE_BINARY_INT(SUB, lhs - rhs)
+            CASE_BINARY_INT(MUL, lhs * rhs)
+            CASE(BINARY_FLOORDIV_INT):
+            CASE(BINARY_MOD_INT): {
+                // C and Python semantics agree only for non-negative operands
+                if(SECOND()->type != tp_int || TOP()->type != tp_int) goto __DEOPT_BINARY_OP;
+                py_i64 lhs = SECOND()->_i64;
+                py_i64 rhs = TOP()->_i64;
+                if(lhs < 0 || rhs <= 0) goto __DEOPT_BINARY_OP;
+                POP();
+                py_newint(TOP(), byte.op == OP_BINARY_MOD_INT ? lhs % rhs : lhs / rhs);
+                DISPATCH();
+            }
+            CASE_COMPARE_INT(LT, <)
+            CASE_COMPARE_INT(LE, <=)
+            CASE_COMPARE_INT(GT, >)
+            CASE_COMPARE_INT(GE, >=)
+            CASE_COMPARE_INT(EQ, ==)
+            CASE_COMPARE_INT(NE, !=)
+            CASE_BINARY_FLOAT(ADD, lhs + rhs)
+            CASE_BINARY_FLOAT(SUB, lhs - rhs)
+            CASE_BINARY_FLOAT(MUL, lhs * rhs)
+            CASE_BINARY_FLOAT(TRUEDIV, lhs / rhs)
+            CASE_COMPARE_FLOAT(LT, <)
+            CASE_COMPARE_FLOAT(LE, <=)
+            CASE_COMPARE_FLOAT(GT, >)
+            CASE_COMPARE_FLOAT(GE, >=)
+            __DEOPT_BINARY_OP: {
+                // guard failed, fallback to the generic opcode
+                codes[frame->ip].op = OP_BINARY_OP;
+                goto __NEXT_STEP;
+            }
+
+#undef CASE_BINARY_INT
+#undef CASE_BINARY_FLOAT
+#undef COMPARE_AND_DISPATCH
+#undef CASE_COMPARE_INT
+#undef CASE_COMPARE_FLOAT
+
+            CASE(IS_OP): {
                 bool res = py_isidentical(SECOND(), TOP());
                 POP();
                 if(byte.arg) res = !res;
                 py_newbool(TOP(), res);
                 DISPATCH();
             }
-            case OP_CONTAINS_OP: {
+            CASE(CONTAINS_OP): {
                 // [b, a] -> b __contains__ a (a in b) -> [retval]
                 py_Ref magic = py_tpfindmagic(SECOND()->type, __contains__);
                 if(magic) {
@@ -618,22 +830,22 @@ FrameResult VM__run_top_frame(VM* self) {
                 goto __ERROR;
             }
                 /*****************************************/
-            case OP_JUMP_FORWARD: DISPATCH_JUMP((int16_t)byte.arg);
-            case OP_POP_JUMP_IF_FALSE: {
+            CASE(JUMP_FORWARD): DISPATCH_JUMP((int16_t)byte.arg);
+            CASE(POP_JUMP_IF_FALSE): {
                 int res = py_bool(TOP());
                 if(res < 0) goto __ERROR;
                 POP();
                 if(!res) DISPATCH_JUMP((int16_t)byte.arg);
                 DISPATCH();
             }
-            case OP_POP_JUMP_IF_TRUE: {
+            CASE(POP_JUMP_IF_TRUE): {
                 int res = py_bool(TOP());
                 if(res < 0) goto __ERROR;
                 POP();
                 if(res) DISPATCH_JUMP((int16_t)byte.arg);
                 DISPATCH();
             }
-            case OP_JUMP_IF_TRUE_OR_POP: {
+            CASE(JUMP_IF_TRUE_OR_POP): {
                 int res = py_bool(TOP());
                 if(res < 0) goto __ERROR;
                 if(res) {
@@ -643,7 +855,7 @@ FrameResult VM__run_top_frame(VM* self) {
                     DISPATCH();
                 }
             }
-            case OP_JUMP_IF_FALSE_OR_POP: {
+            CASE(JUMP_IF_FALSE_OR_POP): {
                 int res = py_bool(TOP());
                 if(res < 0) goto __ERROR;
                 if(!res) {
@@ -653,7 +865,7 @@ FrameResult VM__run_top_frame(VM* self) {
                     DISPATCH();
                 }
             }
-            case OP_SHORTCUT_IF_FALSE_OR_POP: {
+            CASE(SHORTCUT_IF_FALSE_OR_POP): {
                 int res = py_bool(TOP());
                 if(res < 0) goto __ERROR;
                 if(!res) {                      // [b, False]
@@ -665,19 +877,19 @@ FrameResult VM__run_top_frame(VM* self) {
                     DISPATCH();
                 }
             }
-            case OP_LOOP_CONTINUE: {
+            CASE(LOOP_CONTINUE): {
                 DISPATCH_JUMP((int16_t)byte.arg);
             }
-            case OP_LOOP_BREAK: {
+            CASE(LOOP_BREAK): {
                 DISPATCH_JUMP((int16_t)byte.arg);
             }
             /*****************************************/
-            case OP_CALL: {
+            CASE(CALL): {
                 ManagedHeap__collect_if_needed(&self->heap);
                 vectorcall_opcall(byte.arg & 0xFF, byte.arg >> 8);
                 DISPATCH();
             }
-            case OP_CALL_VARGS: {
+            CASE(CALL_VARGS): {
                 // [_0, _1, _2 | k1, v1, k2, v2]
                 uint16_t argc = byte.arg & 0xFF;
                 uint16_t kwargc = byte.arg >> 8;
@@ -732,7 +944,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 vectorcall_opcall(argc, kwargc);
                 DISPATCH();
             }
-            case OP_RETURN_VALUE: {
+            CASE(RETURN_VALUE): {
                 CHECK_RETURN_FROM_EXCEPT_OR_FINALLY();
                 if(byte.arg == BC_NOARG) {
                     self->last_retval = POPX();
@@ -749,7 +961,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
                 DISPATCH();
             }
-            case OP_YIELD_VALUE: {
+            CASE(YIELD_VALUE): {
                 CHECK_RETURN_FROM_EXCEPT_OR_FINALLY();
                 if(byte.arg == 1) {
                     py_newnone(py_retval());
@@ -759,7 +971,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
                 return RES_YIELD;
             }
-            case OP_FOR_ITER_YIELD_VALUE: {
+            CASE(FOR_ITER_YIELD_VALUE): {
                 CHECK_RETURN_FROM_EXCEPT_OR_FINALLY();
                 int res = py_next(TOP());
                 if(res == -1) goto __ERROR;
@@ -774,20 +986,20 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
             }
             /////////
-            case OP_LIST_APPEND: {
+            CASE(LIST_APPEND): {
                 // [list, iter, value]
                 py_list_append(THIRD(), TOP());
                 POP();
                 DISPATCH();
             }
-            case OP_DICT_ADD: {
+            CASE(DICT_ADD): {
                 // [dict, iter, key, value]
                 bool ok = py_dict_setitem(FOURTH(), SECOND(), TOP());
                 if(!ok) goto __ERROR;
                 STACK_SHRINK(2);
                 DISPATCH();
             }
-            case OP_SET_ADD: {
+            CASE(SET_ADD): {
                 // [set, iter, value]
                 py_push(THIRD());  // [| set]
                 if(!py_pushmethod(py_name("add"))) {
@@ -799,36 +1011,36 @@ FrameResult VM__run_top_frame(VM* self) {
                 DISPATCH();
             }
             /////////
-            case OP_UNARY_NEGATIVE: {
+            CASE(UNARY_NEGATIVE): {
                 if(!pk_callmagic(__neg__, 1, TOP())) goto __ERROR;
                 *TOP() = self->last_retval;
                 DISPATCH();
             }
-            case OP_UNARY_NOT: {
+            CASE(UNARY_NOT): {
                 int res = py_bool(TOP());
                 if(res < 0) goto __ERROR;
                 py_newbool(TOP(), !res);
                 DISPATCH();
             }
-            case OP_UNARY_STAR: {
+            CASE(UNARY_STAR): {
                 py_TValue value = POPX();
                 int* level = py_newobject(SP()++, tp_star_wrapper, 1, sizeof(int));
                 *level = byte.arg;
                 py_setslot(TOP(), 0, &value);
                 DISPATCH();
             }
-            case OP_UNARY_INVERT: {
+            CASE(UNARY_INVERT): {
                 if(!pk_callmagic(__invert__, 1, TOP())) goto __ERROR;
                 *TOP() = self->last_retval;
                 DISPATCH();
             }
             ////////////////
-            case OP_GET_ITER: {
+            CASE(GET_ITER): {
                 if(!py_iter(TOP())) goto __ERROR;
                 *TOP() = *py_retval();
                 DISPATCH();
             }
-            case OP_FOR_ITER: {
+            CASE(FOR_ITER): {
                 int res = py_next(TOP());
                 if(res == -1) goto __ERROR;
                 if(res) {
@@ -841,7 +1053,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
             }
             ////////
-            case OP_IMPORT_PATH: {
+            CASE(IMPORT_PATH): {
                 py_Ref path_object = c11__at(py_TValue, &frame->co->consts, byte.arg);
                 const char* path = py_tostr(path_object);
                 int res = py_import(path);
@@ -853,7 +1065,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 PUSH(py_retval());
                 DISPATCH();
             }
-            case OP_POP_IMPORT_STAR: {
+            CASE(POP_IMPORT_STAR): {
                 // [module]
                 NameDict* dict = PyObject__dict(TOP()->_obj);
                 py_Ref all = NameDict__try_get(dict, __all__);
@@ -887,8 +1099,8 @@ FrameResult VM__run_top_frame(VM* self) {
                 DISPATCH();
             }
             ////////
-            case OP_UNPACK_SEQUENCE: {
-                py_TValue* p;
+            CASE(UNPACK_SEQUENCE): {
+                py_TValue* p = NULL;  // vector types push their fields directly
                 int length;
 
                 switch(TOP()->type) {
@@ -955,7 +1167,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
                 DISPATCH();
             }
-            case OP_UNPACK_EX: {
+            CASE(UNPACK_EX): {
                 py_TValue* p;
                 int length = pk_arrayview(TOP(), &p);
                 if(length == -1) {
@@ -978,7 +1190,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 DISPATCH();
             }
             ///////////
-            case OP_BEGIN_CLASS: {
+            CASE(BEGIN_CLASS): {
                 // [base]
                 py_Name name = byte.arg;
                 py_Type base;
@@ -1006,7 +1218,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 self->curr_class = TOP();
                 DISPATCH();
             }
-            case OP_END_CLASS: {
+            CASE(END_CLASS): {
                 // [cls or decorated]
                 py_Name name = byte.arg;
                 if(!Frame__setglobal(frame, name, TOP())) goto __ERROR;
@@ -1031,7 +1243,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 self->curr_class = NULL;
                 DISPATCH();
             }
-            case OP_STORE_CLASS_ATTR: {
+            CASE(STORE_CLASS_ATTR): {
                 assert(self->curr_class);
                 py_Name name = byte.arg;
                 // TOP() can be a function, classmethod or custom decorator
@@ -1047,7 +1259,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 POP();
                 DISPATCH();
             }
-            case OP_ADD_CLASS_ANNOTATION: {
+            CASE(ADD_CLASS_ANNOTATION): {
                 assert(self->curr_class);
                 // [type_hint string]
                 py_Type type = py_totype(self->curr_class);
@@ -1059,7 +1271,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 DISPATCH();
             }
             ///////////
-            case OP_WITH_ENTER: {
+            CASE(WITH_ENTER): {
                 // [expr]
                 py_push(TOP());
                 if(!py_pushmethod(__enter__)) {
@@ -1070,7 +1282,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 vectorcall_opcall(0, 0);
                 DISPATCH();
             }
-            case OP_WITH_EXIT: {
+            CASE(WITH_EXIT): {
                 // [expr]
                 py_push(TOP());
                 if(!py_pushmethod(__exit__)) {
@@ -1083,17 +1295,17 @@ FrameResult VM__run_top_frame(VM* self) {
                 DISPATCH();
             }
             ///////////
-            case OP_TRY_ENTER: {
-                Frame__set_unwind_target(frame, SP());
+            CASE(TRY_ENTER): {
+                Frame__set_unwind_target(frame, byte.arg, SP());
                 DISPATCH();
             }
-            case OP_EXCEPTION_MATCH: {
+            CASE(EXCEPTION_MATCH): {
                 if(!py_checktype(TOP(), tp_type)) goto __ERROR;
                 bool ok = py_isinstance(&self->curr_exception, py_totype(TOP()));
                 py_newbool(TOP(), ok);
                 DISPATCH();
             }
-            case OP_RAISE: {
+            CASE(RAISE): {
                 // [exception]
                 if(py_istype(TOP(), tp_type)) {
                     if(!py_tpcall(py_totype(TOP()), 0, NULL)) goto __ERROR;
@@ -1106,7 +1318,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 py_raise(TOP());
                 goto __ERROR;
             }
-            case OP_RAISE_ASSERT: {
+            CASE(RAISE_ASSERT): {
                 if(byte.arg) {
                     if(!py_str(TOP())) goto __ERROR;
                     POP();
@@ -1116,29 +1328,29 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
                 goto __ERROR;
             }
-            case OP_RE_RAISE: {
+            CASE(RE_RAISE): {
                 if(self->curr_exception.type) {
                     assert(!self->is_curr_exc_handled);
                     goto __ERROR_RE_RAISE;
                 }
                 DISPATCH();
             }
-            case OP_PUSH_EXCEPTION: {
+            CASE(PUSH_EXCEPTION): {
                 assert(self->curr_exception.type);
                 PUSH(&self->curr_exception);
                 DISPATCH();
             }
-            case OP_BEGIN_EXC_HANDLING: {
+            CASE(BEGIN_EXC_HANDLING): {
                 assert(self->curr_exception.type);
                 self->is_curr_exc_handled = true;
                 DISPATCH();
             }
-            case OP_END_EXC_HANDLING: {
+            CASE(END_EXC_HANDLING): {
                 assert(self->curr_exception.type);
                 py_clearexc(NULL);
                 DISPATCH();
             }
-            case OP_BEGIN_FINALLY: {
+            CASE(BEGIN_FINALLY): {
                 if(self->curr_exception.type) {
                     assert(!self->is_curr_exc_handled);
                     // temporarily handle the exception if any
@@ -1146,7 +1358,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 }
                 DISPATCH();
             }
-            case OP_END_FINALLY: {
+            CASE(END_FINALLY): {
                 if(byte.arg == BC_NOARG) {
                     if(self->curr_exception.type) {
                         assert(self->is_curr_exc_handled);
@@ -1160,7 +1372,7 @@ FrameResult VM__run_top_frame(VM* self) {
                 DISPATCH();
             }
             //////////////////
-            case OP_FORMAT_STRING: {
+            CASE(FORMAT_STRING): {
                 py_Ref spec = c11__at(py_TValue, &frame->co->consts, byte.arg);
                 bool ok = stack_format_object(self, py_tosv(spec));
                 if(!ok) goto __ERROR;
@@ -1261,6 +1473,45 @@ bool pk_stack_binaryop(VM* self, py_Name op, py_Name rop) {
     return TypeError("unsupported operand type(s) for '%s'", pk_op2str(op));
 }
 
+Opcode pk_specialize_binaryop(uint16_t arg, py_Ref lhs, py_Ref rhs) {
+    py_Name op = arg & 0xFF;
+    if(lhs->type == tp_int && rhs->type == tp_int) {
+        switch(op) {
+            case __add__: return OP_BINARY_ADD_INT;
+            case __sub__: return OP_BINARY_SUB_INT;
+            case __mul__: return OP_BINARY_MUL_INT;
+            case __floordiv__:
+            case __mod__: {
+                // must agree with the guard, otherwise we would deoptimize forever
+                if(lhs->_i64 < 0 || rhs->_i64 <= 0) return OP_BINARY_OP;
+                return op == __mod__ ? OP_BINARY_MOD_INT : OP_BINARY_FLOORDIV_INT;
+            }
+            case __lt__: return OP_BINARY_LT_INT;
+            case __le__: return OP_BINARY_LE_INT;
+            case __gt__: return OP_BINARY_GT_INT;
+            case __ge__: return OP_BINARY_GE_INT;
+            case __eq__: return OP_BINARY_EQ_INT;
+            case __ne__: return OP_BINARY_NE_INT;
+            default: return OP_BINARY_OP;
+        }
+    }
+    py_f64 x, y;
+    if(pk__float_operands(lhs, rhs, &x, &y)) {
+        switch(op) {
+            case __add__: return OP_BINARY_ADD_FLOAT;
+            case __sub__: return OP_BINARY_SUB_FLOAT;
+            case __mul__: return OP_BINARY_MUL_FLOAT;
+            case __truediv__: return OP_BINARY_TRUEDIV_FLOAT;
+            case __lt__: return OP_BINARY_LT_FLOAT;
+            case __le__: return OP_BINARY_LE_FLOAT;
+            case __gt__: return OP_BINARY_GT_FLOAT;
+            case __ge__: return OP_BINARY_GE_FLOAT;
+            default: return OP_BINARY_OP;
+        }
+    }
+    return OP_BINARY_OP;
+}
+
 bool py_binaryop(py_Ref lhs, py_Ref rhs, py_Name op, py_Name rop) {
     VM* self = pk_current_vm;
     PUSH(lhs);
@@ -1419,6 +1670,10 @@ static bool stack_format_object(VM* self, c11_sv spec) {
 }
 
 #undef CHECK_RETURN_FROM_EXCEPT_OR_FINALLY
+#undef FETCH_BYTE
+#undef CASE
+#undef DISPATCH_NEXT
+#undef SELECT_DISPATCH_TABLE
 #undef DISPATCH
 #undef DISPATCH_JUMP
 #undef DISPATCH_JUMP_ABSOLUTE
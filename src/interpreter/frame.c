@@ -5,6 +5,7 @@
 #include "pocketpy/objects/codeobject.h"
 #include "pocketpy/pocketpy.h"
 #include <stdbool.h>
+#include <string.h>
 
 void ValueStack__ctor(ValueStack* self) {
     self->sp = self->begin;
@@ -68,6 +69,7 @@ py_Frame* Frame__new(const CodeObject* co,
     self->is_locals_special = is_locals_special;
     self->ip = -1;
     self->uw_list = NULL;
+    memset(&self->line_cursor, 0, sizeof(LinetableCursor));
     return self;
 }
 
@@ -102,8 +104,7 @@ UnwindTarget* Frame__find_unwind_target(py_Frame* self, int iblock) {
     return NULL;
 }
 
-void Frame__set_unwind_target(py_Frame* self, py_TValue* sp) {
-    int iblock = Frame__iblock(self);
+void Frame__set_unwind_target(py_Frame* self, int iblock, py_TValue* sp) {
     assert(iblock >= 0);
     UnwindTarget* existing = Frame__find_unwind_target(self, iblock);
     if(existing) {
@@ -120,17 +121,18 @@ void Frame__gc_mark(py_Frame* self) {
     CodeObject__gc_mark(self->co);
 }
 
-int Frame__lineno(const py_Frame* self) {
+// the cursor makes the lookups of a tracer, which follow `ip`, constant time
+int Frame__lineno(py_Frame* self) {
     int ip = self->ip;
-    if(ip >= 0) return c11__getitem(BytecodeEx, &self->co->codes_ex, ip).lineno;
+    if(ip >= 0) return CodeObject__line_info(self->co, ip, &self->line_cursor).lineno;
     if(!self->is_locals_special) return self->co->start_line;
     return 0;
 }
 
-int Frame__iblock(const py_Frame* self) {
+int Frame__iblock(py_Frame* self) {
     int ip = self->ip;
     if(ip < 0) return -1;
-    return c11__getitem(BytecodeEx, &self->co->codes_ex, ip).iblock;
+    return CodeObject__line_info(self->co, ip, &self->line_cursor).iblock;
 }
 
 int Frame__getglobal(py_Frame* self, py_Name name) {
@@ -1,12 +1,17 @@
 #include "pocketpy/interpreter/heap.h"
 #include "pocketpy/config.h"
 #include "pocketpy/interpreter/objectpool.h"
+#include "pocketpy/interpreter/vm.h"
 #include "pocketpy/objects/base.h"
 #include "pocketpy/pocketpy.h"
 
+#include <limits.h>
+
 void ManagedHeap__ctor(ManagedHeap* self) {
     MultiPool__ctor(&self->small_objects);
     c11_vector__ctor(&self->large_objects, sizeof(PyObject*));
+    c11_vector__ctor(&self->pending_large_objects, sizeof(PyObject*));
+    c11_vector__ctor(&self->gray_objects, sizeof(PyObject*));
 
     for(int i = 0; i < c11__count_array(self->freed_ma); i++) {
         self->freed_ma[i] = PK_GC_MIN_THRESHOLD;
@@ -14,6 +19,10 @@ void ManagedHeap__ctor(ManagedHeap* self) {
     self->gc_threshold = PK_GC_MIN_THRESHOLD;
     self->gc_counter = 0;
     self->gc_enabled = true;
+    self->gc_mode = GC_MODE_FULL;
+    self->gc_sweeping = false;
+    self->gc_sweep_freed = 0;
+    self->gc_sweep_threads = 1;
 }
 
 void ManagedHeap__dtor(ManagedHeap* self) {
@@ -26,13 +35,16 @@ void ManagedHeap__dtor(ManagedHeap* self) {
         PK_FREE(obj);
     }
     c11_vector__dtor(&self->large_objects);
+    for(int i = 0; i < self->pending_large_objects.length; i++) {
+        PyObject* obj = c11__getitem(PyObject*, &self->pending_large_objects, i);
+        PyObject__dtor(obj);
+        PK_FREE(obj);
+    }
+    c11_vector__dtor(&self->pending_large_objects);
+    c11_vector__dtor(&self->gray_objects);
 }
 
-void ManagedHeap__collect_if_needed(ManagedHeap* self) {
-    if(!self->gc_enabled) return;
-    if(self->gc_counter < self->gc_threshold) return;
-    self->gc_counter = 0;
-    int freed = ManagedHeap__collect(self);
+static void ManagedHeap__adjust_threshold(ManagedHeap* self, int freed) {
     // adjust `gc_threshold` based on `freed_ma`
     self->freed_ma[0] = self->freed_ma[1];
     self->freed_ma[1] = self->freed_ma[2];
@@ -46,15 +58,95 @@ void ManagedHeap__collect_if_needed(ManagedHeap* self) {
     self->gc_threshold = c11__min(c11__max(new_threshold, lower), upper);
 }
 
+static void ManagedHeap__sweep_begin(ManagedHeap* self) {
+    assert(!self->gc_sweeping);
+    // everything allocated from now on goes to swept or new storage and stays unmarked
+    MultiPool__sweep_begin(&self->small_objects);
+    c11_vector__swap(&self->large_objects, &self->pending_large_objects);
+    self->gc_sweeping = true;
+    self->gc_sweep_freed = 0;
+}
+
+/// Sweep about `budget` blocks of the pending storage.
+static int ManagedHeap__sweep_step(ManagedHeap* self, int budget) {
+    int freed = MultiPool__sweep_step(&self->small_objects, &budget);
+    while(self->pending_large_objects.length > 0 && budget > 0) {
+        PyObject* obj = c11_vector__back(PyObject*, &self->pending_large_objects);
+        c11_vector__pop(&self->pending_large_objects);
+        if(obj->gc_marked) {
+            obj->gc_marked = false;
+            c11_vector__push(PyObject*, &self->large_objects, obj);
+        } else {
+            PyObject__dtor(obj);
+            PK_FREE(obj);
+            freed++;
+        }
+        budget--;
+    }
+    self->gc_sweep_freed += freed;
+    if(budget > 0) {
+        // nothing left to sweep
+        self->gc_sweeping = false;
+        ManagedHeap__adjust_threshold(self, self->gc_sweep_freed);
+    }
+    return freed;
+}
+
+void ManagedHeap__collect_if_needed(ManagedHeap* self) {
+    if(self->gc_sweeping) ManagedHeap__sweep_step(self, PK_GC_SWEEP_STEP);
+    if(!self->gc_enabled) return;
+    if(self->gc_counter < self->gc_threshold) return;
+    self->gc_counter = 0;
+    if(self->gc_mode == GC_MODE_LAZY_SWEEP) {
+        if(self->gc_sweeping) ManagedHeap__sweep_step(self, INT_MAX);
+        ManagedHeap__mark(self);
+        ManagedHeap__sweep_begin(self);
+        ManagedHeap__sweep_step(self, PK_GC_SWEEP_STEP);
+        return;
+    }
+    int freed = ManagedHeap__collect(self);
+    ManagedHeap__adjust_threshold(self, freed);
+}
+
 int ManagedHeap__collect(ManagedHeap* self) {
+    // finish the previous lazy sweep before marking again
+    int freed = self->gc_sweeping ? ManagedHeap__sweep_step(self, INT_MAX) : 0;
     ManagedHeap__mark(self);
-    int freed = ManagedHeap__sweep(self);
+    freed += ManagedHeap__sweep(self);
+    return freed;
+}
+
+#if PK_ENABLE_THREADS
+static int ManagedHeap__sweep_small_parallel(ManagedHeap* self) {
+    TypeList* type_list = &pk_current_vm->types;
+    py_Dtor list_dtor = pk__type_info(tp_list)->dtor;
+    py_Dtor dict_dtor = pk__type_info(tp_dict)->dtor;
+    py_Dtor str_dtor = pk__type_info(tp_str)->dtor;
+    PoolSweepType* types = PK_MALLOC(sizeof(PoolSweepType) * type_list->length);
+    types[0].dtor = NULL;
+    types[0].deferred = false;
+    for(py_Type i = 1; i < type_list->length; i++) {
+        py_Dtor dtor = TypeList__get(type_list, i)->dtor;
+        types[i].dtor = dtor;
+        // list, dict and str dtors only release memory, others may touch the VM
+        types[i].deferred = dtor && dtor != list_dtor && dtor != dict_dtor && dtor != str_dtor;
+    }
+    int freed = MultiPool__sweep_dealloc_parallel(&self->small_objects,
+                                                  self->gc_sweep_threads,
+                                                  types);
+    PK_FREE(types);
     return freed;
 }
+#endif
 
 int ManagedHeap__sweep(ManagedHeap* self) {
     // small_objects
+#if PK_ENABLE_THREADS
+    int small_freed = self->gc_sweep_threads > 1 ? ManagedHeap__sweep_small_parallel(self)
+                                                 : MultiPool__sweep_dealloc(&self->small_objects);
+#else
     int small_freed = MultiPool__sweep_dealloc(&self->small_objects);
+#endif
     // large_objects
     int large_living_count = 0;
     for(int i = 0; i < self->large_objects.length; i++) {
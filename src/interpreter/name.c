@@ -1,8 +1,12 @@
 #include "pocketpy/interpreter/name.h"
 #include "pocketpy/interpreter/vm.h"
 
+#define NAMES_INIT_CAPACITY 512
+
 void InternedNames__ctor(InternedNames* self) {
-    c11_smallmap_s2n__ctor(&self->interned);
+    self->capacity = NAMES_INIT_CAPACITY;
+    self->table = PK_MALLOC(sizeof(py_Name) * self->capacity);
+    memset(self->table, 0, sizeof(py_Name) * self->capacity);
     c11_vector__ctor(&self->r_interned, sizeof(RInternedEntry));
 
     // initialize all magic names
@@ -16,10 +20,28 @@ void InternedNames__dtor(InternedNames* self) {
     for(int i = 0; i < self->r_interned.length; i++) {
         PK_FREE(c11__getitem(RInternedEntry, &self->r_interned, i).data);
     }
-    c11_smallmap_s2n__dtor(&self->interned);
+    PK_FREE(self->table);
     c11_vector__dtor(&self->r_interned);
 }
 
+static void InternedNames__grow(InternedNames* self) {
+    uint32_t new_capacity = self->capacity * 2;
+    uint32_t mask = new_capacity - 1;
+    py_Name* new_table = PK_MALLOC(sizeof(py_Name) * new_capacity);
+    memset(new_table, 0, sizeof(py_Name) * new_capacity);
+    for(int i = 0; i < self->r_interned.length; i++) {
+        RInternedEntry* entry = c11__at(RInternedEntry, &self->r_interned, i);
+        uint32_t pos = entry->hash & mask;
+        while(new_table[pos] != 0) {
+            pos = (pos + 1) & mask;
+        }
+        new_table[pos] = i + 1;
+    }
+    PK_FREE(self->table);
+    self->table = new_table;
+    self->capacity = new_capacity;
+}
+
 py_Name py_name(const char* name) {
     c11_sv sv;
     sv.data = name;
@@ -29,41 +51,50 @@ py_Name py_name(const char* name) {
 
 py_Name py_namev(c11_sv name) {
     InternedNames* self = &pk_current_vm->names;
-    uint16_t index = c11_smallmap_s2n__get(&self->interned, name, 0);
-    if(index != 0) return index;
+    uint32_t hash = (uint32_t)c11__hash_bytes(name.data, name.size);
+    uint32_t mask = self->capacity - 1;
+    uint32_t pos = hash & mask;
+    RInternedEntry* entries = self->r_interned.data;
+    while(self->table[pos] != 0) {
+        RInternedEntry* entry = &entries[self->table[pos] - 1];
+        if(entry->hash == hash && entry->size == name.size &&
+           memcmp(entry->data, name.data, name.size) == 0) {
+            return self->table[pos];
+        }
+        pos = (pos + 1) & mask;
+    }
     // generate new index
-    if(self->interned.length > 65530) c11__abort("py_Name index overflow");
-    // NOTE: we must allocate the string in the heap so iterators are not invalidated
     char* p = PK_MALLOC(name.size + 1);
     memcpy(p, name.data, name.size);
     p[name.size] = '\0';
     RInternedEntry* entry = c11_vector__emplace(&self->r_interned);
     entry->data = p;
     entry->size = name.size;
+    entry->hash = hash;
     memset(&entry->obj, 0, sizeof(py_TValue));
-    index = self->r_interned.length;  // 1-based
-    // save to _interned
-    c11_smallmap_s2n__set(&self->interned, (c11_sv){p, name.size}, index);
-    assert(self->interned.length == self->r_interned.length);
+    py_Name index = self->r_interned.length;  // 1-based
+    self->table[pos] = index;
+    // keep the load factor below 0.5
+    if((uint32_t)self->r_interned.length * 2 > self->capacity) InternedNames__grow(self);
     return index;
 }
 
 const char* py_name2str(py_Name index) {
     InternedNames* self = &pk_current_vm->names;
-    assert(index > 0 && index <= self->interned.length);
+    assert(index > 0 && index <= (py_Name)self->r_interned.length);
     return c11__getitem(RInternedEntry, &self->r_interned, index - 1).data;
 }
 
 c11_sv py_name2sv(py_Name index) {
     InternedNames* self = &pk_current_vm->names;
-    assert(index > 0 && index <= self->interned.length);
+    assert(index > 0 && index <= (py_Name)self->r_interned.length);
     RInternedEntry entry = c11__getitem(RInternedEntry, &self->r_interned, index - 1);
     return (c11_sv){entry.data, entry.size};
 }
 
 py_GlobalRef py_name2ref(py_Name index) {
     InternedNames* self = &pk_current_vm->names;
-    assert(index > 0 && index <= self->interned.length);
+    assert(index > 0 && index <= (py_Name)self->r_interned.length);
     RInternedEntry* entry = c11__at(RInternedEntry, &self->r_interned, index - 1);
     if(entry->obj.type == tp_nil) {
         c11_sv sv;
@@ -73,3 +104,5 @@ py_GlobalRef py_name2ref(py_Name index) {
     }
     return &entry->obj;
 }
+
+#undef NAMES_INIT_CAPACITY
@@ -3,80 +3,140 @@
 #include "pocketpy/config.h"
 #include "pocketpy/objects/object.h"
 #include "pocketpy/common/sstream.h"
+#include "pocketpy/common/threads.h"
+#include "pocketpy/common/utils.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 
+static const int kPoolBlockSizes[kMultiPoolCount] = {
+    32, 64, 96, 128, 160, 192, 256, 384, 512, 768, 1024,
+};
+
+// size class of each 32-byte step, indexed by `(size - 1) / 32`
+static const unsigned char kPoolSizeClass[kPoolMaxBlockSize / kPoolMinBlockSize] = {
+    0, 1, 2, 3, 4, 5, 6, 6, 7, 7, 7, 7, 8, 8, 8, 8,
+    9, 9, 9, 9, 9, 9, 9, 9, 10, 10, 10, 10, 10, 10, 10, 10,
+};
+
 static PoolArena* PoolArena__new(int block_size) {
     assert(kPoolArenaSize % block_size == 0);
-    int block_count = kPoolArenaSize / block_size;
-    PoolArena* self = PK_MALLOC(sizeof(PoolArena) + sizeof(int) * block_count);
+    PoolArena* self = PK_MALLOC(sizeof(PoolArena));
     self->block_size = block_size;
-    self->block_count = block_count;
-    self->unused_length = block_count;
-    self->unused = PK_MALLOC(sizeof(int) * block_count);
-    for(int i = 0; i < block_count; i++) {
-        self->unused[i] = i;
-    }
-    memset(self->data, 0, kPoolArenaSize);
+    self->block_count = kPoolArenaSize / block_size;
+    self->free_count = self->block_count;
+    self->bump = 0;
+    self->block_size_inv = (uint32_t)((((uint64_t)1 << 32) + block_size - 1) / block_size);
+    self->free_list = NULL;
+    memset(self->used, 0, sizeof(self->used));
     return self;
 }
 
+static int PoolArena__index(const PoolArena* self, const void* p) {
+    // exact for every offset inside an arena, see `block_size_inv`
+    uint64_t offset = (const char*)p - self->data;
+    return (int)((offset * self->block_size_inv) >> 32);
+}
+
+static PyObject* PoolArena__block(PoolArena* self, int index) {
+    return (PyObject*)(self->data + index * self->block_size);
+}
+
 static void PoolArena__delete(PoolArena* self) {
-    for(int i = 0; i < self->block_count; i++) {
-        PyObject* obj = (PyObject*)(self->data + i * self->block_size);
-        if(obj->type != 0) PyObject__dtor(obj);
+    for(int w = 0; w < (int)c11__count_array(self->used); w++) {
+        for(uint64_t bits = self->used[w]; bits; bits &= bits - 1) {
+            PyObject__dtor(PoolArena__block(self, w * 64 + c11__ctz64(bits)));
+        }
     }
-    PK_FREE(self->unused);
     PK_FREE(self);
 }
 
 static void* PoolArena__alloc(PoolArena* self) {
-    assert(self->unused_length > 0);
-    int index = self->unused[self->unused_length - 1];
-    self->unused_length--;
-    return self->data + index * self->block_size;
+    assert(self->free_count > 0);
+    void* p;
+    int index;
+    if(self->free_list) {
+        p = self->free_list;
+        self->free_list = *(void**)p;
+        index = PoolArena__index(self, p);
+    } else {
+        index = self->bump++;
+        p = PoolArena__block(self, index);
+    }
+    self->used[index >> 6] |= (uint64_t)1 << (index & 63);
+    self->free_count--;
+    return p;
 }
 
-static int PoolArena__sweep_dealloc(PoolArena* self) {
+static void PoolArena__free_block(PoolArena* self, int index) {
+    void* p = PoolArena__block(self, index);
+    self->used[index >> 6] &= ~((uint64_t)1 << (index & 63));
+    *(void**)p = self->free_list;
+    self->free_list = p;
+    self->free_count++;
+}
+
+typedef struct PoolDeferredBlock {
+    PoolArena* arena;
+    int index;
+} PoolDeferredBlock;
+
+/// Sweep one arena. With `types` set this may run off the VM thread: objects whose
+/// dtor needs the VM are pushed to `deferred` and left for the caller to destroy.
+static int PoolArena__sweep_dealloc(PoolArena* self,
+                                    const PoolSweepType* types,
+                                    c11_vector* deferred) {
     int freed = 0;
-    self->unused_length = 0;
-    for(int i = 0; i < self->block_count; i++) {
-        PyObject* obj = (PyObject*)(self->data + i * self->block_size);
-        if(obj->type == 0) {
-            // free slot
-            self->unused[self->unused_length] = i;
-            self->unused_length++;
-        } else {
-            if(!obj->gc_marked) {
-                // not marked, need to free
-                PyObject__dtor(obj);
-                obj->type = 0;
-                freed++;
-                self->unused[self->unused_length] = i;
-                self->unused_length++;
-            } else {
+    int n_words = (self->block_count + 63) / 64;
+    for(int w = 0; w < n_words; w++) {
+        for(uint64_t bits = self->used[w]; bits; bits &= bits - 1) {
+            int index = w * 64 + c11__ctz64(bits);
+            PyObject* obj = PoolArena__block(self, index);
+            if(obj->gc_marked) {
                 // marked, clear mark
                 obj->gc_marked = false;
+                continue;
             }
+            // not marked, need to free
+            freed++;
+            if(types == NULL) {
+                PyObject__dtor(obj);
+            } else if(types[obj->type].deferred) {
+                PoolDeferredBlock block = {self, index};
+                c11_vector__push(PoolDeferredBlock, deferred, block);
+                continue;
+            } else {
+                if(types[obj->type].dtor) types[obj->type].dtor(PyObject__userdata(obj));
+                if(obj->slots == -1) NameDict__dtor(PyObject__dict(obj));
+            }
+            PoolArena__free_block(self, index);
         }
     }
+    if(self->free_count == self->block_count) {
+        // start over from the beginning for better locality
+        self->free_list = NULL;
+        self->bump = 0;
+    }
     return freed;
 }
 
 static void Pool__ctor(Pool* self, int block_size) {
     c11_vector__ctor(&self->arenas, sizeof(PoolArena*));
     c11_vector__ctor(&self->no_free_arenas, sizeof(PoolArena*));
+    c11_vector__ctor(&self->pending_arenas, sizeof(PoolArena*));
     self->block_size = block_size;
 }
 
 static void Pool__dtor(Pool* self) {
     c11__foreach(PoolArena*, &self->arenas, arena) PoolArena__delete(*arena);
     c11__foreach(PoolArena*, &self->no_free_arenas, arena) PoolArena__delete(*arena);
+    c11__foreach(PoolArena*, &self->pending_arenas, arena) PoolArena__delete(*arena);
     c11_vector__dtor(&self->arenas);
     c11_vector__dtor(&self->no_free_arenas);
+    c11_vector__dtor(&self->pending_arenas);
 }
 
 static void* Pool__alloc(Pool* self) {
@@ -88,90 +148,276 @@ static void* Pool__alloc(Pool* self) {
         arena = c11_vector__back(PoolArena*, &self->arenas);
     }
     void* ptr = PoolArena__alloc(arena);
-    if(arena->unused_length == 0) {
+    if(arena->free_count == 0) {
         c11_vector__pop(&self->arenas);
         c11_vector__push(PoolArena*, &self->no_free_arenas, arena);
     }
     return ptr;
 }
 
-static int Pool__sweep_dealloc(Pool* self, c11_vector* arenas, c11_vector* no_free_arenas) {
-    c11_vector__clear(arenas);
-    c11_vector__clear(no_free_arenas);
+static void Pool__sweep_begin(Pool* self) {
+    // arenas being swept are hidden from `Pool__alloc`, so new objects never land in them
+    c11_vector* pending = &self->pending_arenas;
+    if(self->no_free_arenas.length > 0) {
+        c11_vector__extend(PoolArena*,
+                           pending,
+                           self->no_free_arenas.data,
+                           self->no_free_arenas.length);
+    }
+    if(self->arenas.length > 0) {
+        c11_vector__extend(PoolArena*, pending, self->arenas.data, self->arenas.length);
+    }
+    c11_vector__clear(&self->arenas);
+    c11_vector__clear(&self->no_free_arenas);
+}
+
+static int PoolArena__emptier(const void* a, const void* b, void* extra) {
+    return (*(PoolArena**)a)->free_count > (*(PoolArena**)b)->free_count;
+}
+
+static void Pool__sort_arenas(Pool* self) {
+    // allocate from the fullest arena first, so that sparse arenas can drain and be released
+    c11__stable_sort(self->arenas.data,
+                     self->arenas.length,
+                     sizeof(PoolArena*),
+                     PoolArena__emptier,
+                     NULL);
+}
 
+static void Pool__push_swept(Pool* self, PoolArena* item) {
+    if(item->free_count == 0) {
+        // still no free
+        c11_vector__push(PoolArena*, &self->no_free_arenas, item);
+    } else if(item->free_count == item->block_count && self->arenas.length > 0) {
+        // all free, keep at most one empty arena
+        PoolArena__delete(item);
+    } else {
+        // some free
+        c11_vector__push(PoolArena*, &self->arenas, item);
+    }
+}
+
+static int Pool__sweep_step(Pool* self, int* budget) {
     int freed = 0;
-    for(int i = 0; i < self->arenas.length; i++) {
-        PoolArena* item = c11__getitem(PoolArena*, &self->arenas, i);
-        assert(item->unused_length > 0);
-        freed += PoolArena__sweep_dealloc(item);
-        if(item->unused_length == item->block_count) {
-            // all free
-            if(arenas->length > 0) {
-                // at least one arena
-                PoolArena__delete(item);
-            } else {
-                // no arena
-                c11_vector__push(PoolArena*, arenas, item);
-            }
-        } else {
-            // some free
-            c11_vector__push(PoolArena*, arenas, item);
-        }
+    while(self->pending_arenas.length > 0 && *budget > 0) {
+        PoolArena* item = c11_vector__back(PoolArena*, &self->pending_arenas);
+        c11_vector__pop(&self->pending_arenas);
+        freed += PoolArena__sweep_dealloc(item, NULL, NULL);
+        *budget -= item->block_count;
+        Pool__push_swept(self, item);
+        if(self->pending_arenas.length == 0) Pool__sort_arenas(self);
     }
-    for(int i = 0; i < self->no_free_arenas.length; i++) {
-        PoolArena* item = c11__getitem(PoolArena*, &self->no_free_arenas, i);
-        freed += PoolArena__sweep_dealloc(item);
-        if(item->unused_length == 0) {
-            // still no free
-            c11_vector__push(PoolArena*, no_free_arenas, item);
-        } else {
-            if(item->unused_length == item->block_count) {
-                // all free
-                PoolArena__delete(item);
-            } else {
-                // some free
-                c11_vector__push(PoolArena*, arenas, item);
-            }
-        }
+    return freed;
+}
+
+void* MultiPool__alloc(MultiPool* self, int size) {
+    if(size == 0 || size > kPoolMaxBlockSize) return NULL;
+    Pool* pool = &self->pools[kPoolSizeClass[(size - 1) >> 5]];
+    return Pool__alloc(pool);
+}
+
+int MultiPool__sweep_dealloc(MultiPool* self) {
+    MultiPool__sweep_begin(self);
+    int budget = INT_MAX;
+    return MultiPool__sweep_step(self, &budget);
+}
+
+void MultiPool__sweep_begin(MultiPool* self) {
+    for(int i = 0; i < kMultiPoolCount; i++) {
+        Pool__sweep_begin(&self->pools[i]);
     }
+}
 
-    c11_vector__swap(&self->arenas, arenas);
-    c11_vector__swap(&self->no_free_arenas, no_free_arenas);
+int MultiPool__sweep_step(MultiPool* self, int* budget) {
+    int freed = 0;
+    for(int i = 0; i < kMultiPoolCount; i++) {
+        freed += Pool__sweep_step(&self->pools[i], budget);
+    }
     return freed;
 }
 
-void* MultiPool__alloc(MultiPool* self, int size) {
-    if(size == 0) return NULL;
-    int index = (size - 1) >> 5;
-    if(index < kMultiPoolCount) {
-        Pool* pool = &self->pools[index];
-        return Pool__alloc(pool);
+#if PK_ENABLE_THREADS
+typedef struct PoolSweepTask {
+    PoolArena** begin;
+    PoolArena** end;
+    const PoolSweepType* types;
+    c11_vector /* PoolDeferredBlock */ deferred;
+    int freed;
+} PoolSweepTask;
+
+typedef struct PoolSweepWorker {
+    struct PoolSweepWorkers* owner;
+    int index;  // runs `owner->tasks[index + 1]`, the calling thread runs `tasks[0]`
+    int round;  // last round this worker has taken part in
+    c11_thrd thrd;
+} PoolSweepWorker;
+
+// sweeper threads live as long as the pool and sleep between collections
+typedef struct PoolSweepWorkers {
+    c11_mtx lock;
+    c11_cnd wake;  // a new round of tasks was published, or `quit` was set
+    c11_cnd done;  // `pending` dropped to zero
+    int round;
+    int pending;
+    bool quit;
+    int n_tasks;
+    int n_workers;
+    PoolSweepTask tasks[PK_GC_MAX_SWEEP_THREADS];
+    PoolSweepWorker workers[PK_GC_MAX_SWEEP_THREADS - 1];
+} PoolSweepWorkers;
+
+static void PoolSweepTask__run(PoolSweepTask* task) {
+    for(PoolArena** p = task->begin; p != task->end; p++) {
+        task->freed += PoolArena__sweep_dealloc(*p, task->types, &task->deferred);
     }
-    return NULL;
 }
 
-int MultiPool__sweep_dealloc(MultiPool* self) {
-    c11_vector arenas;
-    c11_vector no_free_arenas;
-    c11_vector__ctor(&arenas, sizeof(PoolArena*));
-    c11_vector__ctor(&no_free_arenas, sizeof(PoolArena*));
+static void PoolSweepWorker__main(void* arg) {
+    PoolSweepWorker* self = arg;
+    PoolSweepWorkers* owner = self->owner;
+    c11_mtx__lock(&owner->lock);
+    while(true) {
+        while(!owner->quit && owner->round == self->round) {
+            c11_cnd__wait(&owner->wake, &owner->lock);
+        }
+        if(owner->quit) break;
+        self->round = owner->round;
+        // tasks are not touched by anyone else until `pending` reaches zero
+        PoolSweepTask* task = self->index + 1 < owner->n_tasks ? &owner->tasks[self->index + 1]
+                                                               : NULL;
+        c11_mtx__unlock(&owner->lock);
+        if(task) PoolSweepTask__run(task);
+        c11_mtx__lock(&owner->lock);
+        if(--owner->pending == 0) c11_cnd__signal(&owner->done);
+    }
+    c11_mtx__unlock(&owner->lock);
+}
+
+static PoolSweepWorkers* PoolSweepWorkers__new() {
+    PoolSweepWorkers* self = PK_MALLOC(sizeof(PoolSweepWorkers));
+    c11_mtx__ctor(&self->lock);
+    c11_cnd__ctor(&self->wake);
+    c11_cnd__ctor(&self->done);
+    self->round = 0;
+    self->pending = 0;
+    self->quit = false;
+    self->n_tasks = 0;
+    self->n_workers = 0;
+    return self;
+}
+
+static void PoolSweepWorkers__delete(PoolSweepWorkers* self) {
+    c11_mtx__lock(&self->lock);
+    self->quit = true;
+    c11_cnd__broadcast(&self->wake);
+    c11_mtx__unlock(&self->lock);
+    for(int i = 0; i < self->n_workers; i++) {
+        c11_thrd__join(&self->workers[i].thrd);
+    }
+    c11_cnd__dtor(&self->done);
+    c11_cnd__dtor(&self->wake);
+    c11_mtx__dtor(&self->lock);
+    PK_FREE(self);
+}
+
+// start more workers if needed, returns how many are available
+static int PoolSweepWorkers__reserve(PoolSweepWorkers* self, int n) {
+    while(self->n_workers < n) {
+        PoolSweepWorker* worker = &self->workers[self->n_workers];
+        worker->owner = self;
+        worker->index = self->n_workers;
+        // only the VM thread bumps `round`, so a late starter still sees the next one
+        worker->round = self->round;
+        if(!c11_thrd__create(&worker->thrd, PoolSweepWorker__main, worker)) break;
+        self->n_workers++;
+    }
+    return self->n_workers;
+}
+
+int MultiPool__sweep_dealloc_parallel(MultiPool* self, int n_threads, const PoolSweepType* types) {
+    MultiPool__sweep_begin(self);
+    c11_vector all;
+    c11_vector__ctor(&all, sizeof(PoolArena*));
+    for(int i = 0; i < kMultiPoolCount; i++) {
+        c11_vector* pending = &self->pools[i].pending_arenas;
+        if(pending->length > 0) {
+            c11_vector__extend(PoolArena*, &all, pending->data, pending->length);
+        }
+    }
+    // each thread should get a few arenas, or waking it costs more than it saves
+    n_threads = c11__min(n_threads, all.length / 4);
+    n_threads = c11__min(n_threads, PK_GC_MAX_SWEEP_THREADS);
+    if(n_threads > 1) {
+        if(self->sweep_workers == NULL) self->sweep_workers = PoolSweepWorkers__new();
+        n_threads = PoolSweepWorkers__reserve(self->sweep_workers, n_threads - 1) + 1;
+    }
+    if(n_threads <= 1) {
+        c11_vector__dtor(&all);
+        int budget = INT_MAX;
+        return MultiPool__sweep_step(self, &budget);
+    }
+
+    PoolSweepWorkers* workers = self->sweep_workers;
+    int chunk = (all.length + n_threads - 1) / n_threads;
+    for(int i = 0; i < n_threads; i++) {
+        PoolSweepTask* task = &workers->tasks[i];
+        int lo = c11__min(i * chunk, all.length);
+        int hi = c11__min(lo + chunk, all.length);
+        task->begin = (PoolArena**)all.data + lo;
+        task->end = (PoolArena**)all.data + hi;
+        task->types = types;
+        c11_vector__ctor(&task->deferred, sizeof(PoolDeferredBlock));
+        task->freed = 0;
+    }
+    // workers without a task this round wake up and go straight back to sleep
+    c11_mtx__lock(&workers->lock);
+    workers->n_tasks = n_threads;
+    workers->pending = workers->n_workers;
+    workers->round++;
+    c11_cnd__broadcast(&workers->wake);
+    c11_mtx__unlock(&workers->lock);
+    // the calling thread takes the first chunk
+    PoolSweepTask__run(&workers->tasks[0]);
+    c11_mtx__lock(&workers->lock);
+    while(workers->pending > 0) {
+        c11_cnd__wait(&workers->done, &workers->lock);
+    }
+    c11_mtx__unlock(&workers->lock);
+
     int freed = 0;
+    for(int i = 0; i < n_threads; i++) {
+        PoolSweepTask* task = &workers->tasks[i];
+        freed += task->freed;
+        c11__foreach(PoolDeferredBlock, &task->deferred, p) {
+            PyObject__dtor(PoolArena__block(p->arena, p->index));
+            PoolArena__free_block(p->arena, p->index);
+        }
+        c11_vector__dtor(&task->deferred);
+    }
+    c11_vector__dtor(&all);
     for(int i = 0; i < kMultiPoolCount; i++) {
-        Pool* item = &self->pools[i];
-        freed += Pool__sweep_dealloc(item, &arenas, &no_free_arenas);
+        Pool* pool = &self->pools[i];
+        c11__foreach(PoolArena*, &pool->pending_arenas, p) Pool__push_swept(pool, *p);
+        c11_vector__clear(&pool->pending_arenas);
+        Pool__sort_arenas(pool);
     }
-    c11_vector__dtor(&arenas);
-    c11_vector__dtor(&no_free_arenas);
     return freed;
 }
+#endif
 
 void MultiPool__ctor(MultiPool* self) {
     for(int i = 0; i < kMultiPoolCount; i++) {
-        Pool__ctor(&self->pools[i], 32 * (i + 1));
+        Pool__ctor(&self->pools[i], kPoolBlockSizes[i]);
     }
+#if PK_ENABLE_THREADS
+    self->sweep_workers = NULL;
+#endif
 }
 
 void MultiPool__dtor(MultiPool* self) {
+#if PK_ENABLE_THREADS
+    if(self->sweep_workers) PoolSweepWorkers__delete(self->sweep_workers);
+#endif
     for(int i = 0; i < kMultiPoolCount; i++) {
         Pool__dtor(&self->pools[i]);
     }
@@ -182,11 +428,17 @@ c11_string* MultiPool__summary(MultiPool* self) {
     c11_sbuf__ctor(&sbuf);
     for(int i = 0; i < kMultiPoolCount; i++) {
         Pool* item = &self->pools[i];
-        int total_bytes = (item->arenas.length + item->no_free_arenas.length) * kPoolArenaSize;
+        int arena_count =
+            item->arenas.length + item->no_free_arenas.length + item->pending_arenas.length;
+        int total_bytes = arena_count * kPoolArenaSize;
         int used_bytes = 0;
         for(int j = 0; j < item->arenas.length; j++) {
             PoolArena* arena = c11__getitem(PoolArena*, &item->arenas, j);
-            used_bytes += (arena->block_count - arena->unused_length) * arena->block_size;
+            used_bytes += (arena->block_count - arena->free_count) * arena->block_size;
+        }
+        for(int j = 0; j < item->pending_arenas.length; j++) {
+            PoolArena* arena = c11__getitem(PoolArena*, &item->pending_arenas, j);
+            used_bytes += (arena->block_count - arena->free_count) * arena->block_size;
         }
         used_bytes += item->no_free_arenas.length * kPoolArenaSize;
         float used_pct = (float)used_bytes / total_bytes * 100;
@@ -66,6 +66,8 @@ void VM__ctor(VM* self) {
     self->main = *py_NIL();
 
     self->callbacks.importfile = pk_default_importfile;
+    self->cache_dir = NULL;
+    self->optimize = 1;
     self->callbacks.print = pk_default_print;
     self->callbacks.getchar = getchar;
 
@@ -215,6 +217,7 @@ void VM__ctor(VM* self) {
 
     pk__add_module_linalg();
     pk__add_module_array2d();
+    pk__add_module_linalg_arrays();
     pk__add_module_colorcvt();
 
     // add modules
@@ -232,6 +235,7 @@ void VM__ctor(VM* self) {
     pk__add_module_enum();
     pk__add_module_inspect();
     pk__add_module_pickle();
+    pk__add_module_channel();
     pk__add_module_importlib();
 
     pk__add_module_conio();
@@ -264,6 +268,7 @@ void VM__dtor(VM* self) {
     FixedMemoryPool__dtor(&self->pool_frame);
     ValueStack__dtor(&self->stack);
     InternedNames__dtor(&self->names);
+    if(self->cache_dir) c11_string__delete(self->cache_dir);
 }
 
 void VM__push_frame(VM* self, py_Frame* frame) {
@@ -377,6 +382,7 @@ py_Type pk_newtype(const char* name,
     }
     py_TypeInfo__ctor(ti, py_name(name), index, base, base_ti, module ? *module : *py_NIL());
     if(!dtor && base) dtor = base_ti->dtor;
+    if(base_ti) base_ti->has_subclass = true;
     ti->dtor = dtor;
     ti->is_python = is_python;
     ti->is_sealed = is_sealed;
@@ -605,11 +611,31 @@ void PyObject__dtor(PyObject* self) {
     if(self->slots == -1) NameDict__dtor(PyObject__dict(self));
 }
 
+// whether `PyObject__mark_children` has anything to visit
+static bool PyObject__has_children(PyObject* obj) {
+    if(obj->slots != 0) return true;
+    switch(obj->type) {
+        case tp_list:
+        case tp_dict:
+        case tp_generator:
+        case tp_function:
+        case tp_code:
+        case tp_chunked_array2d: return true;
+        default: return false;
+    }
+}
+
 void PyObject__mark(PyObject* obj) {
     assert(!obj->gc_marked);
-
     obj->gc_marked = true;
+    // leaves like str are done here; other objects have their children visited later by
+    // `ManagedHeap__mark`, so deep graphs cannot overflow the C stack
+    if(PyObject__has_children(obj)) {
+        c11_vector__push(PyObject*, &pk_current_vm->heap.gray_objects, obj);
+    }
+}
 
+static void PyObject__mark_children(PyObject* obj) {
     if(obj->slots > 0) {
         py_TValue* p = PyObject__slots(obj);
         for(int i = 0; i < obj->slots; i++)
@@ -657,6 +683,7 @@ void PyObject__mark(PyObject* obj) {
         }
         case tp_chunked_array2d: {
             c11_chunked_array2d__mark(ud);
+            break;
         }
         default: return;
     }
@@ -732,6 +759,19 @@ void ManagedHeap__mark(ManagedHeap* self) {
         RInternedEntry* entry = c11__at(RInternedEntry, &vm->names.r_interned, i);
         pk__mark_value(&entry->obj);
     }
+    // visit everything reachable from the roots
+    c11_vector* gray = &self->gray_objects;
+    while(gray->length > 0) {
+        PyObject* obj = c11_vector__back(PyObject*, gray);
+        c11_vector__pop(gray);
+        if(gray->length > 0) c11__prefetch(c11_vector__back(PyObject*, gray));
+        PyObject__mark_children(obj);
+    }
+    // a deep graph can grow the stack a lot, don't hold on to it between collections
+    if(gray->capacity > PK_GC_GRAY_STACK_KEEP) {
+        c11_vector__dtor(gray);
+        c11_vector__ctor(gray, sizeof(PyObject*));
+    }
 }
 
 void pk_print_stack(VM* self, py_Frame* frame, Bytecode byte) {
@@ -801,6 +841,22 @@ bool pk_wrapper__self(int argc, py_Ref argv) {
 
 py_TypeInfo* pk__type_info(py_Type type) { return TypeList__get(&pk_current_vm->types, type); }
 
+void pk__type_modified(py_Type type) {
+    TypeList* types = &pk_current_vm->types;
+    py_TypeInfo* ti = TypeList__get(types, type);
+    ti->version++;
+    if(!ti->has_subclass) return;
+    for(py_Type t = type + 1; t < types->length; t++) {
+        py_TypeInfo* sub = TypeList__get(types, t);
+        for(py_TypeInfo* p = sub->base_ti; p; p = p->base_ti) {
+            if(p == ti) {
+                sub->version++;
+                break;
+            }
+        }
+    }
+}
+
 int py_replinput(char* buf, int max_size) {
     buf[0] = '\0';  // reset first char because we check '@' at the beginning
 
@@ -2,6 +2,8 @@
 #include "pocketpy/interpreter/vm.h"
 #include "pocketpy/pocketpy.h"
 #include <limits.h>
+#include <math.h>
+#include <stdlib.h>
 
 static bool c11_array2d_like_is_valid(c11_array2d_like* self, int col, int row) {
     return col >= 0 && col < self->n_cols && row >= 0 && row < self->n_rows;
@@ -28,6 +30,462 @@ c11_array2d* py_newarray2d(py_OutRef out, int n_cols, int n_rows) {
     return ud;
 }
 
+/* array2d_packed */
+static const char* const c11_dtype__names[] = {"bool", "int8", "int32", "float32"};
+static const int c11_dtype__itemsizes[] = {1, 1, 4, 4};
+
+typedef union c11_dtype_value {
+    bool _bool;
+    int8_t _int8;
+    int32_t _int32;
+    float _float32;
+    uint8_t _bits8;
+    uint32_t _bits32;
+} c11_dtype_value;
+
+static bool c11_dtype__parse(c11_sv name, c11_dtype* out) {
+    for(int i = 0; i < (int)c11__count_array(c11_dtype__names); i++) {
+        if(c11__sveq2(name, c11_dtype__names[i])) {
+            *out = (c11_dtype)i;
+            return true;
+        }
+    }
+    return ValueError("dtype must be 'bool', 'int8', 'int32' or 'float32', got '%v'", name);
+}
+
+static bool c11_dtype__is_int(c11_dtype dtype) {
+    return dtype == c11_dtype_int8 || dtype == c11_dtype_int32;
+}
+
+static bool c11_dtype__contains(c11_dtype dtype, py_i64 val) {
+    switch(dtype) {
+        case c11_dtype_int8: return val >= INT8_MIN && val <= INT8_MAX;
+        case c11_dtype_int32: return val >= INT32_MIN && val <= INT32_MAX;
+        default: return true;
+    }
+}
+
+// converts `value` to `dtype`, raises if it has a wrong type or is out of range
+static bool c11_dtype__pack(c11_dtype dtype, c11_dtype_value* out, py_Ref value) {
+    switch(dtype) {
+        case c11_dtype_bool: {
+            if(!py_checkbool(value)) return false;
+            out->_bool = py_tobool(value);
+            return true;
+        }
+        case c11_dtype_int8:
+        case c11_dtype_int32: {
+            if(!py_checkint(value)) return false;
+            py_i64 val = py_toint(value);
+            if(!c11_dtype__contains(dtype, val)) {
+                return ValueError("%i is out of range for dtype '%s'",
+                                  val,
+                                  c11_dtype__names[dtype]);
+            }
+            if(dtype == c11_dtype_int8) {
+                out->_int8 = (int8_t)val;
+            } else {
+                out->_int32 = (int32_t)val;
+            }
+            return true;
+        }
+        case c11_dtype_float32: return py_castfloat32(value, &out->_float32);
+        default: c11__unreachable();
+    }
+}
+
+// like `c11_dtype__pack` but only succeeds if `py_equal` would hold for the packed value
+// returns 1 if packed, 0 if no cell of `dtype` can equal `value`, -1 if `value` is not a number
+static int c11_dtype__pack_exact(c11_dtype dtype, c11_dtype_value* out, py_Ref value) {
+    if(dtype == c11_dtype_bool) {
+        if(!py_isbool(value)) return -1;
+        out->_bool = py_tobool(value);
+        return 1;
+    }
+    py_f64 f;
+    if(py_isint(value)) {
+        py_i64 val = py_toint(value);
+        if(dtype == c11_dtype_float32) {
+            f = (py_f64)val;
+        } else {
+            if(!c11_dtype__contains(dtype, val)) return 0;
+            if(dtype == c11_dtype_int8) {
+                out->_int8 = (int8_t)val;
+            } else {
+                out->_int32 = (int32_t)val;
+            }
+            return 1;
+        }
+    } else if(py_isfloat(value)) {
+        f = py_tofloat(value);
+        if(c11_dtype__is_int(dtype)) {
+            if(!(f >= INT32_MIN && f <= INT32_MAX) || f != (int32_t)f) return 0;
+            if(!c11_dtype__contains(dtype, (int32_t)f)) return 0;
+            if(dtype == c11_dtype_int8) {
+                out->_int8 = (int8_t)f;
+            } else {
+                out->_int32 = (int32_t)f;
+            }
+            return 1;
+        }
+    } else {
+        return -1;
+    }
+    out->_float32 = (float)f;
+    return (py_f64)out->_float32 == f;
+}
+
+static py_Ref c11_array2d_packed__item(c11_array2d_packed* self, int index) {
+    switch(self->dtype) {
+        case c11_dtype_bool: py_newbool(&self->item, ((bool*)self->data)[index]); break;
+        case c11_dtype_int8: py_newint(&self->item, ((int8_t*)self->data)[index]); break;
+        case c11_dtype_int32: py_newint(&self->item, ((int32_t*)self->data)[index]); break;
+        case c11_dtype_float32: py_newfloat(&self->item, ((float*)self->data)[index]); break;
+        default: c11__unreachable();
+    }
+    return &self->item;
+}
+
+static py_Ref c11_array2d_packed__get(c11_array2d_packed* self, int col, int row) {
+    return c11_array2d_packed__item(self, row * self->header.n_cols + col);
+}
+
+static bool c11_array2d_packed__set(c11_array2d_packed* self, int col, int row, py_Ref value) {
+    c11_dtype_value val;
+    if(!c11_dtype__pack(self->dtype, &val, value)) return false;
+    int index = row * self->header.n_cols + col;
+    if(self->itemsize == 1) {
+        ((uint8_t*)self->data)[index] = val._bits8;
+    } else {
+        ((uint32_t*)self->data)[index] = val._bits32;
+    }
+    return true;
+}
+
+// writes `val` to every cell, or to the cells where `mask` is true if it is not NULL
+static void
+    c11_array2d_packed__fill(c11_array2d_packed* self, const bool* mask, c11_dtype_value val) {
+    int numel = self->header.numel;
+    if(self->itemsize == 1) {
+        uint8_t* data = self->data;
+        if(mask == NULL) {
+            memset(data, val._bits8, numel);
+        } else {
+            for(int i = 0; i < numel; i++)
+                data[i] = mask[i] ? val._bits8 : data[i];
+        }
+    } else {
+        uint32_t* data = self->data;
+        for(int i = 0; i < numel; i++)
+            data[i] = (mask == NULL || mask[i]) ? val._bits32 : data[i];
+    }
+}
+
+c11_array2d_packed* py_newarray2d_packed(py_OutRef out, int n_cols, int n_rows, c11_dtype dtype) {
+    int numel = n_cols * n_rows;
+    int itemsize = c11_dtype__itemsizes[dtype];
+    c11_array2d_packed* ud =
+        py_newobject(out, tp_array2d_packed, 0, sizeof(c11_array2d_packed) + numel * itemsize);
+    ud->header.n_cols = n_cols;
+    ud->header.n_rows = n_rows;
+    ud->header.numel = numel;
+    ud->header.f_get = (py_Ref(*)(c11_array2d_like*, int, int))c11_array2d_packed__get;
+    ud->header.f_set = (bool (*)(c11_array2d_like*, int, int, py_Ref))c11_array2d_packed__set;
+    ud->dtype = dtype;
+    ud->itemsize = itemsize;
+    py_newnone(&ud->item);
+    ud->data = ud + 1;
+    memset(ud->data, 0, numel * itemsize);
+    return ud;
+}
+
+static bool _array2d_packed_is_mask(py_Ref val) {
+    if(!py_istype(val, tp_array2d_packed)) return false;
+    c11_array2d_packed* self = py_touserdata(val);
+    return self->dtype == c11_dtype_bool;
+}
+
+static py_i64 _array2d_packed_floordiv(py_i64 a, py_i64 b) {
+    py_i64 q = a / b;
+    if(a % b != 0 && (a < 0) != (b < 0)) q--;
+    return q;
+}
+
+static py_i64 _array2d_packed_mod(py_i64 a, py_i64 b) {
+    py_i64 r = a % b;
+    if(r != 0 && (r < 0) != (b < 0)) r += b;
+    return r;
+}
+
+// out[i] = expr(x=self[i], y=other[i] or the broadcasted scalar `s`)
+#define PACKED_ZIP(Tout, T, Ts, s, expr)                                                           \
+    do {                                                                                           \
+        Tout* out = res->data;                                                                     \
+        const T* a = self->data;                                                                   \
+        if(other != NULL) {                                                                        \
+            const T* b = other->data;                                                              \
+            for(int i = 0; i < numel; i++) {                                                       \
+                T x = a[i];                                                                        \
+                T y = b[i];                                                                        \
+                out[i] = (expr);                                                                   \
+            }                                                                                      \
+        } else {                                                                                   \
+            Ts y = (Ts)(s);                                                                        \
+            for(int i = 0; i < numel; i++) {                                                       \
+                T x = a[i];                                                                        \
+                out[i] = (expr);                                                                   \
+            }                                                                                      \
+        }                                                                                          \
+    } while(0)
+
+#define PACKED_COMPARE(T, Ts, s)                                                                   \
+    do {                                                                                           \
+        if(op == __lt__) {                                                                         \
+            PACKED_ZIP(bool, T, Ts, s, x < y);                                                     \
+        } else if(op == __le__) {                                                                  \
+            PACKED_ZIP(bool, T, Ts, s, x <= y);                                                    \
+        } else if(op == __gt__) {                                                                  \
+            PACKED_ZIP(bool, T, Ts, s, x > y);                                                     \
+        } else if(op == __ge__) {                                                                  \
+            PACKED_ZIP(bool, T, Ts, s, x >= y);                                                    \
+        } else if(op == __eq__) {                                                                  \
+            PACKED_ZIP(bool, T, Ts, s, x == y);                                                    \
+        } else {                                                                                   \
+            PACKED_ZIP(bool, T, Ts, s, x != y);                                                    \
+        }                                                                                          \
+    } while(0)
+
+#define PACKED_BITWISE(T)                                                                          \
+    do {                                                                                           \
+        if(op == __and__) {                                                                        \
+            PACKED_ZIP(T, T, T, si, x & y);                                                        \
+        } else if(op == __or__) {                                                                  \
+            PACKED_ZIP(T, T, T, si, x | y);                                                        \
+        } else {                                                                                   \
+            PACKED_ZIP(T, T, T, si, x ^ y);                                                        \
+        }                                                                                          \
+    } while(0)
+
+// integer arithmetic wraps around like C's fixed-width integers
+#define PACKED_INT_OPS(T)                                                                          \
+    do {                                                                                           \
+        if(is_compare) {                                                                           \
+            if(s_is_float) {                                                                       \
+                PACKED_COMPARE(T, py_f64, sf);                                                     \
+            } else {                                                                               \
+                PACKED_COMPARE(T, py_i64, si);                                                     \
+            }                                                                                      \
+        } else if(op == __add__) {                                                                 \
+            PACKED_ZIP(T, T, T, si, (T)((uint32_t)x + (uint32_t)y));                               \
+        } else if(op == __sub__) {                                                                 \
+            PACKED_ZIP(T, T, T, si, (T)((uint32_t)x - (uint32_t)y));                               \
+        } else if(op == __mul__) {                                                                 \
+            PACKED_ZIP(T, T, T, si, (T)((uint32_t)x * (uint32_t)y));                               \
+        } else if(op == __truediv__) {                                                             \
+            PACKED_ZIP(float, T, py_f64, sf, (float)((py_f64)x / y));                              \
+        } else if(op == __floordiv__) {                                                            \
+            PACKED_ZIP(T, T, py_i64, si, (T)_array2d_packed_floordiv(x, y));                       \
+        } else if(op == __mod__) {                                                                 \
+            PACKED_ZIP(T, T, py_i64, si, (T)_array2d_packed_mod(x, y));                            \
+        } else {                                                                                   \
+            PACKED_BITWISE(T);                                                                     \
+        }                                                                                          \
+    } while(0)
+
+// element-wise `self <op> rhs` without boxing, `rhs` has the same shape if it is an array
+// returns 1 on success, 0 if the generic path should be used and -1 on error
+static int c11_array2d_packed__zip_with(c11_array2d_packed* self, py_Ref rhs, py_Name op) {
+    c11_dtype dtype = self->dtype;
+    c11_array2d_packed* other = NULL;
+    bool s_is_float = false;
+    py_i64 si = 0;
+    py_f64 sf = 0;
+    if(py_istype(rhs, tp_array2d_packed)) {
+        other = py_touserdata(rhs);
+        if(other->dtype != dtype) return 0;
+    } else if(dtype == c11_dtype_bool) {
+        if(!py_isbool(rhs)) return 0;
+        si = py_tobool(rhs);
+    } else if(py_isint(rhs)) {
+        si = py_toint(rhs);
+        sf = (py_f64)si;
+    } else if(py_isfloat(rhs)) {
+        s_is_float = true;
+        sf = py_tofloat(rhs);
+    } else {
+        return 0;
+    }
+
+    int numel = self->header.numel;
+    bool is_compare = op == __lt__ || op == __le__ || op == __gt__ || op == __ge__ ||
+                      op == __eq__ || op == __ne__;
+    c11_dtype res_dtype = dtype;
+    if(is_compare) {
+        res_dtype = c11_dtype_bool;
+    } else if(op == __add__ || op == __sub__ || op == __mul__) {
+        if(dtype == c11_dtype_bool) return 0;
+        if(c11_dtype__is_int(dtype) && s_is_float) return 0;
+    } else if(op == __truediv__) {
+        if(dtype == c11_dtype_bool) return 0;
+        res_dtype = c11_dtype_float32;
+    } else if(op == __floordiv__ || op == __mod__) {
+        if(!c11_dtype__is_int(dtype) || s_is_float) return 0;
+        bool has_zero = false;
+        if(other == NULL) {
+            has_zero = si == 0;
+        } else if(dtype == c11_dtype_int8) {
+            has_zero = memchr(other->data, 0, numel) != NULL;
+        } else {
+            const int32_t* b = other->data;
+            for(int i = 0; i < numel; i++)
+                has_zero |= b[i] == 0;
+        }
+        if(has_zero) {
+            ZeroDivisionError("integer division or modulo by zero");
+            return -1;
+        }
+    } else if(op == __and__ || op == __or__ || op == __xor__) {
+        if(dtype == c11_dtype_float32 || s_is_float) return 0;
+    } else {
+        return 0;
+    }
+
+    c11_array2d_packed* res =
+        py_newarray2d_packed(py_pushtmp(), self->header.n_cols, self->header.n_rows, res_dtype);
+    switch(dtype) {
+        case c11_dtype_bool: {
+            if(is_compare) {
+                PACKED_COMPARE(bool, bool, si);
+            } else {
+                PACKED_BITWISE(bool);
+            }
+            break;
+        }
+        case c11_dtype_int8: PACKED_INT_OPS(int8_t); break;
+        case c11_dtype_int32: PACKED_INT_OPS(int32_t); break;
+        case c11_dtype_float32: {
+            if(is_compare) {
+                PACKED_COMPARE(float, py_f64, sf);
+            } else if(op == __add__) {
+                PACKED_ZIP(float, float, float, sf, x + y);
+            } else if(op == __sub__) {
+                PACKED_ZIP(float, float, float, sf, x - y);
+            } else if(op == __mul__) {
+                PACKED_ZIP(float, float, float, sf, x * y);
+            } else {
+                PACKED_ZIP(float, float, float, sf, x / y);
+            }
+            break;
+        }
+        default: c11__unreachable();
+    }
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return 1;
+}
+
+#undef PACKED_ZIP
+#undef PACKED_COMPARE
+#undef PACKED_BITWISE
+#undef PACKED_INT_OPS
+
+static bool c11_array2d_packed__invert(c11_array2d_packed* self) {
+    int numel = self->header.numel;
+    c11_array2d_packed* res =
+        py_newarray2d_packed(py_pushtmp(), self->header.n_cols, self->header.n_rows, self->dtype);
+    switch(self->dtype) {
+        case c11_dtype_bool: {
+            const bool* a = self->data;
+            bool* out = res->data;
+            for(int i = 0; i < numel; i++)
+                out[i] = !a[i];
+            break;
+        }
+        case c11_dtype_int8: {
+            const int8_t* a = self->data;
+            int8_t* out = res->data;
+            for(int i = 0; i < numel; i++)
+                out[i] = ~a[i];
+            break;
+        }
+        case c11_dtype_int32: {
+            const int32_t* a = self->data;
+            int32_t* out = res->data;
+            for(int i = 0; i < numel; i++)
+                out[i] = ~a[i];
+            break;
+        }
+        default: c11__unreachable();
+    }
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return true;
+}
+
+#define PACKED_COUNT(T, v)                                                                         \
+    do {                                                                                           \
+        const T* a = self->data;                                                                   \
+        for(int i = 0; i < self->header.numel; i++)                                                \
+            count += a[i] == v;                                                                    \
+    } while(0)
+
+// returns the number of cells equal to `value`, or -1 if `value` is not a number
+static int c11_array2d_packed__count(c11_array2d_packed* self, py_Ref value) {
+    c11_dtype_value val;
+    int code = c11_dtype__pack_exact(self->dtype, &val, value);
+    if(code != 1) return code;
+    int count = 0;
+    switch(self->dtype) {
+        case c11_dtype_bool: PACKED_COUNT(bool, val._bool); break;
+        case c11_dtype_int8: PACKED_COUNT(int8_t, val._int8); break;
+        case c11_dtype_int32: PACKED_COUNT(int32_t, val._int32); break;
+        case c11_dtype_float32: PACKED_COUNT(float, val._float32); break;
+        default: c11__unreachable();
+    }
+    return count;
+}
+
+#undef PACKED_COUNT
+
+#define PACKED_BOUNDING_RECT(T, v)                                                                 \
+    do {                                                                                           \
+        for(int j = 0; j < n_rows; j++) {                                                          \
+            const T* row = (const T*)self->data + j * n_cols;                                      \
+            int i = 0;                                                                             \
+            while(i < n_cols && row[i] != v)                                                       \
+                i++;                                                                               \
+            if(i == n_cols) continue;                                                              \
+            int k = n_cols - 1;                                                                    \
+            while(row[k] != v)                                                                     \
+                k--;                                                                               \
+            rect[0] = c11__min(rect[0], i);                                                        \
+            rect[1] = c11__min(rect[1], j);                                                        \
+            rect[2] = c11__max(rect[2], k);                                                        \
+            rect[3] = j;                                                                           \
+        }                                                                                          \
+    } while(0)
+
+// finds `[left, top, right, bottom]` of the cells equal to `value`
+// returns false if `value` is not a number, `rect` is left untouched if it is not found
+static bool c11_array2d_packed__bounding_rect(c11_array2d_packed* self, py_Ref value, int* rect) {
+    c11_dtype_value val;
+    int code = c11_dtype__pack_exact(self->dtype, &val, value);
+    if(code == -1) return false;
+    if(code == 0) return true;
+    int n_cols = self->header.n_cols;
+    int n_rows = self->header.n_rows;
+    switch(self->dtype) {
+        case c11_dtype_bool: PACKED_BOUNDING_RECT(bool, val._bool); break;
+        case c11_dtype_int8: PACKED_BOUNDING_RECT(int8_t, val._int8); break;
+        case c11_dtype_int32: PACKED_BOUNDING_RECT(int32_t, val._int32); break;
+        case c11_dtype_float32: PACKED_BOUNDING_RECT(float, val._float32); break;
+        default: c11__unreachable();
+    }
+    return true;
+}
+
+#undef PACKED_BOUNDING_RECT
+
 /* array2d_like bindings */
 static bool array2d_like_n_cols(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
@@ -122,6 +580,10 @@ static bool array2d_like_render(int argc, py_Ref argv) {
 static bool array2d_like_all(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
+    if(_array2d_packed_is_mask(argv)) {
+        py_newbool(py_retval(), memchr(((c11_array2d_packed*)self)->data, 0, self->numel) == NULL);
+        return true;
+    }
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
             py_Ref item = self->f_get(self, i, j);
@@ -139,6 +601,10 @@ static bool array2d_like_all(int argc, py_Ref argv) {
 static bool array2d_like_any(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
+    if(_array2d_packed_is_mask(argv)) {
+        py_newbool(py_retval(), memchr(((c11_array2d_packed*)self)->data, 1, self->numel) != NULL);
+        return true;
+    }
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
             py_Ref item = self->f_get(self, i, j);
@@ -210,17 +676,22 @@ static bool _array2d_like_broadcasted_zip_with(int argc, py_Ref argv, py_Name op
     } else {
         other = NULL;
     }
+    if(py_istype(argv, tp_array2d_packed)) {
+        int code = c11_array2d_packed__zip_with(py_touserdata(argv), py_arg(1), op);
+        if(code != 0) return code == 1;
+    }
     c11_array2d* res = py_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
-            py_Ref lhs = self->f_get(self, i, j);
+            // copied since a packed array reuses the same slot for every cell
+            py_TValue lhs = *self->f_get(self, i, j);
             py_Ref rhs;
             if(other != NULL) {
                 rhs = other->f_get(other, i, j);
             } else {
                 rhs = py_arg(1);  // broadcast
             }
-            if(!py_binaryop(lhs, rhs, op, rop)) return false;
+            if(!py_binaryop(&lhs, rhs, op, rop)) return false;
             c11_array2d__set(res, i, j, py_retval());
         }
     }
@@ -281,6 +752,10 @@ DEF_ARRAY2D_LIKE__MAGIC_ZIP_WITH(__xor__, __xor__, 0)
 static bool array2d_like__invert__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_array2d_like* self = py_touserdata(argv);
+    if(py_istype(argv, tp_array2d_packed)) {
+        c11_array2d_packed* packed = py_touserdata(argv);
+        if(packed->dtype != c11_dtype_float32) return c11_array2d_packed__invert(packed);
+    }
     c11_array2d* res = py_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
@@ -442,12 +917,19 @@ static bool array2d_like__getitem__(int argc, py_Ref argv) {
         c11_array2d_like* mask = py_touserdata(&argv[1]);
         if(!_array2d_like_check_same_shape(self, mask)) return false;
         py_newlist(py_retval());
+        if(py_istype(argv, tp_array2d_packed) && _array2d_packed_is_mask(&argv[1])) {
+            const bool* cond = ((c11_array2d_packed*)mask)->data;
+            for(int i = 0; i < self->numel; i++) {
+                if(!cond[i]) continue;
+                py_list_append(py_retval(), c11_array2d_packed__item(py_touserdata(argv), i));
+            }
+            return true;
+        }
         for(int j = 0; j < self->n_rows; j++) {
             for(int i = 0; i < self->n_cols; i++) {
-                py_Ref item = self->f_get(self, i, j);
                 py_Ref cond = mask->f_get(mask, i, j);
                 if(!py_checkbool(cond)) return false;
-                if(py_tobool(cond)) py_list_append(py_retval(), item);
+                if(py_tobool(cond)) py_list_append(py_retval(), self->f_get(self, i, j));
             }
         }
         return true;
@@ -502,6 +984,14 @@ static bool array2d_like__setitem__(int argc, py_Ref argv) {
     if(py_isinstance(&argv[1], tp_array2d_like)) {
         c11_array2d_like* mask = py_touserdata(&argv[1]);
         if(!_array2d_like_check_same_shape(self, mask)) return false;
+        if(py_istype(argv, tp_array2d_packed) && _array2d_packed_is_mask(&argv[1])) {
+            c11_array2d_packed* packed = py_touserdata(argv);
+            c11_dtype_value val;
+            if(!c11_dtype__pack(packed->dtype, &val, value)) return false;
+            c11_array2d_packed__fill(packed, ((c11_array2d_packed*)mask)->data, val);
+            py_newnone(py_retval());
+            return true;
+        }
         for(int j = 0; j < self->n_rows; j++) {
             for(int i = 0; i < self->n_cols; i++) {
                 py_Ref cond = mask->f_get(mask, i, j);
@@ -567,6 +1057,13 @@ static bool array2d_like__setitem__(int argc, py_Ref argv) {
 static bool array2d_like_count(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     c11_array2d_like* self = py_touserdata(argv);
+    if(py_istype(argv, tp_array2d_packed)) {
+        int count = c11_array2d_packed__count(py_touserdata(argv), py_arg(1));
+        if(count != -1) {
+            py_newint(py_retval(), count);
+            return true;
+        }
+    }
     int count = 0;
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
@@ -584,25 +1081,27 @@ static bool array2d_like_get_bounding_rect(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     c11_array2d_like* self = py_touserdata(argv);
     py_Ref value = py_arg(1);
-    int left = self->n_cols;
-    int top = self->n_rows;
-    int right = 0;
-    int bottom = 0;
-    for(int j = 0; j < self->n_rows; j++) {
-        for(int i = 0; i < self->n_cols; i++) {
-            py_Ref item = self->f_get(self, i, j);
-            int res = py_equal(item, value);
-            if(res == -1) return false;
-            if(res == 1) {
-                left = c11__min(left, i);
-                top = c11__min(top, j);
-                right = c11__max(right, i);
-                bottom = c11__max(bottom, j);
+    int rect[4] = {self->n_cols, self->n_rows, 0, 0};
+    if(!py_istype(argv, tp_array2d_packed) ||
+       !c11_array2d_packed__bounding_rect(py_touserdata(argv), value, rect)) {
+        for(int j = 0; j < self->n_rows; j++) {
+            for(int i = 0; i < self->n_cols; i++) {
+                py_Ref item = self->f_get(self, i, j);
+                int res = py_equal(item, value);
+                if(res == -1) return false;
+                if(res == 1) {
+                    rect[0] = c11__min(rect[0], i);
+                    rect[1] = c11__min(rect[1], j);
+                    rect[2] = c11__max(rect[2], i);
+                    rect[3] = c11__max(rect[3], j);
+                }
             }
         }
     }
-    int width = right - left + 1;
-    int height = bottom - top + 1;
+    int left = rect[0];
+    int top = rect[1];
+    int width = rect[2] - left + 1;
+    int height = rect[3] - top + 1;
     if(width <= 0 || height <= 0) {
         return ValueError("value not found");
     } else {
@@ -615,106 +1114,646 @@ static bool array2d_like_get_bounding_rect(int argc, py_Ref argv) {
     return true;
 }
 
+static int _array2d_like_cell_equal(c11_array2d_like* self, int col, int row, py_Ref value) {
+    py_Ref item = self->f_get(self, col, row);
+    if(py_isint(item) && py_isint(value)) return py_toint(item) == py_toint(value);
+    return py_equal(item, value);
+}
+
+// writes `self[i, j] == value` of every cell to `out`
+static bool _array2d_like_equal_mask(py_Ref self_ref, py_Ref value, bool* out) {
+    c11_array2d_like* self = py_touserdata(self_ref);
+    if(py_istype(self_ref, tp_array2d_packed)) {
+        int code = c11_array2d_packed__zip_with(py_touserdata(self_ref), value, __eq__);
+        if(code == -1) return false;
+        if(code == 1) {
+            c11_array2d_packed* res = py_touserdata(py_retval());
+            memcpy(out, res->data, self->numel);
+            return true;
+        }
+    }
+    for(int j = 0; j < self->n_rows; j++) {
+        for(int i = 0; i < self->n_cols; i++) {
+            int code = _array2d_like_cell_equal(self, i, j, value);
+            if(code == -1) return false;
+            out[j * self->n_cols + i] = code;
+        }
+    }
+    return true;
+}
+
+static const c11_vec2i Moore[] = {
+    {{-1, -1}},
+    {{0, -1}},
+    {{1, -1}},
+    {{-1, 0}},
+    {{1, 0}},
+    {{-1, 1}},
+    {{0, 1}},
+    {{1, 1}},
+};
+
+static const c11_vec2i von_Neumann[] = {
+    {{0, -1}},
+    {{-1, 0}},
+    {{1, 0}},
+    {{0, 1}},
+};
+
+static bool _array2d_like_neighborhood(py_Ref name, const c11_vec2i** offsets, int* n_offsets) {
+    // the outputs are always written, so callers need not initialize them
+    *offsets = NULL;
+    *n_offsets = 0;
+    if(!py_checkstr(name)) return false;
+    const char* neighborhood = py_tostr(name);
+    if(strcmp(neighborhood, "Moore") == 0) {
+        *offsets = Moore;
+        *n_offsets = c11__count_array(Moore);
+    } else if(strcmp(neighborhood, "von Neumann") == 0) {
+        *offsets = von_Neumann;
+        *n_offsets = c11__count_array(von_Neumann);
+    } else {
+        return ValueError("neighborhood must be 'Moore' or 'von Neumann'");
+    }
+    return true;
+}
+
 // count_neighbors(self, value: T, neighborhood: Neighborhood) -> array2d[int]
 static bool array2d_like_count_neighbors(int argc, py_Ref argv) {
     PY_CHECK_ARGC(3);
     c11_array2d_like* self = py_touserdata(argv);
-    c11_array2d* res = py_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
     py_Ref value = py_arg(1);
-    const char* neighborhood = py_tostr(py_arg(2));
-
-    const static c11_vec2i Moore[] = {
-        {{-1, -1}},
-        {{0, -1}},
-        {{1, -1}},
-        {{-1, 0}},
-        {{1, 0}},
-        {{-1, 1}},
-        {{0, 1}},
-        {{1, 1}},
-    };
-
-    const static c11_vec2i von_Neumann[] = {
-        {{0, -1}},
-        {{-1, 0}},
-        {{1, 0}},
-        {{0, 1}},
-    };
-
     const c11_vec2i* offsets;
     int n_offsets;
-    if(strcmp(neighborhood, "Moore") == 0) {
-        offsets = Moore;
-        n_offsets = c11__count_array(Moore);
-    } else if(strcmp(neighborhood, "von Neumann") == 0) {
-        offsets = von_Neumann;
-        n_offsets = c11__count_array(von_Neumann);
-    } else {
-        return ValueError("neighborhood must be 'Moore' or 'von Neumann'");
+    if(!_array2d_like_neighborhood(py_arg(2), &offsets, &n_offsets)) return false;
+    int n_cols = self->n_cols;
+    int n_rows = self->n_rows;
+    // pad the mask by one cell so that every neighbor can be read without bounds checks
+    int stride = n_cols + 2;
+    uint8_t* padded = PK_MALLOC(stride * (n_rows + 2));
+    bool* mask = PK_MALLOC(self->numel);
+    if(!_array2d_like_equal_mask(argv, value, mask)) {
+        PK_FREE(mask);
+        PK_FREE(padded);
+        return false;
     }
-    for(int j = 0; j < self->n_rows; j++) {
-        for(int i = 0; i < self->n_cols; i++) {
-            py_i64 count = 0;
-            for(int k = 0; k < n_offsets; k++) {
-                int x = i + offsets[k].x;
-                int y = j + offsets[k].y;
-                if(x >= 0 && x < self->n_cols && y >= 0 && y < self->n_rows) {
-                    py_Ref item = self->f_get(self, x, y);
-                    int code = py_equal(item, value);
-                    if(code == -1) return false;
-                    count += code;
-                }
-            }
-            py_newint(c11_array2d__get(res, i, j), count);
+    memset(padded, 0, stride * (n_rows + 2));
+    for(int j = 0; j < n_rows; j++) {
+        memcpy(padded + (j + 1) * stride + 1, mask + j * n_cols, n_cols);
+    }
+    c11_array2d* res = py_newarray2d(py_pushtmp(), n_cols, n_rows);
+    uint8_t* counts = PK_MALLOC(n_cols);
+    for(int j = 0; j < n_rows; j++) {
+        memset(counts, 0, n_cols);
+        for(int k = 0; k < n_offsets; k++) {
+            const uint8_t* p = padded + (j + 1 + offsets[k].y) * stride + 1 + offsets[k].x;
+            for(int i = 0; i < n_cols; i++)
+                counts[i] += p[i];
+        }
+        for(int i = 0; i < n_cols; i++) {
+            py_newint(c11_array2d__get(res, i, j), counts[i]);
         }
     }
+    PK_FREE(counts);
+    PK_FREE(mask);
+    PK_FREE(padded);
     py_assign(py_retval(), py_peek(-1));
     py_pop();
     return true;
 }
 
-// convolve(self: array2d_like[int], kernel: array2d_like[int], padding: int) -> array2d[int]
+// checks that `item` is a number, and tracks whether the convolution needs floats
+static bool _convolve_scan(py_Ref item, bool* is_float, py_f64* max_abs) {
+    py_f64 val;
+    if(py_isint(item)) {
+        val = (py_f64)py_toint(item);
+    } else if(py_isfloat(item)) {
+        val = py_tofloat(item);
+        *is_float = true;
+    } else {
+        return TypeError("expected 'int' or 'float', got '%t'", item->type);
+    }
+    *max_abs = c11__max(*max_abs, fabs(val));
+    return true;
+}
+
+// `self` is copied into a buffer padded by `ksize / 2` cells on each side, so the kernel never
+// reads out of bounds. Each kernel tap is then accumulated over a whole row at once, which the
+// compiler vectorizes. A separable kernel `K[j][i] == K[j][px] * K[py][i] / K[py][px]` is applied
+// as a horizontal and a vertical 1D pass, `pivot` is `py * ksize + px` or -1 if not separable.
+#define DEF_CONVOLVE(T, name, py_newT)                                                             \
+    static void _convolve_##name(c11_array2d_like* self,                                           \
+                                 c11_array2d* res,                                                 \
+                                 const T* kernel,                                                  \
+                                 int ksize,                                                        \
+                                 int pivot,                                                        \
+                                 T padding) {                                                      \
+        int n_cols = self->n_cols;                                                                 \
+        int n_rows = self->n_rows;                                                                 \
+        int r = ksize / 2;                                                                         \
+        int stride = n_cols + 2 * r;                                                               \
+        int n_padded = stride * (n_rows + 2 * r);                                                  \
+        T* src = PK_MALLOC(sizeof(T) * n_padded);                                                  \
+        for(int i = 0; i < n_padded; i++)                                                          \
+            src[i] = padding;                                                                      \
+        for(int j = 0; j < n_rows; j++) {                                                          \
+            T* row = src + (j + r) * stride + r;                                                   \
+            for(int i = 0; i < n_cols; i++) {                                                      \
+                py_Ref item = self->f_get(self, i, j);                                             \
+                row[i] = py_isint(item) ? (T)py_toint(item) : (T)py_tofloat(item);                 \
+            }                                                                                      \
+        }                                                                                          \
+        T* out = PK_MALLOC(sizeof(T) * self->numel);                                               \
+        memset(out, 0, sizeof(T) * self->numel);                                                   \
+        if(pivot >= 0) {                                                                           \
+            int px = pivot % ksize;                                                                \
+            int py = pivot / ksize;                                                                \
+            int n_tmp = n_cols * (n_rows + 2 * r);                                                 \
+            T* tmp = PK_MALLOC(sizeof(T) * n_tmp);                                                 \
+            memset(tmp, 0, sizeof(T) * n_tmp);                                                     \
+            for(int y = 0; y < n_rows + 2 * r; y++) {                                              \
+                T* t = tmp + y * n_cols;                                                           \
+                for(int ii = 0; ii < ksize; ii++) {                                                \
+                    T w = kernel[py * ksize + ii];                                                 \
+                    const T* s = src + y * stride + ii;                                            \
+                    for(int i = 0; i < n_cols; i++)                                                \
+                        t[i] += w * s[i];                                                          \
+                }                                                                                  \
+            }                                                                                      \
+            for(int j = 0; j < n_rows; j++) {                                                      \
+                T* o = out + j * n_cols;                                                           \
+                for(int jj = 0; jj < ksize; jj++) {                                                \
+                    T w = kernel[jj * ksize + px];                                                 \
+                    const T* t = tmp + (j + jj) * n_cols;                                          \
+                    for(int i = 0; i < n_cols; i++)                                                \
+                        o[i] += w * t[i];                                                          \
+                }                                                                                  \
+            }                                                                                      \
+            T pv = kernel[pivot];                                                                  \
+            for(int i = 0; i < self->numel; i++)                                                   \
+                out[i] /= pv;                                                                      \
+            PK_FREE(tmp);                                                                          \
+        } else {                                                                                   \
+            for(int j = 0; j < n_rows; j++) {                                                      \
+                T* o = out + j * n_cols;                                                           \
+                for(int jj = 0; jj < ksize; jj++) {                                                \
+                    for(int ii = 0; ii < ksize; ii++) {                                            \
+                        T w = kernel[jj * ksize + ii];                                             \
+                        if(w == 0) continue;                                                       \
+                        const T* s = src + (j + jj) * stride + ii;                                 \
+                        for(int i = 0; i < n_cols; i++)                                            \
+                            o[i] += w * s[i];                                                      \
+                    }                                                                              \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+        for(int i = 0; i < self->numel; i++)                                                       \
+            py_newT(&res->data[i], out[i]);                                                        \
+        PK_FREE(out);                                                                              \
+        PK_FREE(src);                                                                              \
+    }
+
+DEF_CONVOLVE(int32_t, i32, py_newint)
+DEF_CONVOLVE(py_i64, i64, py_newint)
+DEF_CONVOLVE(py_f64, f64, py_newfloat)
+
+#undef DEF_CONVOLVE
+
+// convolve(self: array2d_like[int | float], kernel: array2d_like[int | float], padding: int | float) -> array2d[int | float]
 static bool array2d_like_convolve(int argc, py_Ref argv) {
     PY_CHECK_ARGC(3);
     if(!py_checkinstance(&argv[1], tp_array2d_like)) return false;
-    PY_CHECK_ARG_TYPE(2, tp_int);
     c11_array2d_like* self = py_touserdata(&argv[0]);
     c11_array2d_like* kernel = py_touserdata(&argv[1]);
-    int padding = py_toint(py_arg(2));
+    py_Ref padding = py_arg(2);
     if(kernel->n_cols != kernel->n_rows) return ValueError("kernel must be square");
     int ksize = kernel->n_cols;
     if(ksize % 2 == 0) return ValueError("kernel size must be odd");
-    int ksize_half = ksize / 2;
-    c11_array2d* res = py_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
+
+    // validate the cells once, the result is float if any input is float
+    bool is_float = false;
+    py_f64 max_abs = 0;
+    if(!_convolve_scan(padding, &is_float, &max_abs)) return false;
     for(int j = 0; j < self->n_rows; j++) {
         for(int i = 0; i < self->n_cols; i++) {
-            py_i64 sum = 0;
-            for(int jj = 0; jj < ksize; jj++) {
-                for(int ii = 0; ii < ksize; ii++) {
-                    int x = i + ii - ksize_half;
-                    int y = j + jj - ksize_half;
-                    py_i64 _0, _1;
-                    if(x < 0 || x >= self->n_cols || y < 0 || y >= self->n_rows) {
-                        _0 = padding;
-                    } else {
-                        py_Ref item = self->f_get(self, x, y);
-                        if(!py_checkint(item)) return false;
-                        _0 = py_toint(item);
-                    }
-                    py_Ref kitem = kernel->f_get(kernel, ii, jj);
-                    if(!py_checkint(kitem)) return false;
-                    _1 = py_toint(kitem);
-                    sum += _0 * _1;
+            if(!_convolve_scan(self->f_get(self, i, j), &is_float, &max_abs)) return false;
+        }
+    }
+    int knumel = kernel->numel;
+    py_f64* kf = PK_MALLOC(sizeof(py_f64) * knumel);
+    py_i64* ki = PK_MALLOC(sizeof(py_i64) * knumel);
+    py_f64 k_max_abs = 0;
+    py_f64 k_sum_abs = 0;
+    bool ok = true;
+    for(int index = 0; ok && index < knumel; index++) {
+        py_Ref item = kernel->f_get(kernel, index % ksize, index / ksize);
+        ok = _convolve_scan(item, &is_float, &k_max_abs);
+        if(!ok) break;
+        ki[index] = py_isint(item) ? py_toint(item) : 0;
+        kf[index] = py_isint(item) ? (py_f64)ki[index] : py_tofloat(item);
+        k_sum_abs += fabs(kf[index]);
+    }
+    if(!ok) {
+        PK_FREE(ki);
+        PK_FREE(kf);
+        return false;
+    }
+
+    // a rank-1 kernel is separable, integer kernels are only tested if the products fit
+    int pivot = -1;
+    if(ksize > 1 && (is_float || k_max_abs <= INT32_MAX)) {
+        for(int index = 0; index < knumel; index++) {
+            if(kf[index] != 0) {
+                pivot = index;
+                break;
+            }
+        }
+        int px = pivot % ksize;
+        int py = pivot / ksize;
+        for(int index = 0; pivot >= 0 && index < knumel; index++) {
+            int ii = index % ksize;
+            int jj = index / ksize;
+            bool rank1;
+            if(is_float) {
+                rank1 = kf[index] * kf[pivot] == kf[jj * ksize + px] * kf[py * ksize + ii];
+            } else {
+                rank1 = ki[index] * ki[pivot] == ki[jj * ksize + px] * ki[py * ksize + ii];
+            }
+            if(!rank1) pivot = -1;
+        }
+    }
+
+    // the separable pass scales sums by the pivot, fall back if that could overflow
+    if(!is_float && pivot >= 0 && max_abs * k_sum_abs * fabs(kf[pivot]) > 0x1p62) pivot = -1;
+
+    c11_array2d* res = py_newarray2d(py_pushtmp(), self->n_cols, self->n_rows);
+    if(is_float) {
+        py_f64 pad = py_isint(padding) ? (py_f64)py_toint(padding) : py_tofloat(padding);
+        _convolve_f64(self, res, kf, ksize, pivot, pad);
+    } else {
+        // use 32-bit lanes if no intermediate sum can overflow
+        py_f64 bound = max_abs * k_sum_abs * (pivot >= 0 ? fabs(kf[pivot]) : 1);
+        if(bound <= INT32_MAX) {
+            int32_t* k32 = PK_MALLOC(sizeof(int32_t) * knumel);
+            for(int index = 0; index < knumel; index++)
+                k32[index] = (int32_t)ki[index];
+            _convolve_i32(self, res, k32, ksize, pivot, (int32_t)py_toint(padding));
+            PK_FREE(k32);
+        } else {
+            _convolve_i64(self, res, ki, ksize, pivot, py_toint(padding));
+        }
+    }
+    PK_FREE(ki);
+    PK_FREE(kf);
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return true;
+}
+
+static bool _array2d_like_check_pos(c11_array2d_like* self, py_Ref arg, int* index) {
+    *index = -1;
+    if(!py_checktype(arg, tp_vec2i)) return false;
+    c11_vec2i pos = py_tovec2i(arg);
+    if(!c11_array2d_like_is_valid(self, pos.x, pos.y)) {
+        return _array2d_like_IndexError(self, pos.x, pos.y);
+    }
+    *index = pos.y * self->n_cols + pos.x;
+    return true;
+}
+
+static int _union_find_root(int* parent, int x) {
+    while(parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+// get_connected_components(self, value: T, neighborhood: Neighborhood) -> tuple[array2d[int], int]
+static bool array2d_like_get_connected_components(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    c11_array2d_like* self = py_touserdata(argv);
+    const c11_vec2i* offsets;
+    int n_offsets;
+    if(!_array2d_like_neighborhood(py_arg(2), &offsets, &n_offsets)) return false;
+    int n_cols = self->n_cols;
+    int numel = self->numel;
+    bool* mask = PK_MALLOC(numel);
+    if(!_array2d_like_equal_mask(argv, py_arg(1), mask)) {
+        PK_FREE(mask);
+        return false;
+    }
+    // first pass: give each cell a provisional label and record which labels are connected
+    int* labels = PK_MALLOC(sizeof(int) * numel);
+    c11_vector parent;
+    c11_vector__ctor(&parent, sizeof(int));
+    c11_vector__push(int, &parent, 0);  // label 0 means the value is absent
+    for(int index = 0; index < numel; index++) {
+        int label = 0;
+        if(mask[index]) {
+            int i = index % n_cols;
+            int j = index / n_cols;
+            for(int k = 0; k < n_offsets; k++) {
+                c11_vec2i d = offsets[k];
+                // only the neighbors that were scanned before
+                if(d.y > 0 || (d.y == 0 && d.x > 0)) continue;
+                int x = i + d.x;
+                int y = j + d.y;
+                if(x < 0 || x >= n_cols || y < 0) continue;
+                int other = labels[y * n_cols + x];
+                if(other == 0) continue;
+                if(label == 0) {
+                    label = other;
+                } else {
+                    int a = _union_find_root(parent.data, label);
+                    int b = _union_find_root(parent.data, other);
+                    c11__setitem(int, &parent, c11__max(a, b), c11__min(a, b));
                 }
             }
-            py_newint(c11_array2d__get(res, i, j), sum);
+            if(label == 0) {
+                label = parent.length;
+                c11_vector__push(int, &parent, label);
+            }
         }
+        labels[index] = label;
     }
+    // second pass: number the components in scanning order
+    int* ids = PK_MALLOC(sizeof(int) * parent.length);
+    memset(ids, 0, sizeof(int) * parent.length);
+    int count = 0;
+    c11_array2d* res = py_newarray2d(py_pushtmp(), n_cols, self->n_rows);
+    for(int index = 0; index < numel; index++) {
+        int id = 0;
+        if(labels[index] != 0) {
+            int root = _union_find_root(parent.data, labels[index]);
+            if(ids[root] == 0) ids[root] = ++count;
+            id = ids[root];
+        }
+        py_newint(&res->data[index], id);
+    }
+    PK_FREE(ids);
+    PK_FREE(labels);
+    PK_FREE(mask);
+    c11_vector__dtor(&parent);
+    py_TValue* p = py_newtuple(py_retval(), 2);
+    p[0] = *py_peek(-1);
+    py_newint(&p[1], count);
+    py_pop();
+    return true;
+}
+
+// flood_fill(self, pos: vec2i, value: T, neighborhood: Neighborhood = 'von Neumann') -> int
+static bool array2d_like_flood_fill(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(4);
+    c11_array2d_like* self = py_touserdata(argv);
+    int start;
+    if(!_array2d_like_check_pos(self, py_arg(1), &start)) return false;
+    py_Ref value = py_arg(2);
+    const c11_vec2i* offsets;
+    int n_offsets;
+    if(!_array2d_like_neighborhood(py_arg(3), &offsets, &n_offsets)) return false;
+    int n_cols = self->n_cols;
+    // keep the replaced value alive
+    py_Ref target = py_pushtmp();
+    py_assign(target, self->f_get(self, start % n_cols, start / n_cols));
+    int code = py_equal(target, value);
+    if(code == -1) return false;
+    if(code == 1) {
+        py_pop();
+        py_newint(py_retval(), 0);
+        return true;
+    }
+    bool* visited = PK_MALLOC(self->numel);
+    memset(visited, 0, self->numel);
+    int* queue = PK_MALLOC(sizeof(int) * self->numel);
+    int head = 0, tail = 0;
+    queue[tail++] = start;
+    visited[start] = true;
+    bool ok = true;
+    while(ok && head < tail) {
+        int i = queue[head] % n_cols;
+        int j = queue[head] / n_cols;
+        head++;
+        ok = self->f_set(self, i, j, value);
+        for(int k = 0; ok && k < n_offsets; k++) {
+            int x = i + offsets[k].x;
+            int y = j + offsets[k].y;
+            if(!c11_array2d_like_is_valid(self, x, y)) continue;
+            int index = y * n_cols + x;
+            if(visited[index]) continue;
+            code = _array2d_like_cell_equal(self, x, y, target);
+            if(code == -1) {
+                ok = false;
+            } else if(code == 1) {
+                visited[index] = true;
+                queue[tail++] = index;
+            }
+        }
+    }
+    PK_FREE(queue);
+    PK_FREE(visited);
+    if(!ok) return false;
+    py_pop();
+    py_newint(py_retval(), tail);
+    return true;
+}
+
+// get_distance_field(self, sources: vec2i | list[vec2i], value: T, neighborhood: Neighborhood = 'von Neumann') -> array2d_packed[int]
+static bool array2d_like_get_distance_field(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(4);
+    c11_array2d_like* self = py_touserdata(argv);
+    py_TValue* sources = py_arg(1);
+    int n_sources = 1;
+    if(!py_istype(sources, tp_vec2i)) {
+        n_sources = pk_arrayview(sources, &sources);
+        if(n_sources == -1) return TypeError("sources must be a vec2i or a list of vec2i");
+    }
+    const c11_vec2i* offsets;
+    int n_offsets;
+    if(!_array2d_like_neighborhood(py_arg(3), &offsets, &n_offsets)) return false;
+    int n_cols = self->n_cols;
+    int numel = self->numel;
+    bool* passable = PK_MALLOC(numel);
+    int* queue = PK_MALLOC(sizeof(int) * numel);
+    bool ok = _array2d_like_equal_mask(argv, py_arg(2), passable);
+    c11_array2d_packed* res =
+        py_newarray2d_packed(py_pushtmp(), n_cols, self->n_rows, c11_dtype_int32);
+    int32_t* dist = res->data;
+    c11_array2d_packed__fill(res, NULL, (c11_dtype_value){._int32 = -1});
+    int head = 0, tail = 0;
+    for(int k = 0; ok && k < n_sources; k++) {
+        int index;
+        ok = _array2d_like_check_pos(self, &sources[k], &index);
+        if(ok && dist[index] == -1) {
+            dist[index] = 0;
+            queue[tail++] = index;
+        }
+    }
+    // unit-cost BFS, every cell is enqueued at most once
+    while(ok && head < tail) {
+        int index = queue[head++];
+        int i = index % n_cols;
+        int j = index / n_cols;
+        for(int k = 0; k < n_offsets; k++) {
+            int x = i + offsets[k].x;
+            int y = j + offsets[k].y;
+            if(!c11_array2d_like_is_valid(self, x, y)) continue;
+            int next = y * n_cols + x;
+            if(!passable[next] || dist[next] != -1) continue;
+            dist[next] = dist[index] + 1;
+            queue[tail++] = next;
+        }
+    }
+    PK_FREE(queue);
+    PK_FREE(passable);
+    if(!ok) return false;
     py_assign(py_retval(), py_peek(-1));
     py_pop();
     return true;
 }
 
+typedef struct c11_astar_node {
+    py_f64 f;  // g + h
+    py_f64 g;
+    int index;
+} c11_astar_node;
+
+static void c11_astar_heap__push(c11_vector* heap, c11_astar_node node) {
+    c11_vector__push(c11_astar_node, heap, node);
+    c11_astar_node* data = heap->data;
+    int i = heap->length - 1;
+    while(i > 0) {
+        int parent = (i - 1) / 2;
+        if(data[parent].f <= node.f) break;
+        data[i] = data[parent];
+        i = parent;
+    }
+    data[i] = node;
+}
+
+static c11_astar_node c11_astar_heap__pop(c11_vector* heap) {
+    c11_astar_node* data = heap->data;
+    c11_astar_node top = data[0];
+    c11_astar_node last = c11_vector__back(c11_astar_node, heap);
+    c11_vector__pop(heap);
+    int n = heap->length;
+    int i = 0;
+    while(n > 0) {
+        int child = 2 * i + 1;
+        if(child >= n) break;
+        if(child + 1 < n && data[child + 1].f < data[child].f) child++;
+        if(last.f <= data[child].f) break;
+        data[i] = data[child];
+        i = child;
+    }
+    if(n > 0) data[i] = last;
+    return top;
+}
+
+// find_path(self, start: vec2i, goal: vec2i, value: T, neighborhood: Neighborhood = 'von Neumann', cost: array2d_like[float] | None = None) -> list[vec2i] | None
+static bool array2d_like_find_path(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(6);
+    c11_array2d_like* self = py_touserdata(argv);
+    int start, goal;
+    if(!_array2d_like_check_pos(self, py_arg(1), &start)) return false;
+    if(!_array2d_like_check_pos(self, py_arg(2), &goal)) return false;
+    const c11_vec2i* offsets;
+    int n_offsets;
+    if(!_array2d_like_neighborhood(py_arg(4), &offsets, &n_offsets)) return false;
+    c11_array2d_like* cost = NULL;
+    if(!py_isnone(py_arg(5))) {
+        if(!py_checkinstance(py_arg(5), tp_array2d_like)) return false;
+        cost = py_touserdata(py_arg(5));
+        if(!_array2d_like_check_same_shape(self, cost)) return false;
+    }
+    int n_cols = self->n_cols;
+    int numel = self->numel;
+    bool* passable = PK_MALLOC(numel);
+    if(!_array2d_like_equal_mask(argv, py_arg(3), passable)) {
+        PK_FREE(passable);
+        return false;
+    }
+    // read the cost of entering each passable cell once
+    py_f64* costs = PK_MALLOC(sizeof(py_f64) * numel);
+    py_f64 min_cost = cost != NULL ? INFINITY : 1;
+    for(int index = 0; cost != NULL && index < numel; index++) {
+        if(!passable[index]) continue;
+        py_Ref item = cost->f_get(cost, index % n_cols, index / n_cols);
+        if(!py_castfloat(item, &costs[index])) {
+            PK_FREE(costs);
+            PK_FREE(passable);
+            return false;
+        }
+        if(!(costs[index] > 0)) {
+            PK_FREE(costs);
+            PK_FREE(passable);
+            return ValueError("cost must be positive");
+        }
+        min_cost = c11__min(min_cost, costs[index]);
+    }
+
+    py_f64* g = PK_MALLOC(sizeof(py_f64) * numel);
+    int* came_from = PK_MALLOC(sizeof(int) * numel);
+    for(int index = 0; index < numel; index++) {
+        g[index] = INFINITY;
+        came_from[index] = -1;
+    }
+    int goal_x = goal % n_cols;
+    int goal_y = goal / n_cols;
+    c11_vector heap;
+    c11_vector__ctor(&heap, sizeof(c11_astar_node));
+    g[start] = 0;
+    c11_astar_heap__push(&heap, (c11_astar_node){0, 0, start});
+    bool found = false;
+    while(heap.length > 0) {
+        c11_astar_node node = c11_astar_heap__pop(&heap);
+        if(node.index == goal) {
+            found = true;
+            break;
+        }
+        if(node.g > g[node.index]) continue;  // a shorter path was pushed later
+        int i = node.index % n_cols;
+        int j = node.index / n_cols;
+        for(int k = 0; k < n_offsets; k++) {
+            int x = i + offsets[k].x;
+            int y = j + offsets[k].y;
+            if(!c11_array2d_like_is_valid(self, x, y)) continue;
+            int next = y * n_cols + x;
+            if(!passable[next]) continue;
+            py_f64 next_g = g[node.index] + (cost ? costs[next] : 1);
+            if(next_g >= g[next]) continue;
+            g[next] = next_g;
+            came_from[next] = node.index;
+            // Manhattan or Chebyshev distance scaled by the cheapest step is admissible
+            int dx = abs(goal_x - x);
+            int dy = abs(goal_y - y);
+            int h = n_offsets == 4 ? dx + dy : c11__max(dx, dy);
+            c11_astar_heap__push(&heap, (c11_astar_node){next_g + h * min_cost, next_g, next});
+        }
+    }
+    c11_vector__dtor(&heap);
+
+    if(found) {
+        int length = 1;
+        for(int index = goal; index != start; index = came_from[index])
+            length++;
+        py_newlistn(py_retval(), length);
+        for(int index = goal; length > 0; index = came_from[index]) {
+            c11_vec2i pos = {
+                {index % n_cols, index / n_cols}
+            };
+            py_newvec2i(py_list_getitem(py_retval(), --length), pos);
+        }
+    } else {
+        py_newnone(py_retval());
+    }
+    PK_FREE(came_from);
+    PK_FREE(g);
+    PK_FREE(costs);
+    PK_FREE(passable);
+    return true;
+}
+
 #undef HANDLE_SLICE
 
 static void register_array2d_like(py_Ref mod) {
@@ -772,13 +1811,16 @@ static void register_array2d_like(py_Ref mod) {
     py_bindmethod(type, "get_bounding_rect", array2d_like_get_bounding_rect);
     py_bindmethod(type, "count_neighbors", array2d_like_count_neighbors);
     py_bindmethod(type, "convolve", array2d_like_convolve);
-
-    const char* scc =
-        "\ndef get_connected_components(self, value: T, neighborhood: Neighborhood) -> tuple[array2d[int], int]:\n    from collections import deque\n    from linalg import vec2i\n\n    DIRS = [vec2i.LEFT, vec2i.RIGHT, vec2i.UP, vec2i.DOWN]\n    assert neighborhood in ['Moore', 'von Neumann']\n\n    if neighborhood == 'Moore':\n        DIRS.extend([\n            vec2i.LEFT+vec2i.UP,\n            vec2i.RIGHT+vec2i.UP,\n            vec2i.LEFT+vec2i.DOWN,\n            vec2i.RIGHT+vec2i.DOWN\n            ])\n\n    visited = array2d[int](self.width, self.height, default=0)\n    queue = deque()\n    count = 0\n    for y in range(self.height):\n        for x in range(self.width):\n            if visited[x, y] or self[x, y] != value:\n                continue\n            count += 1\n            queue.append((x, y))\n            visited[x, y] = count\n            while queue:\n                cx, cy = queue.popleft()\n                for dx, dy in DIRS:\n                    nx, ny = cx+dx, cy+dy\n                    if self.is_valid(nx, ny) and not visited[nx, ny] and self[nx, ny] == value:\n                        queue.append((nx, ny))\n                        visited[nx, ny] = count\n    return visited, count\n\narray2d_like.get_connected_components = get_connected_components\ndel get_connected_components\n";
-    if(!py_exec(scc, "array2d.py", EXEC_MODE, mod)) {
-        py_printexc();
-        c11__abort("failed to execute array2d.py");
-    }
+    py_bindmethod(type, "get_connected_components", array2d_like_get_connected_components);
+    py_bind(py_tpobject(type),
+            "flood_fill(self, pos, value, neighborhood='von Neumann')",
+            array2d_like_flood_fill);
+    py_bind(py_tpobject(type),
+            "get_distance_field(self, sources, value, neighborhood='von Neumann')",
+            array2d_like_get_distance_field);
+    py_bind(py_tpobject(type),
+            "find_path(self, start, goal, value, neighborhood='von Neumann', cost=None)",
+            array2d_like_find_path);
 }
 
 static bool array2d_like_iterator__next__(int argc, py_Ref argv) {
@@ -889,36 +1931,324 @@ static void register_array2d_view(py_Ref mod) {
     py_bindproperty(type, "origin", array2d_view_origin, NULL);
 }
 
+static bool array2d_packed__new__(int argc, py_Ref argv) {
+    // __new__(cls, n_cols: int, n_rows: int, dtype: str, default=None)
+    py_Ref default_ = py_arg(4);
+    PY_CHECK_ARG_TYPE(0, tp_type);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    PY_CHECK_ARG_TYPE(3, tp_str);
+    int n_cols = argv[1]._i64;
+    int n_rows = argv[2]._i64;
+    if(n_cols <= 0 || n_rows <= 0) {
+        return ValueError("array2d_packed() expected positive dimensions");
+    }
+    c11_dtype dtype = c11_dtype_bool;
+    if(!c11_dtype__parse(py_tosv(py_arg(3)), &dtype)) return false;
+    c11_array2d_packed* ud = py_newarray2d_packed(py_pushtmp(), n_cols, n_rows, dtype);
+    // setup initial values, cells are zero-filled by default
+    if(py_callable(default_)) {
+        for(int j = 0; j < n_rows; j++) {
+            for(int i = 0; i < n_cols; i++) {
+                py_TValue tmp;
+                py_newvec2i(&tmp,
+                            (c11_vec2i){
+                                {i, j}
+                });
+                if(!py_call(default_, 1, &tmp)) return false;
+                if(!c11_array2d_packed__set(ud, i, j, py_retval())) return false;
+            }
+        }
+    } else if(!py_isnone(default_)) {
+        c11_dtype_value val;
+        if(!c11_dtype__pack(dtype, &val, default_)) return false;
+        c11_array2d_packed__fill(ud, NULL, val);
+    }
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return true;
+}
+
+static bool array2d_packed_dtype(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_array2d_packed* self = py_touserdata(argv);
+    py_newstr(py_retval(), c11_dtype__names[self->dtype]);
+    return true;
+}
+
+static bool array2d_packed_copy(int argc, py_Ref argv) {
+    // def copy(self) -> 'array2d_packed': ...
+    PY_CHECK_ARGC(1);
+    c11_array2d_packed* self = py_touserdata(argv);
+    c11_array2d_packed* res =
+        py_newarray2d_packed(py_retval(), self->header.n_cols, self->header.n_rows, self->dtype);
+    memcpy(res->data, self->data, self->header.numel * self->itemsize);
+    return true;
+}
+
+static void register_array2d_packed(py_Ref mod) {
+    py_Type type = py_newtype("array2d_packed", tp_array2d_like, mod, NULL);
+    assert(type == tp_array2d_packed);
+    py_bind(py_tpobject(type),
+            "__new__(cls, n_cols: int, n_rows: int, dtype: str, default=None)",
+            array2d_packed__new__);
+    py_bindproperty(type, "dtype", array2d_packed_dtype, NULL);
+    py_bindmethod(type, "copy", array2d_packed_copy);
+}
+
 /* chunked_array2d */
-#define SMALLMAP_T__SOURCE
-#define K c11_vec2i
-#define V py_TValue*
-#define NAME c11_chunked_array2d_chunks
-#define less(a, b) (a._i64 < b._i64)
-#define equal(a, b) (a._i64 == b._i64)
-#include "pocketpy/xmacros/smallmap.h"
-#undef SMALLMAP_T__SOURCE
-
-static py_TValue* c11_chunked_array2d__new_chunk(c11_chunked_array2d* self, c11_vec2i pos) {
-#ifndef NDEBUG
-    bool exists = c11_chunked_array2d_chunks__contains(&self->chunks, pos);
-    assert(!exists);
-#endif
-    int chunk_numel = self->chunk_size * self->chunk_size + 1;
-    py_TValue* data = PK_MALLOC(sizeof(py_TValue) * chunk_numel);
+static uint32_t c11_chunked_array2d__hash(c11_vec2i pos) {
+    return (uint32_t)(((uint64_t)pos._i64 * 0x9E3779B97F4A7C15ull) >> 32);
+}
+
+static c11_chunked_array2d_chunk* c11_chunked_array2d__find(c11_chunked_array2d* self,
+                                                            c11_vec2i pos) {
+    if(self->capacity == 0) return NULL;
+    uint32_t mask = self->capacity - 1;
+    uint32_t i = c11_chunked_array2d__hash(pos) & mask;
+    while(true) {
+        c11_chunked_array2d_chunk* chunk = self->table[i];
+        if(chunk == NULL || chunk->pos._i64 == pos._i64) return chunk;
+        i = (i + 1) & mask;
+    }
+}
+
+static void c11_chunked_array2d__insert_slot(c11_chunked_array2d_chunk** table,
+                                             int capacity,
+                                             c11_chunked_array2d_chunk* chunk) {
+    uint32_t mask = capacity - 1;
+    uint32_t i = c11_chunked_array2d__hash(chunk->pos) & mask;
+    while(table[i] != NULL)
+        i = (i + 1) & mask;
+    table[i] = chunk;
+}
+
+static void c11_chunked_array2d__insert(c11_chunked_array2d* self,
+                                        c11_chunked_array2d_chunk* chunk) {
+    // keep the load factor <= 0.5
+    if((self->length + 1) * 2 > self->capacity) {
+        int new_capacity = self->capacity == 0 ? 16 : self->capacity * 2;
+        c11_chunked_array2d_chunk** new_table =
+            PK_MALLOC(sizeof(c11_chunked_array2d_chunk*) * new_capacity);
+        memset(new_table, 0, sizeof(c11_chunked_array2d_chunk*) * new_capacity);
+        for(int i = 0; i < self->capacity; i++) {
+            if(self->table[i] != NULL) {
+                c11_chunked_array2d__insert_slot(new_table, new_capacity, self->table[i]);
+            }
+        }
+        PK_FREE(self->table);
+        self->table = new_table;
+        self->capacity = new_capacity;
+    }
+    c11_chunked_array2d__insert_slot(self->table, self->capacity, chunk);
+    self->length++;
+}
+
+static void c11_chunked_array2d__erase(c11_chunked_array2d* self,
+                                       c11_chunked_array2d_chunk* chunk) {
+    uint32_t mask = self->capacity - 1;
+    uint32_t i = c11_chunked_array2d__hash(chunk->pos) & mask;
+    while(self->table[i] != chunk)
+        i = (i + 1) & mask;
+    self->table[i] = NULL;
+    self->length--;
+    // backward-shift the rest of the probe sequence, no tombstones needed
+    uint32_t j = i;
+    while(true) {
+        j = (j + 1) & mask;
+        c11_chunked_array2d_chunk* p = self->table[j];
+        if(p == NULL) break;
+        uint32_t k = c11_chunked_array2d__hash(p->pos) & mask;
+        bool in_place = i <= j ? (i < k && k <= j) : (i < k || k <= j);
+        if(in_place) continue;
+        self->table[i] = p;
+        self->table[j] = NULL;
+        i = j;
+    }
+}
+
+static void c11_chunked_array2d__lru_unlink(c11_chunked_array2d* self,
+                                            c11_chunked_array2d_chunk* chunk) {
+    if(chunk->prev) {
+        chunk->prev->next = chunk->next;
+    } else {
+        self->lru_head = chunk->next;
+    }
+    if(chunk->next) {
+        chunk->next->prev = chunk->prev;
+    } else {
+        self->lru_tail = chunk->prev;
+    }
+    chunk->prev = chunk->next = NULL;
+}
+
+static void c11_chunked_array2d__lru_push_front(c11_chunked_array2d* self,
+                                                c11_chunked_array2d_chunk* chunk) {
+    chunk->prev = NULL;
+    chunk->next = self->lru_head;
+    if(self->lru_head) {
+        self->lru_head->prev = chunk;
+    } else {
+        self->lru_tail = chunk;
+    }
+    self->lru_head = chunk;
+}
+
+static void c11_chunked_array2d__free_chunk(c11_chunked_array2d* self,
+                                            c11_chunked_array2d_chunk* chunk) {
+    if(chunk->cells != NULL) {
+        c11_chunked_array2d__lru_unlink(self, chunk);
+        self->resident--;
+        PK_FREE(chunk->cells);
+    }
+    PK_FREE(chunk);
+}
+
+static void c11_chunked_array2d__free_all(c11_chunked_array2d* self) {
+    for(int i = 0; i < self->capacity; i++) {
+        c11_chunked_array2d_chunk* chunk = self->table[i];
+        if(chunk == NULL) continue;
+        PK_FREE(chunk->cells);
+        PK_FREE(chunk);
+    }
+    PK_FREE(self->table);
+    self->table = NULL;
+    self->capacity = 0;
+    self->length = 0;
+    self->resident = 0;
+    self->lru_head = self->lru_tail = NULL;
+}
+
+// calls `save(pos, data)` and releases the cells of `chunk`
+static bool c11_chunked_array2d__page_out(c11_chunked_array2d* self,
+                                          c11_chunked_array2d_chunk* chunk) {
+    int numel = self->chunk_size * self->chunk_size;
+    py_StackRef args = py_pushtmp();
+    py_pushtmp();
+    py_newvec2i(&args[0], chunk->pos);
+    py_TValue* items = py_newtuple(&args[1], numel);
+    for(int i = 0; i < numel; i++) {
+        items[i] = py_isnil(&chunk->cells[i]) ? self->default_T : chunk->cells[i];
+    }
+    bool ok = py_pickle_dumps(&args[1]);
+    if(ok) {
+        args[1] = *py_retval();
+        bool was_streaming = self->is_streaming;
+        self->is_streaming = true;
+        ok = py_call(&self->on_save, 2, args);
+        self->is_streaming = was_streaming;
+    }
+    py_shrink(2);
+    if(!ok) return false;
+    c11_chunked_array2d__lru_unlink(self, chunk);
+    self->resident--;
+    PK_FREE(chunk->cells);
+    chunk->cells = NULL;
+    return true;
+}
+
+// calls `load(pos)` and unpickles the result into `cells`
+static bool c11_chunked_array2d__load_cells(c11_chunked_array2d* self,
+                                            c11_vec2i pos,
+                                            py_TValue* cells) {
+    int numel = self->chunk_size * self->chunk_size;
+    py_StackRef arg = py_pushtmp();
+    py_newvec2i(arg, pos);
+    bool was_streaming = self->is_streaming;
+    self->is_streaming = true;
+    bool ok = py_call(&self->on_load, 1, arg);
+    self->is_streaming = was_streaming;
+    if(ok && !py_istype(py_retval(), tp_bytes)) {
+        ok = TypeError("load() must return 'bytes', got '%t'", py_retval()->type);
+    }
+    if(ok) {
+        py_assign(arg, py_retval());  // keep the bytes alive
+        int size;
+        unsigned char* data = py_tobytes(arg, &size);
+        ok = py_pickle_loads(data, size);
+    }
+    if(ok) {
+        py_Ref res = py_retval();
+        if(!py_istuple(res) || py_tuple_len(res) != numel) {
+            ok = ValueError("load() returned invalid data for chunk (%d, %d)", pos.x, pos.y);
+        } else {
+            memcpy(cells, py_tuple_data(res), sizeof(py_TValue) * numel);
+        }
+    }
+    py_pop();
+    return ok;
+}
+
+static bool c11_chunked_array2d__page_in(c11_chunked_array2d* self,
+                                         c11_chunked_array2d_chunk* chunk) {
+    py_TValue* cells = PK_MALLOC(sizeof(py_TValue) * self->chunk_size * self->chunk_size);
+    if(!c11_chunked_array2d__load_cells(self, chunk->pos, cells)) {
+        PK_FREE(cells);
+        return false;
+    }
+    if(chunk->cells != NULL) {
+        // already paged in by the `load` hook itself
+        PK_FREE(cells);
+        return true;
+    }
+    chunk->cells = cells;
+    self->resident++;
+    c11_chunked_array2d__lru_push_front(self, chunk);
+    return true;
+}
+
+// pages out least recently used chunks until the budget is met, `keep` is never paged out
+static bool c11_chunked_array2d__evict(c11_chunked_array2d* self,
+                                       c11_chunked_array2d_chunk* keep) {
+    if(self->max_resident == 0 || self->is_streaming) return true;
+    while(self->resident > self->max_resident) {
+        c11_chunked_array2d_chunk* victim = self->lru_tail;
+        if(victim == keep) victim = victim->prev;
+        if(victim == NULL) break;
+        if(!c11_chunked_array2d__page_out(self, victim)) return false;
+    }
+    return true;
+}
+
+// makes `chunk` resident and the most recently used one
+static bool c11_chunked_array2d__acquire(c11_chunked_array2d* self,
+                                         c11_chunked_array2d_chunk* chunk) {
+    if(chunk->cells == NULL) {
+        if(!c11_chunked_array2d__page_in(self, chunk)) return false;
+    } else if(chunk != self->lru_head) {
+        c11_chunked_array2d__lru_unlink(self, chunk);
+        c11_chunked_array2d__lru_push_front(self, chunk);
+    }
+    return c11_chunked_array2d__evict(self, chunk);
+}
+
+static c11_chunked_array2d_chunk* c11_chunked_array2d__new_chunk(c11_chunked_array2d* self,
+                                                                 c11_vec2i pos) {
+    py_TValue context;
     if(!py_isnone(&self->context_builder)) {
-        py_newvec2i(&data[0], pos);
-        bool ok = py_call(&self->context_builder, 1, &data[0]);
+        py_newvec2i(py_pushtmp(), pos);
+        bool ok = py_call(&self->context_builder, 1, py_peek(-1));
+        py_pop();
         if(!ok) return NULL;
-        data[0] = *py_retval();
+        context = *py_retval();
     } else {
-        data[0] = *py_None();
+        context = *py_None();
     }
-    memset(&data[1], 0, sizeof(py_TValue) * (chunk_numel - 1));
-    c11_chunked_array2d_chunks__set(&self->chunks, pos, data);
-    self->last_visited.key = pos;
-    self->last_visited.value = data;
-    return data;
+    if(c11_chunked_array2d__find(self, pos) != NULL) {
+        ValueError("chunk (%d, %d) already exists", pos.x, pos.y);
+        return NULL;
+    }
+    int chunk_numel = self->chunk_size * self->chunk_size;
+    c11_chunked_array2d_chunk* chunk = PK_MALLOC(sizeof(c11_chunked_array2d_chunk));
+    chunk->pos = pos;
+    chunk->context = context;
+    chunk->cells = PK_MALLOC(sizeof(py_TValue) * chunk_numel);
+    memset(chunk->cells, 0, sizeof(py_TValue) * chunk_numel);
+    c11_chunked_array2d__insert(self, chunk);
+    self->resident++;
+    c11_chunked_array2d__lru_push_front(self, chunk);
+    if(!c11_chunked_array2d__evict(self, chunk)) return NULL;
+    return chunk;
 }
 
 static void
@@ -949,49 +2279,95 @@ static void c11_chunked_array2d__world_to_chunk(c11_chunked_array2d* self,
                            &local_pos->y);
 }
 
-static py_TValue* c11_chunked_array2d__parse_col_row(c11_chunked_array2d* self,
-                                                     int col,
-                                                     int row,
-                                                     c11_vec2i* restrict chunk_pos,
-                                                     c11_vec2i* restrict local_pos) {
-    c11_chunked_array2d__world_to_chunk(self, col, row, chunk_pos, local_pos);
-    py_TValue* data;
-    if(self->last_visited.value != NULL && chunk_pos->_i64 == self->last_visited.key._i64) {
-        data = self->last_visited.value;
-    } else {
-        data = c11_chunked_array2d_chunks__get(&self->chunks, *chunk_pos, NULL);
+// `*out` is the resident chunk at `chunk_pos`, or NULL if it does not exist
+static bool c11_chunked_array2d__lookup(c11_chunked_array2d* self,
+                                        c11_vec2i chunk_pos,
+                                        c11_chunked_array2d_chunk** out) {
+    c11_chunked_array2d_chunk* chunk = self->lru_head;
+    if(chunk == NULL || chunk->pos._i64 != chunk_pos._i64) {
+        chunk = c11_chunked_array2d__find(self, chunk_pos);
+        if(chunk != NULL && !c11_chunked_array2d__acquire(self, chunk)) return false;
     }
-    if(data != NULL) {
-        self->last_visited.key = *chunk_pos;
-        self->last_visited.value = data;
+    *out = chunk;
+    return true;
+}
+
+static bool c11_chunked_array2d__getitem(c11_chunked_array2d* self,
+                                         int col,
+                                         int row,
+                                         py_Ref* out) {
+    c11_vec2i chunk_pos, local_pos;
+    c11_chunked_array2d__world_to_chunk(self, col, row, &chunk_pos, &local_pos);
+    c11_chunked_array2d_chunk* chunk;
+    if(!c11_chunked_array2d__lookup(self, chunk_pos, &chunk)) return false;
+    *out = &self->default_T;
+    if(chunk != NULL) {
+        py_Ref p = &chunk->cells[local_pos.y * self->chunk_size + local_pos.x];
+        if(!py_isnil(p)) *out = p;
     }
-    return data;
+    return true;
 }
 
 py_Ref c11_chunked_array2d__get(c11_chunked_array2d* self, int col, int row) {
+    // hooks may run below, keep the caller's `py_retval()`
+    py_push(py_retval());
+    py_Ref res;
+    if(!c11_chunked_array2d__getitem(self, col, row, &res)) {
+        // views cannot fail on read, report the error and fall back to `default`
+        py_printexc();
+        py_clearexc(NULL);
+        res = &self->default_T;
+    }
+    py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return res;
+}
+
+static bool c11_chunked_array2d__setitem(c11_chunked_array2d* self,
+                                         int col,
+                                         int row,
+                                         py_Ref value) {
     c11_vec2i chunk_pos, local_pos;
-    py_TValue* data = c11_chunked_array2d__parse_col_row(self, col, row, &chunk_pos, &local_pos);
-    if(data == NULL) return &self->default_T;
-    py_Ref retval = &data[1 + local_pos.y * self->chunk_size + local_pos.x];
-    if(py_isnil(retval)) return &self->default_T;
-    return retval;
+    c11_chunked_array2d__world_to_chunk(self, col, row, &chunk_pos, &local_pos);
+    py_TValue val = *value;  // `value` may live in a chunk that gets paged out
+    c11_chunked_array2d_chunk* chunk;
+    if(!c11_chunked_array2d__lookup(self, chunk_pos, &chunk)) return false;
+    if(chunk == NULL) {
+        chunk = c11_chunked_array2d__new_chunk(self, chunk_pos);
+        if(chunk == NULL) return false;
+    }
+    chunk->cells[local_pos.y * self->chunk_size + local_pos.x] = val;
+    return true;
 }
 
 bool c11_chunked_array2d__set(c11_chunked_array2d* self, int col, int row, py_Ref value) {
+    py_push(py_retval());
+    bool ok = c11_chunked_array2d__setitem(self, col, row, value);
+    if(ok) py_assign(py_retval(), py_peek(-1));
+    py_pop();
+    return ok;
+}
+
+static bool c11_chunked_array2d__del(c11_chunked_array2d* self, int col, int row) {
     c11_vec2i chunk_pos, local_pos;
-    py_TValue* data = c11_chunked_array2d__parse_col_row(self, col, row, &chunk_pos, &local_pos);
-    if(data == NULL) {
-        data = c11_chunked_array2d__new_chunk(self, chunk_pos);
-        if(data == NULL) return false;
+    c11_chunked_array2d__world_to_chunk(self, col, row, &chunk_pos, &local_pos);
+    c11_chunked_array2d_chunk* chunk;
+    if(!c11_chunked_array2d__lookup(self, chunk_pos, &chunk)) return false;
+    if(chunk != NULL) chunk->cells[local_pos.y * self->chunk_size + local_pos.x] = *py_NIL();
+    return true;
+}
+
+static bool c11_chunked_array2d__check_not_streaming(c11_chunked_array2d* self) {
+    if(self->is_streaming) {
+        return RuntimeError("chunked_array2d cannot be restructured inside a save/load hook");
     }
-    data[1 + local_pos.y * self->chunk_size + local_pos.x] = *value;
     return true;
 }
 
-static void c11_chunked_array2d__del(c11_chunked_array2d* self, int col, int row) {
-    c11_vec2i chunk_pos, local_pos;
-    py_TValue* data = c11_chunked_array2d__parse_col_row(self, col, row, &chunk_pos, &local_pos);
-    if(data != NULL) data[1 + local_pos.y * self->chunk_size + local_pos.x] = *py_NIL();
+static int c11_chunked_array2d__cmp_pos(const void* a, const void* b) {
+    int64_t lhs = (*(c11_chunked_array2d_chunk* const*)a)->pos._i64;
+    int64_t rhs = (*(c11_chunked_array2d_chunk* const*)b)->pos._i64;
+    return (lhs > rhs) - (lhs < rhs);
 }
 
 static bool chunked_array2d__new__(int argc, py_Ref argv) {
@@ -999,10 +2375,12 @@ static bool chunked_array2d__new__(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(1, tp_int);
     py_Type cls = py_totype(argv);
     c11_chunked_array2d* self = py_newobject(py_retval(), cls, 0, sizeof(c11_chunked_array2d));
+    memset(self, 0, sizeof(c11_chunked_array2d));
     int chunk_size = py_toint(&argv[1]);
     self->default_T = argv[2];
     self->context_builder = argv[3];
-    c11_chunked_array2d_chunks__ctor(&self->chunks);
+    self->on_save = *py_None();
+    self->on_load = *py_None();
     self->chunk_size = chunk_size;
     switch(chunk_size) {
         case 2: self->chunk_size_log2 = 1; break;
@@ -1020,7 +2398,6 @@ static bool chunked_array2d__new__(int argc, py_Ref argv) {
         default: return ValueError("invalid chunk_size: %d, not power of 2", chunk_size);
     }
     self->chunk_size_mask = chunk_size - 1;
-    memset(&self->last_visited, 0, sizeof(c11_chunked_array2d_chunks_KV));
     return true;
 }
 
@@ -1045,12 +2422,20 @@ static bool chunked_array2d_context_builder(int argc, py_Ref argv) {
     return true;
 }
 
+static bool chunked_array2d_resident_chunks(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    c11_chunked_array2d* self = py_touserdata(argv);
+    py_newint(py_retval(), self->resident);
+    return true;
+}
+
 static bool chunked_array2d__getitem__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
     PY_CHECK_ARG_TYPE(1, tp_vec2i);
     c11_chunked_array2d* self = py_touserdata(argv);
     c11_vec2i pos = py_tovec2i(&argv[1]);
-    py_Ref res = c11_chunked_array2d__get(self, pos.x, pos.y);
+    py_Ref res;
+    if(!c11_chunked_array2d__getitem(self, pos.x, pos.y, &res)) return false;
     py_assign(py_retval(), res);
     return true;
 }
@@ -1060,7 +2445,7 @@ static bool chunked_array2d__setitem__(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(1, tp_vec2i);
     c11_chunked_array2d* self = py_touserdata(argv);
     c11_vec2i pos = py_tovec2i(&argv[1]);
-    bool ok = c11_chunked_array2d__set(self, pos.x, pos.y, &argv[2]);
+    bool ok = c11_chunked_array2d__setitem(self, pos.x, pos.y, &argv[2]);
     if(!ok) return false;
     py_newnone(py_retval());
     return true;
@@ -1071,7 +2456,7 @@ static bool chunked_array2d__delitem__(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(1, tp_vec2i);
     c11_chunked_array2d* self = py_touserdata(argv);
     c11_vec2i pos = py_tovec2i(&argv[1]);
-    c11_chunked_array2d__del(self, pos.x, pos.y);
+    if(!c11_chunked_array2d__del(self, pos.x, pos.y)) return false;
     py_newnone(py_retval());
     return true;
 }
@@ -1079,14 +2464,20 @@ static bool chunked_array2d__delitem__(int argc, py_Ref argv) {
 static bool chunked_array2d__iter__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(argv);
-    py_Ref data = py_newtuple(py_pushtmp(), self->chunks.length);
-    for(int i = 0; i < self->chunks.length; i++) {
-        c11_chunked_array2d_chunks_KV* kv =
-            c11__at(c11_chunked_array2d_chunks_KV, &self->chunks, i);
+    // iterate in the order of `pos._i64`, independent of the hash layout
+    c11_chunked_array2d_chunk** chunks = PK_MALLOC(sizeof(void*) * c11__max(self->length, 1));
+    int n = 0;
+    for(int i = 0; i < self->capacity; i++) {
+        if(self->table[i] != NULL) chunks[n++] = self->table[i];
+    }
+    qsort(chunks, n, sizeof(void*), c11_chunked_array2d__cmp_pos);
+    py_Ref data = py_newtuple(py_pushtmp(), n);
+    for(int i = 0; i < n; i++) {
         py_Ref p = py_newtuple(&data[i], 2);
-        py_newvec2i(&p[0], kv->key);  // pos
-        p[1] = kv->value[0];          // context
+        py_newvec2i(&p[0], chunks[i]->pos);  // pos
+        p[1] = chunks[i]->context;           // context
     }
+    PK_FREE(chunks);
     bool ok = py_iter(py_peek(-1));
     if(!ok) return false;
     py_pop();
@@ -1096,15 +2487,15 @@ static bool chunked_array2d__iter__(int argc, py_Ref argv) {
 static bool chunked_array2d__len__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(argv);
-    py_newint(py_retval(), self->chunks.length);
+    py_newint(py_retval(), self->length);
     return true;
 }
 
 static bool chunked_array2d_clear(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(argv);
-    c11_chunked_array2d_chunks__clear(&self->chunks);
-    self->last_visited.value = NULL;
+    if(!c11_chunked_array2d__check_not_streaming(self)) return false;
+    c11_chunked_array2d__free_all(self);
     py_newnone(py_retval());
     return true;
 }
@@ -1112,28 +2503,40 @@ static bool chunked_array2d_clear(int argc, py_Ref argv) {
 static bool chunked_array2d_copy(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(argv);
+    py_Ref res_ref = py_pushtmp();
     c11_chunked_array2d* res =
-        py_newobject(py_retval(), tp_chunked_array2d, 0, sizeof(c11_chunked_array2d));
-    // copy basic data
+        py_newobject(res_ref, tp_chunked_array2d, 0, sizeof(c11_chunked_array2d));
+    // copy basic data, the copy is not streamed
     memcpy(res, self, sizeof(c11_chunked_array2d));
-    // invalidate last_visited cache
-    self->last_visited.value = NULL;
-    // copy chunks
-    memset(&res->chunks, 0, sizeof(c11_chunked_array2d_chunks));
-    c11_chunked_array2d_chunks__ctor(&res->chunks);
-    c11_vector__reserve(&res->chunks, self->chunks.capacity);
-    for(int i = 0; i < self->chunks.length; i++) {
-        c11_chunked_array2d_chunks_KV* kv =
-            c11__at(c11_chunked_array2d_chunks_KV, &self->chunks, i);
-        int chunk_numel = self->chunk_size * self->chunk_size + 1;
-        py_TValue* data = PK_MALLOC(sizeof(py_TValue) * chunk_numel);
-        memcpy(data, kv->value, sizeof(py_TValue) * chunk_numel);
-        // construct new KV
-        c11_chunked_array2d_chunks_KV new_kv;
-        new_kv.key = kv->key;
-        new_kv.value = data;
-        c11_vector__push(c11_chunked_array2d_chunks_KV, &res->chunks, new_kv);
+    res->table = NULL;
+    res->capacity = res->length = res->resident = 0;
+    res->lru_head = res->lru_tail = NULL;
+    res->max_resident = 0;
+    res->on_save = *py_None();
+    res->on_load = *py_None();
+    res->is_streaming = false;
+    // copy chunks, paged out ones are loaded into the copy directly
+    int chunk_numel = self->chunk_size * self->chunk_size;
+    for(int i = 0; i < self->capacity; i++) {
+        c11_chunked_array2d_chunk* chunk = self->table[i];
+        if(chunk == NULL) continue;
+        py_TValue* cells = PK_MALLOC(sizeof(py_TValue) * chunk_numel);
+        if(chunk->cells != NULL) {
+            memcpy(cells, chunk->cells, sizeof(py_TValue) * chunk_numel);
+        } else if(!c11_chunked_array2d__load_cells(self, chunk->pos, cells)) {
+            PK_FREE(cells);
+            return false;
+        }
+        c11_chunked_array2d_chunk* new_chunk = PK_MALLOC(sizeof(c11_chunked_array2d_chunk));
+        new_chunk->pos = chunk->pos;
+        new_chunk->context = chunk->context;
+        new_chunk->cells = cells;
+        c11_chunked_array2d__insert(res, new_chunk);
+        res->resident++;
+        c11_chunked_array2d__lru_push_front(res, new_chunk);
     }
+    py_assign(py_retval(), res_ref);
+    py_pop();
     return true;
 }
 
@@ -1155,9 +2558,9 @@ static bool chunked_array2d_add_chunk(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(1, tp_vec2i);
     c11_chunked_array2d* self = py_touserdata(argv);
     c11_vec2i pos = py_tovec2i(&argv[1]);
-    py_TValue* data = c11_chunked_array2d__new_chunk(self, pos);
-    if(data == NULL) return false;
-    py_assign(py_retval(), &data[0]);  // context
+    c11_chunked_array2d_chunk* chunk = c11_chunked_array2d__new_chunk(self, pos);
+    if(chunk == NULL) return false;
+    py_assign(py_retval(), &chunk->context);
     return true;
 }
 
@@ -1166,9 +2569,13 @@ static bool chunked_array2d_remove_chunk(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(1, tp_vec2i);
     c11_chunked_array2d* self = py_touserdata(argv);
     c11_vec2i pos = py_tovec2i(&argv[1]);
-    bool ok = c11_chunked_array2d_chunks__del(&self->chunks, pos);
-    self->last_visited.value = NULL;
-    py_newbool(py_retval(), ok);
+    if(!c11_chunked_array2d__check_not_streaming(self)) return false;
+    c11_chunked_array2d_chunk* chunk = c11_chunked_array2d__find(self, pos);
+    if(chunk != NULL) {
+        c11_chunked_array2d__erase(self, chunk);
+        c11_chunked_array2d__free_chunk(self, chunk);
+    }
+    py_newbool(py_retval(), chunk != NULL);
     return true;
 }
 
@@ -1179,15 +2586,17 @@ static bool chunked_array2d_move_chunk(int argc, py_Ref argv) {
     c11_chunked_array2d* self = py_touserdata(argv);
     c11_vec2i src = py_tovec2i(&argv[1]);
     c11_vec2i dst = py_tovec2i(&argv[2]);
-    py_TValue* src_data = c11_chunked_array2d_chunks__get(&self->chunks, src, NULL);
-    py_TValue* dst_data = c11_chunked_array2d_chunks__get(&self->chunks, dst, NULL);
-    if(src_data == NULL || dst_data != NULL) {
+    if(!c11_chunked_array2d__check_not_streaming(self)) return false;
+    c11_chunked_array2d_chunk* chunk = c11_chunked_array2d__find(self, src);
+    if(chunk == NULL || c11_chunked_array2d__find(self, dst) != NULL) {
         py_newbool(py_retval(), false);
         return true;
     }
-    c11_chunked_array2d_chunks__del(&self->chunks, src);
-    c11_chunked_array2d_chunks__set(&self->chunks, dst, src_data);
-    self->last_visited.value = NULL;
+    // saved data is keyed by position, bring it back before the key changes
+    if(!c11_chunked_array2d__acquire(self, chunk)) return false;
+    c11_chunked_array2d__erase(self, chunk);
+    chunk->pos = dst;
+    c11_chunked_array2d__insert(self, chunk);
     py_newbool(py_retval(), true);
     return true;
 }
@@ -1197,29 +2606,57 @@ static bool chunked_array2d_get_context(int argc, py_Ref argv) {
     PY_CHECK_ARG_TYPE(1, tp_vec2i);
     c11_chunked_array2d* self = py_touserdata(argv);
     c11_vec2i pos = py_tovec2i(&argv[1]);
-    py_TValue* data = c11_chunked_array2d_chunks__get(&self->chunks, pos, NULL);
-    if(data == NULL) {
+    c11_chunked_array2d_chunk* chunk = c11_chunked_array2d__find(self, pos);
+    if(chunk == NULL) {
         py_newnone(py_retval());
     } else {
-        py_assign(py_retval(), &data[0]);
+        py_assign(py_retval(), &chunk->context);
     }
     return true;
 }
 
-void c11_chunked_array2d__dtor(c11_chunked_array2d* self) {
-    c11__foreach(c11_chunked_array2d_chunks_KV, &self->chunks, p_kv) PK_FREE(p_kv->value);
-    c11_chunked_array2d_chunks__dtor(&self->chunks);
+static bool chunked_array2d_set_streaming(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(4);
+    PY_CHECK_ARG_TYPE(1, tp_int);
+    c11_chunked_array2d* self = py_touserdata(argv);
+    py_i64 max_resident = py_toint(&argv[1]);
+    if(max_resident < 0 || max_resident > INT_MAX) {
+        return ValueError("max_resident_chunks must be in [0, %d]", INT_MAX);
+    }
+    if(max_resident > 0 && (!py_callable(&argv[2]) || !py_callable(&argv[3]))) {
+        return TypeError("save and load must be callable");
+    }
+    if(!c11_chunked_array2d__check_not_streaming(self)) return false;
+    // page everything in with the old hooks first
+    for(int i = 0; i < self->capacity; i++) {
+        c11_chunked_array2d_chunk* chunk = self->table[i];
+        if(chunk == NULL || chunk->cells != NULL) continue;
+        if(!c11_chunked_array2d__page_in(self, chunk)) return false;
+    }
+    self->max_resident = (int)max_resident;
+    self->on_save = argv[2];
+    self->on_load = argv[3];
+    if(!c11_chunked_array2d__evict(self, NULL)) return false;
+    py_newnone(py_retval());
+    return true;
 }
 
+void c11_chunked_array2d__dtor(c11_chunked_array2d* self) { c11_chunked_array2d__free_all(self); }
+
 void c11_chunked_array2d__mark(void* ud) {
     c11_chunked_array2d* self = ud;
     pk__mark_value(&self->default_T);
     pk__mark_value(&self->context_builder);
-    int chunk_numel = self->chunk_size * self->chunk_size + 1;
-    for(int i = 0; i < self->chunks.length; i++) {
-        py_TValue* data = c11__getitem(c11_chunked_array2d_chunks_KV, &self->chunks, i).value;
+    pk__mark_value(&self->on_save);
+    pk__mark_value(&self->on_load);
+    int chunk_numel = self->chunk_size * self->chunk_size;
+    for(int i = 0; i < self->capacity; i++) {
+        c11_chunked_array2d_chunk* chunk = self->table[i];
+        if(chunk == NULL) continue;
+        pk__mark_value(&chunk->context);
+        if(chunk->cells == NULL) continue;
         for(int j = 0; j < chunk_numel; j++) {
-            pk__mark_value(data + j);
+            pk__mark_value(chunk->cells + j);
         }
     }
 }
@@ -1227,13 +2664,14 @@ void c11_chunked_array2d__mark(void* ud) {
 static bool chunked_array2d_view(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_chunked_array2d* self = py_touserdata(&argv[0]);
-    if(self->chunks.length == 0) { return ValueError("chunked_array2d is empty"); }
+    if(self->length == 0) { return ValueError("chunked_array2d is empty"); }
     int min_chunk_x = INT_MAX;
     int min_chunk_y = INT_MAX;
     int max_chunk_x = INT_MIN;
     int max_chunk_y = INT_MIN;
-    for(int i = 0; i < self->chunks.length; i++) {
-        c11_vec2i chunk_pos = c11__getitem(c11_chunked_array2d_chunks_KV, &self->chunks, i).key;
+    for(int i = 0; i < self->capacity; i++) {
+        if(self->table[i] == NULL) continue;
+        c11_vec2i chunk_pos = self->table[i]->pos;
         min_chunk_x = c11__min(min_chunk_x, chunk_pos.x);
         min_chunk_y = c11__min(min_chunk_y, chunk_pos.y);
         max_chunk_x = c11__max(max_chunk_x, chunk_pos.x);
@@ -1300,6 +2738,7 @@ static void register_chunked_array2d(py_Ref mod) {
     py_bindproperty(type, "chunk_size", chunked_array2d_chunk_size, NULL);
     py_bindproperty(type, "default", chunked_array2d_default, NULL);
     py_bindproperty(type, "context_builder", chunked_array2d_context_builder, NULL);
+    py_bindproperty(type, "resident_chunks", chunked_array2d_resident_chunks, NULL);
 
     py_bindmagic(type, __getitem__, chunked_array2d__getitem__);
     py_bindmagic(type, __setitem__, chunked_array2d__setitem__);
@@ -1314,6 +2753,9 @@ static void register_chunked_array2d(py_Ref mod) {
     py_bindmethod(type, "remove_chunk", chunked_array2d_remove_chunk);
     py_bindmethod(type, "move_chunk", chunked_array2d_move_chunk);
     py_bindmethod(type, "get_context", chunked_array2d_get_context);
+    py_bind(py_tpobject(type),
+            "set_streaming(self, max_resident_chunks, save=None, load=None)",
+            chunked_array2d_set_streaming);
 
     py_bindmethod(type, "view", chunked_array2d_view);
     py_bindmethod(type, "view_rect", chunked_array2d_view_rect);
@@ -1329,4 +2771,5 @@ void pk__add_module_array2d() {
     register_array2d(mod);
     register_array2d_view(mod);
     register_chunked_array2d(mod);
+    register_array2d_packed(mod);
 }
\ No newline at end of file
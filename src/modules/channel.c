@@ -0,0 +1,287 @@
+#include "pocketpy/pocketpy.h"
+
+#include "pocketpy/common/utils.h"
+#include "pocketpy/common/threads.h"
+#include "pocketpy/interpreter/array2d.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* A channel is a bounded MPMC queue shared by all VMs in the process.
+ * Values are copied into a malloc'd message on send and rebuilt in the heap
+ * of the receiving VM, so no object is ever shared between two VMs. */
+
+typedef enum {
+    ChannelMessage_PICKLE,
+    ChannelMessage_BYTES,
+    ChannelMessage_ARRAY2D,
+} ChannelMessageKind;
+
+typedef struct ChannelMessage {
+    ChannelMessageKind kind;
+    int n_cols;
+    int n_rows;
+    int size;
+    unsigned char data[];
+} ChannelMessage;
+
+typedef struct ChannelCell {
+    volatile int64_t seq;
+    ChannelMessage* msg;
+} ChannelCell;
+
+typedef struct Channel {
+    struct Channel* next;
+    int refcount;  // guarded by `Channel__registry_lock`
+    char* name;
+    int64_t mask;
+    ChannelCell* cells;
+    char _pad0[64];
+    volatile int64_t enqueue_pos;
+    char _pad1[64];
+    volatile int64_t dequeue_pos;
+    char _pad2[64];
+} Channel;
+
+static Channel* Channel__registry;
+static c11_spinlock Channel__registry_lock;
+
+static Channel* Channel__open(const char* name, int capacity) {
+    c11_spinlock__lock(&Channel__registry_lock);
+    Channel* self = Channel__registry;
+    while(self) {
+        if(strcmp(self->name, name) == 0) break;
+        self = self->next;
+    }
+    if(self == NULL) {
+        int n = 2;
+        while(n < capacity)
+            n *= 2;
+        self = PK_MALLOC(sizeof(Channel));
+        memset(self, 0, sizeof(Channel));
+        int name_size = (int)strlen(name) + 1;
+        self->name = PK_MALLOC(name_size);
+        memcpy(self->name, name, name_size);
+        self->mask = n - 1;
+        self->cells = PK_MALLOC(sizeof(ChannelCell) * n);
+        for(int i = 0; i < n; i++) {
+            self->cells[i].seq = i;
+            self->cells[i].msg = NULL;
+        }
+        self->next = Channel__registry;
+        Channel__registry = self;
+    }
+    self->refcount++;
+    c11_spinlock__unlock(&Channel__registry_lock);
+    return self;
+}
+
+static bool Channel__try_push(Channel* self, ChannelMessage* msg) {
+    int64_t pos = c11__atomic_load(&self->enqueue_pos);
+    while(true) {
+        ChannelCell* cell = &self->cells[pos & self->mask];
+        int64_t diff = c11__atomic_load(&cell->seq) - pos;
+        if(diff == 0) {
+            if(c11__atomic_cas(&self->enqueue_pos, pos, pos + 1)) {
+                cell->msg = msg;
+                c11__atomic_store(&cell->seq, pos + 1);
+                return true;
+            }
+        } else if(diff < 0) {
+            return false;  // full
+        }
+        pos = c11__atomic_load(&self->enqueue_pos);
+    }
+}
+
+static ChannelMessage* Channel__try_pop(Channel* self) {
+    int64_t pos = c11__atomic_load(&self->dequeue_pos);
+    while(true) {
+        ChannelCell* cell = &self->cells[pos & self->mask];
+        int64_t diff = c11__atomic_load(&cell->seq) - (pos + 1);
+        if(diff == 0) {
+            if(c11__atomic_cas(&self->dequeue_pos, pos, pos + 1)) {
+                ChannelMessage* msg = cell->msg;
+                c11__atomic_store(&cell->seq, pos + self->mask + 1);
+                return msg;
+            }
+        } else if(diff < 0) {
+            return NULL;  // empty
+        }
+        pos = c11__atomic_load(&self->dequeue_pos);
+    }
+}
+
+static void Channel__release(Channel* self) {
+    c11_spinlock__lock(&Channel__registry_lock);
+    bool is_last = --self->refcount == 0;
+    if(is_last) {
+        Channel** p = &Channel__registry;
+        while(*p != self)
+            p = &(*p)->next;
+        *p = self->next;
+    }
+    c11_spinlock__unlock(&Channel__registry_lock);
+    if(!is_last) return;
+    ChannelMessage* msg;
+    while((msg = Channel__try_pop(self)) != NULL)
+        PK_FREE(msg);
+    PK_FREE(self->cells);
+    PK_FREE(self->name);
+    PK_FREE(self);
+}
+
+static void Channel__dtor(void* ud) { Channel__release(*(Channel**)ud); }
+
+static ChannelMessage* ChannelMessage__new(ChannelMessageKind kind, const void* data, int size) {
+    ChannelMessage* self = PK_MALLOC(sizeof(ChannelMessage) + size);
+    self->kind = kind;
+    self->n_cols = 0;
+    self->n_rows = 0;
+    self->size = size;
+    memcpy(self->data, data, size);
+    return self;
+}
+
+static bool array2d__is_trivially_copyable(c11_array2d* arr) {
+    // builtin value types have the same type id in every VM
+    for(int i = 0; i < arr->header.numel; i++) {
+        py_TValue* val = &arr->data[i];
+        if(val->is_ptr || val->type > tp_array2d_packed) return false;
+    }
+    return true;
+}
+
+static ChannelMessage* ChannelMessage__encode(py_Ref val) {
+    ChannelMessage* msg;
+    if(py_istype(val, tp_bytes)) {
+        int size;
+        unsigned char* data = py_tobytes(val, &size);
+        return ChannelMessage__new(ChannelMessage_BYTES, data, size);
+    }
+    if(py_istype(val, tp_array2d)) {
+        c11_array2d* arr = py_touserdata(val);
+        if(array2d__is_trivially_copyable(arr)) {
+            int size = arr->header.numel * sizeof(py_TValue);
+            msg = ChannelMessage__new(ChannelMessage_ARRAY2D, arr->data, size);
+            msg->n_cols = arr->header.n_cols;
+            msg->n_rows = arr->header.n_rows;
+            return msg;
+        }
+    }
+    if(!py_pickle_dumps(val)) return NULL;
+    int size;
+    unsigned char* data = py_tobytes(py_retval(), &size);
+    return ChannelMessage__new(ChannelMessage_PICKLE, data, size);
+}
+
+static bool ChannelMessage__decode(ChannelMessage* self) {
+    bool ok = true;
+    switch(self->kind) {
+        case ChannelMessage_PICKLE: ok = py_pickle_loads(self->data, self->size); break;
+        case ChannelMessage_BYTES: {
+            unsigned char* data = py_newbytes(py_retval(), self->size);
+            memcpy(data, self->data, self->size);
+            break;
+        }
+        case ChannelMessage_ARRAY2D: {
+            c11_array2d* arr = py_newarray2d(py_retval(), self->n_cols, self->n_rows);
+            memcpy(arr->data, self->data, self->size);
+            break;
+        }
+        default: c11__unreachable();
+    }
+    PK_FREE(self);
+    return ok;
+}
+
+static bool Channel__new__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(3);
+    PY_CHECK_ARG_TYPE(1, tp_str);
+    PY_CHECK_ARG_TYPE(2, tp_int);
+    py_i64 capacity = py_toint(py_arg(2));
+    if(capacity <= 0 || capacity > (1 << 24)) {
+        return ValueError("capacity must be in range [1, %d]", 1 << 24);
+    }
+    py_Type cls = py_totype(argv);
+    Channel** ud = py_newobject(py_retval(), cls, 0, sizeof(Channel*));
+    *ud = Channel__open(py_tostr(py_arg(1)), (int)capacity);
+    return true;
+}
+
+static bool Channel_name(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Channel* self = *(Channel**)py_touserdata(argv);
+    py_newstr(py_retval(), self->name);
+    return true;
+}
+
+static bool Channel_capacity(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Channel* self = *(Channel**)py_touserdata(argv);
+    py_newint(py_retval(), self->mask + 1);
+    return true;
+}
+
+static bool Channel__len__(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Channel* self = *(Channel**)py_touserdata(argv);
+    int64_t n = c11__atomic_load(&self->enqueue_pos) - c11__atomic_load(&self->dequeue_pos);
+    py_newint(py_retval(), c11__max(n, 0));
+    return true;
+}
+
+static bool Channel_send(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    Channel* self = *(Channel**)py_touserdata(argv);
+    ChannelMessage* msg = ChannelMessage__encode(py_arg(1));
+    if(msg == NULL) return false;
+    while(!Channel__try_push(self, msg))
+        c11_thrd__yield();
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool Channel_try_send(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    Channel* self = *(Channel**)py_touserdata(argv);
+    ChannelMessage* msg = ChannelMessage__encode(py_arg(1));
+    if(msg == NULL) return false;
+    bool ok = Channel__try_push(self, msg);
+    if(!ok) PK_FREE(msg);
+    py_newbool(py_retval(), ok);
+    return true;
+}
+
+static bool Channel_recv(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    Channel* self = *(Channel**)py_touserdata(argv);
+    ChannelMessage* msg;
+    while((msg = Channel__try_pop(self)) == NULL)
+        c11_thrd__yield();
+    return ChannelMessage__decode(msg);
+}
+
+static bool Channel_try_recv(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    Channel* self = *(Channel**)py_touserdata(argv);
+    ChannelMessage* msg = Channel__try_pop(self);
+    if(msg == NULL) {
+        py_assign(py_retval(), py_arg(1));
+        return true;
+    }
+    return ChannelMessage__decode(msg);
+}
+
+void pk__add_module_channel() {
+    py_Ref mod = py_newmodule("channel");
+    py_Type type = py_newtype("Channel", tp_object, mod, Channel__dtor);
+
+    py_bind(py_tpobject(type), "__new__(cls, name, capacity=64)", Channel__new__);
+    py_bindmagic(type, __len__, Channel__len__);
+    py_bindproperty(type, "name", Channel_name, NULL);
+    py_bindproperty(type, "capacity", Channel_capacity, NULL);
+    py_bindmethod(type, "send", Channel_send);
+    py_bindmethod(type, "try_send", Channel_try_send);
+    py_bindmethod(type, "recv", Channel_recv);
+    py_bind(py_tpobject(type), "try_recv(self, default=None)", Channel_try_recv);
+}
@@ -17,10 +17,17 @@ static bool disassemble(CodeObject* co) {
     c11_sbuf ss;
     c11_sbuf__ctor(&ss);
 
+    c11_vector /*T=BytecodeEx*/ codes_ex;
+    c11_vector__ctor(&codes_ex, sizeof(BytecodeEx));
+    CodeObject__unpack_linetable(co, &codes_ex);
+
     int prev_line = -1;
+    int ext = 0;  // high bits from the previous `EXTENDED_ARG`
     for(int i = 0; i < co->codes.length; i++) {
         Bytecode byte = c11__getitem(Bytecode, &co->codes, i);
-        BytecodeEx ex = c11__getitem(BytecodeEx, &co->codes_ex, i);
+        BytecodeEx ex = c11__getitem(BytecodeEx, &codes_ex, i);
+        int arg = ext << 16 | byte.arg;
+        ext = byte.op == OP_EXTENDED_ARG ? byte.arg : 0;
 
         char line[8] = "";
         if(ex.lineno == prev_line) {
@@ -55,52 +62,72 @@ static bool disassemble(CodeObject* co) {
                 break;
             }
 
-            c11_sbuf__write_int(&ss, byte.arg);
+            c11_sbuf__write_int(&ss, arg);
             switch(byte.op) {
                 // TODO: see `dis.py` there is a memory issue
                 case OP_LOAD_CONST: {
-                    py_Ref value = c11__at(py_TValue, &co->consts, byte.arg);
+                    py_Ref value = c11__at(py_TValue, &co->consts, arg);
                     if(py_repr(value)) {
                         pk_sprintf(&ss, " (%v)", py_tosv(py_retval()));
                     } else {
+                        c11_sbuf__dtor(&ss);
+                        c11_vector__dtor(&codes_ex);
+                        c11_vector__dtor(&jumpTargets);
                         return false;
                     }
                     break;
                 }
                 case OP_FORMAT_STRING:
                 case OP_IMPORT_PATH: {
-                    py_Ref path = c11__at(py_TValue, &co->consts, byte.arg);
+                    py_Ref path = c11__at(py_TValue, &co->consts, arg);
                     pk_sprintf(&ss, " (%q)", py_tosv(path));
                     break;
                 }
+                case OP_LOAD_ATTR:
+                case OP_LOAD_METHOD:
+                case OP_STORE_ATTR: {
+                    InlineCache* cache = c11__at(InlineCache, &co->inline_caches, arg);
+                    pk_sprintf(&ss, " (%n)", cache->name);
+                    break;
+                }
                 case OP_LOAD_NAME:
                 case OP_LOAD_GLOBAL:
                 case OP_LOAD_NONLOCAL:
                 case OP_STORE_GLOBAL:
-                case OP_LOAD_ATTR:
-                case OP_LOAD_METHOD:
-                case OP_STORE_ATTR:
                 case OP_DELETE_ATTR:
                 case OP_BEGIN_CLASS:
                 case OP_DELETE_GLOBAL:
                 case OP_STORE_CLASS_ATTR: {
-                    pk_sprintf(&ss, " (%n)", byte.arg);
+                    pk_sprintf(&ss, " (%n)", arg);
                     break;
                 }
                 case OP_LOAD_FAST:
                 case OP_STORE_FAST:
                 case OP_DELETE_FAST: {
-                    py_Name name = c11__getitem(py_Name, &co->varnames, byte.arg);
+                    py_Name name = c11__getitem(py_Name, &co->varnames, arg);
                     pk_sprintf(&ss, " (%n)", name);
                     break;
                 }
+                case OP_LOAD_FAST_LOAD_FAST: {
+                    py_Name a = c11__getitem(py_Name, &co->varnames, arg >> 8);
+                    py_Name b = c11__getitem(py_Name, &co->varnames, arg & 0xFF);
+                    pk_sprintf(&ss, " (%n, %n)", a, b);
+                    break;
+                }
+                case OP_LOAD_FAST_LOAD_ATTR: {
+                    py_Name a = c11__getitem(py_Name, &co->varnames, arg >> 8);
+                    int index = arg & 0xFF;
+                    InlineCache* cache = c11__at(InlineCache, &co->inline_caches, index);
+                    pk_sprintf(&ss, " (%n.%n)", a, cache->name);
+                    break;
+                }
                 case OP_LOAD_FUNCTION: {
-                    const FuncDecl* decl = c11__getitem(FuncDecl*, &co->func_decls, byte.arg);
+                    const FuncDecl* decl = c11__getitem(FuncDecl*, &co->func_decls, arg);
                     pk_sprintf(&ss, " (%s)", decl->code.name->data);
                     break;
                 }
                 case OP_BINARY_OP: {
-                    py_Name name = byte.arg & 0xFF;
+                    py_Name name = arg & 0xFF;
                     pk_sprintf(&ss, " (%s)", pk_op2str(name));
                     break;
                 }
@@ -114,6 +141,7 @@ static bool disassemble(CodeObject* co) {
     pk_current_vm->callbacks.print(output->data);
     pk_current_vm->callbacks.print("\n");
     c11_string__delete(output);
+    c11_vector__dtor(&codes_ex);
     c11_vector__dtor(&jumpTargets);
     return true;
 }
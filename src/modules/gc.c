@@ -32,6 +32,52 @@ static bool gc_isenabled(int argc, py_Ref argv){
     return true;
 }
 
+static bool gc_set_mode(int argc, py_Ref argv){
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    ManagedHeap* heap = &pk_current_vm->heap;
+    const char* mode = py_tostr(argv);
+    if(strcmp(mode, "full") == 0) {
+        heap->gc_mode = GC_MODE_FULL;
+    } else if(strcmp(mode, "lazy_sweep") == 0) {
+        heap->gc_mode = GC_MODE_LAZY_SWEEP;
+    } else {
+        return ValueError("invalid gc mode: %q", py_tosv(argv));
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool gc_get_mode(int argc, py_Ref argv){
+    PY_CHECK_ARGC(0);
+    ManagedHeap* heap = &pk_current_vm->heap;
+    py_newstr(py_retval(), heap->gc_mode == GC_MODE_LAZY_SWEEP ? "lazy_sweep" : "full");
+    return true;
+}
+
+static bool gc_set_sweep_threads(int argc, py_Ref argv){
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_int);
+    ManagedHeap* heap = &pk_current_vm->heap;
+    py_i64 n = py_toint(argv);
+    if(n < 1 || n > PK_GC_MAX_SWEEP_THREADS) {
+        return ValueError("sweep threads must be in [1, %d]", PK_GC_MAX_SWEEP_THREADS);
+    }
+#if !PK_ENABLE_THREADS
+    if(n > 1) return RuntimeError("threads are not enabled in this build");
+#endif
+    heap->gc_sweep_threads = (int)n;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool gc_get_sweep_threads(int argc, py_Ref argv){
+    PY_CHECK_ARGC(0);
+    ManagedHeap* heap = &pk_current_vm->heap;
+    py_newint(py_retval(), heap->gc_sweep_threads);
+    return true;
+}
+
 void pk__add_module_gc() {
     py_Ref mod = py_newmodule("gc");
 
@@ -39,4 +85,8 @@ void pk__add_module_gc() {
     py_bindfunc(mod, "enable", gc_enable);
     py_bindfunc(mod, "disable", gc_disable);
     py_bindfunc(mod, "isenabled", gc_isenabled);
+    py_bindfunc(mod, "set_mode", gc_set_mode);
+    py_bindfunc(mod, "get_mode", gc_get_mode);
+    py_bindfunc(mod, "set_sweep_threads", gc_set_sweep_threads);
+    py_bindfunc(mod, "get_sweep_threads", gc_get_sweep_threads);
 }
\ No newline at end of file
@@ -1,13 +1,71 @@
 #include "pocketpy/pocketpy.h"
 
+#include "pocketpy/common/utils.h"
+
+#include <stdlib.h>
+
 static bool importlib_reload(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     PY_CHECK_ARG_TYPE(0, tp_module);
     return py_importlib_reload(argv);
 }
 
+static bool importlib_set_cache_dir(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    if(py_isnone(argv)) {
+        py_importlib_setcachedir(NULL);
+    } else {
+        PY_CHECK_ARG_TYPE(0, tp_str);
+        py_importlib_setcachedir(py_tostr(argv));
+    }
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool importlib_compile(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    int res = py_importlib_compile(py_tostr(argv));
+    if(res == -1) return false;
+    py_newbool(py_retval(), res == 1);
+    return true;
+}
+
+static bool importlib_make_bundle(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    PY_CHECK_ARG_TYPE(1, tp_list);
+    int count = py_list_len(py_arg(1));
+    const char** modules = PK_MALLOC(sizeof(const char*) * (count + 1));
+    for(int i = 0; i < count; i++) {
+        py_Ref item = py_list_getitem(py_arg(1), i);
+        if(!py_checkstr(item)) {
+            PK_FREE(modules);
+            return false;
+        }
+        modules[i] = py_tostr(item);
+    }
+    bool ok = py_importlib_makebundle(py_tostr(argv), modules, count);
+    PK_FREE(modules);
+    if(!ok) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
+static bool importlib_mount_bundle(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(1);
+    PY_CHECK_ARG_TYPE(0, tp_str);
+    if(!py_importlib_mountbundle(py_tostr(argv))) return false;
+    py_newnone(py_retval());
+    return true;
+}
+
 void pk__add_module_importlib() {
     py_Ref mod = py_newmodule("importlib");
 
     py_bindfunc(mod, "reload", importlib_reload);
-}
\ No newline at end of file
+    py_bindfunc(mod, "set_cache_dir", importlib_set_cache_dir);
+    py_bindfunc(mod, "compile", importlib_compile);
+    py_bindfunc(mod, "make_bundle", importlib_make_bundle);
+    py_bindfunc(mod, "mount_bundle", importlib_mount_bundle);
+}
@@ -5,6 +5,9 @@
 #include "pocketpy/common/sstream.h"
 #include "pocketpy/interpreter/vm.h"
 #include <math.h>
+#include <ctype.h>
+#include <string.h>
+#include <stdlib.h>
 
 static bool json_loads(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
@@ -131,9 +134,341 @@ bool py_json_dumps(py_Ref val) {
     return true;
 }
 
+typedef struct {
+    const char* begin;
+    const char* curr;
+    const char* end;
+    int depth;
+} json__Parser;
+
+static bool json__error(json__Parser* p, const char* msg) {
+    int pos = (int)(p->curr - p->begin);
+    int lineno = 1;
+    const char* line_start = p->begin;
+    for(const char* i = p->begin; i < p->curr; i++) {
+        if(*i == '\n') {
+            lineno++;
+            line_start = i + 1;
+        }
+    }
+    int colno = (int)(p->curr - line_start) + 1;
+    return ValueError("%s: line %d column %d (char %d)", msg, lineno, colno, pos);
+}
+
+static void json__skip_ws(json__Parser* p) {
+    while(p->curr < p->end) {
+        char c = *p->curr;
+        if(c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+        p->curr++;
+    }
+}
+
+static bool json__match(json__Parser* p, const char* word) {
+    int n = (int)strlen(word);
+    if(p->end - p->curr < n) return false;
+    if(memcmp(p->curr, word, n) != 0) return false;
+    p->curr += n;
+    return true;
+}
+
+static int json__hex4(const char* s) {
+    int value = 0;
+    for(int i = 0; i < 4; i++) {
+        char c = s[i];
+        value <<= 4;
+        if(c >= '0' && c <= '9') {
+            value |= c - '0';
+        } else if(c >= 'a' && c <= 'f') {
+            value |= c - 'a' + 10;
+        } else if(c >= 'A' && c <= 'F') {
+            value |= c - 'A' + 10;
+        } else {
+            return -1;
+        }
+    }
+    return value;
+}
+
+static bool json__parse_string(json__Parser* p, py_OutRef out) {
+    // p->curr points to the opening quote
+    const char* start = ++p->curr;
+    // fast path: no escapes
+    while(p->curr < p->end) {
+        unsigned char c = *p->curr;
+        if(c == '"' || c == '\\' || c < 0x20) break;
+        p->curr++;
+    }
+    if(p->curr >= p->end) {
+        p->curr = start - 1;
+        return json__error(p, "Unterminated string starting at");
+    }
+    if(*p->curr == '"') {
+        py_newstrv(out, (c11_sv){start, (int)(p->curr - start)});
+        p->curr++;
+        return true;
+    }
+    // slow path: decode escapes into a buffer
+    c11_sbuf buf;
+    c11_sbuf__ctor(&buf);
+    c11_sbuf__write_cstrn(&buf, start, (int)(p->curr - start));
+    while(true) {
+        if(p->curr >= p->end) {
+            c11_sbuf__dtor(&buf);
+            p->curr = start - 1;
+            return json__error(p, "Unterminated string starting at");
+        }
+        unsigned char c = *p->curr;
+        if(c == '"') {
+            p->curr++;
+            break;
+        }
+        if(c < 0x20) {
+            c11_sbuf__dtor(&buf);
+            return json__error(p, "Invalid control character at");
+        }
+        if(c != '\\') {
+            c11_sbuf__write_char(&buf, c);
+            p->curr++;
+            continue;
+        }
+        if(p->end - p->curr < 2) {
+            c11_sbuf__dtor(&buf);
+            p->curr = start - 1;
+            return json__error(p, "Unterminated string starting at");
+        }
+        char esc = p->curr[1];
+        p->curr += 2;
+        switch(esc) {
+            case '"': c11_sbuf__write_char(&buf, '"'); break;
+            case '\\': c11_sbuf__write_char(&buf, '\\'); break;
+            case '/': c11_sbuf__write_char(&buf, '/'); break;
+            case 'b': c11_sbuf__write_char(&buf, '\b'); break;
+            case 'f': c11_sbuf__write_char(&buf, '\f'); break;
+            case 'n': c11_sbuf__write_char(&buf, '\n'); break;
+            case 'r': c11_sbuf__write_char(&buf, '\r'); break;
+            case 't': c11_sbuf__write_char(&buf, '\t'); break;
+            case 'u': {
+                int code = p->end - p->curr >= 4 ? json__hex4(p->curr) : -1;
+                if(code < 0) {
+                    c11_sbuf__dtor(&buf);
+                    p->curr -= 2;
+                    return json__error(p, "Invalid \\uXXXX escape");
+                }
+                p->curr += 4;
+                // combine utf-16 surrogate pairs
+                if(code >= 0xD800 && code <= 0xDBFF && p->end - p->curr >= 6 &&
+                   p->curr[0] == '\\' && p->curr[1] == 'u') {
+                    int low = json__hex4(p->curr + 2);
+                    if(low >= 0xDC00 && low <= 0xDFFF) {
+                        code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        p->curr += 6;
+                    }
+                }
+                char utf8[4];
+                int n = c11__u32_to_u8(code, utf8);
+                c11_sbuf__write_cstrn(&buf, utf8, n);
+                break;
+            }
+            default:
+                c11_sbuf__dtor(&buf);
+                p->curr -= 2;
+                return json__error(p, "Invalid \\escape");
+        }
+    }
+    c11_sbuf__py_submit(&buf, out);
+    return true;
+}
+
+static bool json__parse_number(json__Parser* p, py_OutRef out) {
+    const char* start = p->curr;
+    bool is_float = false;
+    if(*p->curr == '-') p->curr++;
+    if(p->curr < p->end && *p->curr == 'I') {
+        if(!json__match(p, "Infinity")) return json__error(p, "Expecting value");
+        py_newfloat(out, -INFINITY);
+        return true;
+    }
+    const char* digits = p->curr;
+    if(p->curr < p->end && *p->curr == '0') {
+        p->curr++;  // leading zeros are not allowed
+    } else {
+        while(p->curr < p->end && isdigit((unsigned char)*p->curr))
+            p->curr++;
+    }
+    if(p->curr == digits) {
+        p->curr = start;
+        return json__error(p, "Expecting value");
+    }
+    if(p->curr < p->end && *p->curr == '.') {
+        is_float = true;
+        p->curr++;
+        const char* frac = p->curr;
+        while(p->curr < p->end && isdigit((unsigned char)*p->curr))
+            p->curr++;
+        if(p->curr == frac) return json__error(p, "Expecting fraction digits");
+    }
+    if(p->curr < p->end && (*p->curr == 'e' || *p->curr == 'E')) {
+        is_float = true;
+        p->curr++;
+        if(p->curr < p->end && (*p->curr == '+' || *p->curr == '-')) p->curr++;
+        const char* exp = p->curr;
+        while(p->curr < p->end && isdigit((unsigned char)*p->curr))
+            p->curr++;
+        if(p->curr == exp) return json__error(p, "Expecting exponent digits");
+    }
+    if(!is_float) {
+        c11_sv text = {digits, (int)(p->curr - digits)};
+        int64_t value;
+        if(c11__parse_uint(text, &value, 10) == IntParsing_SUCCESS) {
+            py_newint(out, *start == '-' ? -value : value);
+            return true;
+        }
+        p->curr = start;
+        return json__error(p, "int literal is too large");
+    }
+    char* p_end;
+    double value = strtod(start, &p_end);
+    if(p_end != p->curr) {
+        p->curr = start;
+        return json__error(p, "Invalid number");
+    }
+    py_newfloat(out, value);
+    return true;
+}
+
+static bool json__parse_value(json__Parser* p, py_OutRef out);
+
+static bool json__enter(json__Parser* p) {
+    VM* vm = pk_current_vm;
+    // each nesting level needs at most 2 stack slots
+    if(p->depth >= vm->max_recursion_depth || vm->stack.end - vm->stack.sp < 8) {
+        return py_exception(tp_RecursionError, "maximum recursion depth exceeded");
+    }
+    p->depth++;
+    p->curr++;
+    json__skip_ws(p);
+    return true;
+}
+
+static bool json__parse_array(json__Parser* p, py_OutRef out) {
+    if(!json__enter(p)) return false;
+    py_newlist(out);
+    if(p->curr < p->end && *p->curr == ']') {
+        p->curr++;
+        p->depth--;
+        return true;
+    }
+    py_StackRef item = py_pushtmp();
+    while(true) {
+        if(!json__parse_value(p, item)) return false;
+        py_list_append(out, item);
+        json__skip_ws(p);
+        if(p->curr < p->end && *p->curr == ',') {
+            p->curr++;
+            continue;
+        }
+        if(p->curr < p->end && *p->curr == ']') {
+            p->curr++;
+            break;
+        }
+        return json__error(p, "Expecting ',' delimiter");
+    }
+    py_pop();
+    p->depth--;
+    return true;
+}
+
+static bool json__parse_object(json__Parser* p, py_OutRef out) {
+    if(!json__enter(p)) return false;
+    py_newdict(out);
+    if(p->curr < p->end && *p->curr == '}') {
+        p->curr++;
+        p->depth--;
+        return true;
+    }
+    py_StackRef key = py_pushtmp();
+    py_StackRef val = py_pushtmp();
+    while(true) {
+        json__skip_ws(p);
+        if(p->curr >= p->end || *p->curr != '"') {
+            return json__error(p, "Expecting property name enclosed in double quotes");
+        }
+        if(!json__parse_string(p, key)) return false;
+        json__skip_ws(p);
+        if(p->curr >= p->end || *p->curr != ':') return json__error(p, "Expecting ':' delimiter");
+        p->curr++;
+        if(!json__parse_value(p, val)) return false;
+        if(!py_dict_setitem(out, key, val)) return false;
+        json__skip_ws(p);
+        if(p->curr < p->end && *p->curr == ',') {
+            p->curr++;
+            continue;
+        }
+        if(p->curr < p->end && *p->curr == '}') {
+            p->curr++;
+            break;
+        }
+        return json__error(p, "Expecting ',' delimiter");
+    }
+    py_shrink(2);
+    p->depth--;
+    return true;
+}
+
+static bool json__parse_value(json__Parser* p, py_OutRef out) {
+    json__skip_ws(p);
+    if(p->curr >= p->end) return json__error(p, "Expecting value");
+    switch(*p->curr) {
+        case '{': return json__parse_object(p, out);
+        case '[': return json__parse_array(p, out);
+        case '"': return json__parse_string(p, out);
+        case 'n':
+            if(!json__match(p, "null")) break;
+            py_newnone(out);
+            return true;
+        case 't':
+            if(!json__match(p, "true")) break;
+            py_newbool(out, true);
+            return true;
+        case 'f':
+            if(!json__match(p, "false")) break;
+            py_newbool(out, false);
+            return true;
+        case 'N':
+            if(!json__match(p, "NaN")) break;
+            py_newfloat(out, NAN);
+            return true;
+        case 'I':
+            if(!json__match(p, "Infinity")) break;
+            py_newfloat(out, INFINITY);
+            return true;
+        default:
+            if(*p->curr == '-' || isdigit((unsigned char)*p->curr)) {
+                return json__parse_number(p, out);
+            }
+            break;
+    }
+    return json__error(p, "Expecting value");
+}
+
 bool py_json_loads(const char* source) {
-    py_GlobalRef mod = py_getmodule("json");
-    return py_exec(source, "<json>", EVAL_MODE, mod);
+    json__Parser p = {
+        .begin = source,
+        .curr = source,
+        .end = source + strlen(source),
+        .depth = 0,
+    };
+    py_StackRef p0 = py_peek(0);
+    py_StackRef res = py_pushtmp();
+    bool ok = json__parse_value(&p, res);
+    if(ok) {
+        json__skip_ws(&p);
+        if(p.curr != p.end) ok = json__error(&p, "Extra data");
+    }
+    if(ok) py_assign(py_retval(), res);
+    // discard any partially built containers
+    py_shrink((int)(py_peek(0) - p0));
+    return ok;
 }
 
 bool py_pusheval(const char* expr, py_GlobalRef module) {
@@ -4,6 +4,7 @@
 #include "pocketpy/common/utils.h"
 #include "pocketpy/interpreter/vm.h"
 #include "pocketpy/objects/object.h"
+#include <limits.h>
 #include <math.h>
 
 static bool isclose(float a, float b) { return fabs(a - b) < 1e-4; }
@@ -603,6 +604,16 @@ static bool mat3x3__matmul__(int argc, py_Ref argv) {
         res.y = lhs->_21 * rhs.x + lhs->_22 * rhs.y + lhs->_23 * rhs.z;
         res.z = lhs->_31 * rhs.x + lhs->_32 * rhs.y + lhs->_33 * rhs.z;
         py_newvec3(py_retval(), res);
+    } else if(argv[1].type == tp_vec3_array) {
+        int length;
+        const c11_vec3* rhs = py_tovec3array(&argv[1], &length);
+        c11_vec3* out = py_newvec3array(py_retval(), length);
+        for(int i = 0; i < length; i++) {
+            c11_vec3 v = rhs[i];
+            out[i].x = lhs->_11 * v.x + lhs->_12 * v.y + lhs->_13 * v.z;
+            out[i].y = lhs->_21 * v.x + lhs->_22 * v.y + lhs->_23 * v.z;
+            out[i].z = lhs->_31 * v.x + lhs->_32 * v.y + lhs->_33 * v.z;
+        }
     } else {
         py_newnotimplemented(py_retval());
     }
@@ -836,6 +847,437 @@ static bool vec3__with_xy(int argc, py_Ref argv) {
     return true;
 }
 
+/* vec2_array, vec3_array */
+typedef struct c11_vec_array {
+    int length;
+    float data[];  // `length * D` packed floats, e.g. `x0, y0, x1, y1, ...`
+} c11_vec_array;
+
+static c11_vec_array* vec_array__new(py_OutRef out, py_Type type, int D, int length) {
+    c11_vec_array* ud =
+        py_newobject(out, type, 0, sizeof(c11_vec_array) + sizeof(float) * D * length);
+    ud->length = length;
+    memset(ud->data, 0, sizeof(float) * D * length);
+    return ud;
+}
+
+static bool vec_array__check_length(py_i64 length, int D) {
+    if(length < 0 || length > (INT_MAX - 64) / (int)(sizeof(float) * D)) {
+        return ValueError("invalid length: %i", length);
+    }
+    return true;
+}
+
+c11_vec2* py_newvec2array(py_OutRef out, int length) {
+    return (c11_vec2*)vec_array__new(out, tp_vec2_array, 2, length)->data;
+}
+
+c11_vec2* py_tovec2array(py_Ref self, int* length) {
+    assert(self->type == tp_vec2_array);
+    c11_vec_array* ud = py_touserdata(self);
+    *length = ud->length;
+    return (c11_vec2*)ud->data;
+}
+
+c11_vec3* py_newvec3array(py_OutRef out, int length) {
+    return (c11_vec3*)vec_array__new(out, tp_vec3_array, 3, length)->data;
+}
+
+c11_vec3* py_tovec3array(py_Ref self, int* length) {
+    assert(self->type == tp_vec3_array);
+    c11_vec_array* ud = py_touserdata(self);
+    *length = ud->length;
+    return (c11_vec3*)ud->data;
+}
+
+// `other` is an array of the same length (stride D) or a vector/scalar broadcasted from `buf`
+// returns 1 on success, 0 if not supported, -1 on error
+static int vec_array__operand(const c11_vec_array* self,
+                              int D,
+                              py_Ref other,
+                              float* buf,
+                              const float** out,
+                              bool* broadcast) {
+    if(other->type == (D == 2 ? tp_vec2_array : tp_vec3_array)) {
+        const c11_vec_array* rhs = py_touserdata(other);
+        if(rhs->length != self->length) {
+            ValueError("length mismatch: %d != %d", self->length, rhs->length);
+            return -1;
+        }
+        *out = rhs->data;
+        *broadcast = false;
+        return 1;
+    }
+    if(other->type == (D == 2 ? tp_vec2 : tp_vec3)) {
+        if(D == 2) {
+            c11_vec2 v = py_tovec2(other);
+            memcpy(buf, v.data, sizeof(float) * 2);
+        } else {
+            c11_vec3 v = py_tovec3(other);
+            memcpy(buf, v.data, sizeof(float) * 3);
+        }
+    } else if(other->type == tp_int || other->type == tp_float) {
+        float s;
+        py_castfloat32(other, &s);
+        for(int k = 0; k < D; k++)
+            buf[k] = s;
+    } else {
+        return 0;
+    }
+    *out = buf;
+    *broadcast = true;
+    return 1;
+}
+
+#define DEF_VEC_ARRAY_ZIP(name, op)                                                                \
+    static void vec_array__##name(float* out,                                                      \
+                                  const float* a,                                                  \
+                                  const float* b,                                                  \
+                                  bool broadcast,                                                  \
+                                  int length,                                                      \
+                                  int D) {                                                         \
+        if(!broadcast) {                                                                           \
+            for(int i = 0; i < length * D; i++)                                                    \
+                out[i] = a[i] op b[i];                                                             \
+        } else if(D == 2) {                                                                        \
+            float b0 = b[0], b1 = b[1];                                                            \
+            for(int i = 0; i < length * 2; i += 2) {                                               \
+                out[i] = a[i] op b0;                                                               \
+                out[i + 1] = a[i + 1] op b1;                                                       \
+            }                                                                                      \
+        } else {                                                                                   \
+            float b0 = b[0], b1 = b[1], b2 = b[2];                                                 \
+            for(int i = 0; i < length * 3; i += 3) {                                               \
+                out[i] = a[i] op b0;                                                               \
+                out[i + 1] = a[i + 1] op b1;                                                       \
+                out[i + 2] = a[i + 2] op b2;                                                       \
+            }                                                                                      \
+        }                                                                                          \
+    }
+
+DEF_VEC_ARRAY_ZIP(add, +)
+DEF_VEC_ARRAY_ZIP(sub, -)
+DEF_VEC_ARRAY_ZIP(mul, *)
+
+static void vec_array__lerp(float* out,
+                            const float* a,
+                            const float* b,
+                            bool broadcast,
+                            int length,
+                            int D,
+                            float t) {
+    if(!broadcast) {
+        for(int i = 0; i < length * D; i++)
+            out[i] = a[i] + (b[i] - a[i]) * t;
+    } else {
+        for(int i = 0; i < length; i++) {
+            for(int k = 0; k < D; k++)
+                out[i * D + k] = a[i * D + k] + (b[k] - a[i * D + k]) * t;
+        }
+    }
+}
+
+static void vec_array__normalize(float* out, const float* a, int length, int D) {
+    // zero vectors stay zero instead of raising halfway through the batch
+    for(int i = 0; i < length; i++) {
+        float sum = 0;
+        for(int k = 0; k < D; k++)
+            sum += a[i * D + k] * a[i * D + k];
+        float inv = sum > 0 ? 1.0f / sqrtf(sum) : 0.0f;
+        for(int k = 0; k < D; k++)
+            out[i * D + k] = a[i * D + k] * inv;
+    }
+}
+
+static void vec2_array__transform(float* out,
+                                  const float* a,
+                                  int length,
+                                  const c11_mat3x3* m,
+                                  float w) {
+    float m11 = m->_11, m12 = m->_12, m21 = m->_21, m22 = m->_22;
+    float tx = m->_13 * w, ty = m->_23 * w;
+    for(int i = 0; i < length * 2; i += 2) {
+        float x = a[i], y = a[i + 1];
+        out[i] = m11 * x + m12 * y + tx;
+        out[i + 1] = m21 * x + m22 * y + ty;
+    }
+}
+
+static void vec3_array__transform(float* out, const float* a, int length, const c11_mat3x3* m) {
+    for(int i = 0; i < length * 3; i += 3) {
+        float x = a[i], y = a[i + 1], z = a[i + 2];
+        out[i] = m->_11 * x + m->_12 * y + m->_13 * z;
+        out[i + 1] = m->_21 * x + m->_22 * y + m->_23 * z;
+        out[i + 2] = m->_31 * x + m->_32 * y + m->_33 * z;
+    }
+}
+
+#define DEF_VEC_ARRAY_BINARY_OP(D, name)                                                           \
+    static bool vec##D##_array__##name##__(int argc, py_Ref argv) {                                \
+        PY_CHECK_ARGC(2);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        float buf[D];                                                                              \
+        const float* b;                                                                            \
+        bool broadcast;                                                                            \
+        int code = vec_array__operand(self, D, &argv[1], buf, &b, &broadcast);                     \
+        if(code == -1) return false;                                                               \
+        if(code == 0) {                                                                            \
+            py_newnotimplemented(py_retval());                                                     \
+            return true;                                                                           \
+        }                                                                                          \
+        c11_vec_array* res = vec_array__new(py_retval(), tp_vec##D##_array, D, self->length);      \
+        vec_array__##name(res->data, self->data, b, broadcast, self->length, D);                   \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_##name##_(int argc, py_Ref argv) {                                  \
+        PY_CHECK_ARGC(2);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        float buf[D];                                                                              \
+        const float* b;                                                                            \
+        bool broadcast;                                                                            \
+        int code = vec_array__operand(self, D, &argv[1], buf, &b, &broadcast);                     \
+        if(code == -1) return false;                                                               \
+        if(code == 0) {                                                                            \
+            return TypeError("expected vec" #D "_array, vec" #D " or float, got '%t'",             \
+                             argv[1].type);                                                        \
+        }                                                                                          \
+        vec_array__##name(self->data, self->data, b, broadcast, self->length, D);                  \
+        py_newnone(py_retval());                                                                   \
+        return true;                                                                               \
+    }
+
+#define DEF_VEC_ARRAY_OPS(D)                                                                       \
+    static bool vec##D##_array__new__(int argc, py_Ref argv) {                                     \
+        PY_CHECK_ARGC(2);                                                                          \
+        py_Type cls = py_totype(argv);                                                             \
+        if(py_isint(&argv[1])) {                                                                   \
+            py_i64 length = py_toint(&argv[1]);                                                    \
+            if(!vec_array__check_length(length, D)) return false;                                  \
+            vec_array__new(py_retval(), cls, D, (int)length);                                      \
+            return true;                                                                           \
+        }                                                                                          \
+        if(!py_islist(&argv[1]) && !py_istuple(&argv[1])) {                                       \
+            return TypeError("expected int, list or tuple, got '%t'", argv[1].type);               \
+        }                                                                                          \
+        int length = py_islist(&argv[1]) ? py_list_len(&argv[1]) : py_tuple_len(&argv[1]);         \
+        py_TValue* items =                                                                         \
+            py_islist(&argv[1]) ? py_list_data(&argv[1]) : py_tuple_data(&argv[1]);              \
+        for(int i = 0; i < length; i++) {                                                          \
+            if(!py_checktype(&items[i], tp_vec##D)) return false;                                  \
+        }                                                                                          \
+        c11_vec_array* res = vec_array__new(py_retval(), cls, D, length);                          \
+        for(int i = 0; i < length; i++) {                                                          \
+            c11_vec##D v = py_tovec##D(&items[i]);                                                 \
+            memcpy(res->data + i * D, v.data, sizeof(float) * D);                                  \
+        }                                                                                          \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array__repr__(int argc, py_Ref argv) {                                    \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        char buf[64];                                                                              \
+        int size = snprintf(buf, 64, "vec" #D "_array(%d)", self->length);                         \
+        py_newstrv(py_retval(), (c11_sv){buf, size});                                              \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array__len__(int argc, py_Ref argv) {                                     \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        py_newint(py_retval(), self->length);                                                      \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array__getitem__(int argc, py_Ref argv) {                                 \
+        PY_CHECK_ARGC(2);                                                                          \
+        PY_CHECK_ARG_TYPE(1, tp_int);                                                              \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        int index = py_toint(&argv[1]);                                                            \
+        if(!pk__normalize_index(&index, self->length)) return false;                               \
+        c11_vec##D v;                                                                              \
+        memcpy(v.data, self->data + index * D, sizeof(float) * D);                                 \
+        py_newvec##D(py_retval(), v);                                                              \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array__setitem__(int argc, py_Ref argv) {                                 \
+        PY_CHECK_ARGC(3);                                                                          \
+        PY_CHECK_ARG_TYPE(1, tp_int);                                                              \
+        PY_CHECK_ARG_TYPE(2, tp_vec##D);                                                           \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        int index = py_toint(&argv[1]);                                                            \
+        if(!pk__normalize_index(&index, self->length)) return false;                               \
+        c11_vec##D v = py_tovec##D(&argv[2]);                                                      \
+        memcpy(self->data + index * D, v.data, sizeof(float) * D);                                 \
+        py_newnone(py_retval());                                                                   \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array__eq__(int argc, py_Ref argv) {                                      \
+        PY_CHECK_ARGC(2);                                                                          \
+        if(argv[1].type != tp_vec##D##_array) {                                                    \
+            py_newnotimplemented(py_retval());                                                     \
+            return true;                                                                           \
+        }                                                                                          \
+        c11_vec_array* lhs = py_touserdata(&argv[0]);                                              \
+        c11_vec_array* rhs = py_touserdata(&argv[1]);                                              \
+        bool eq = lhs->length == rhs->length;                                                      \
+        for(int i = 0; eq && i < lhs->length * D; i++)                                             \
+            eq = lhs->data[i] == rhs->data[i];                                                     \
+        py_newbool(py_retval(), eq);                                                               \
+        return true;                                                                               \
+    }                                                                                              \
+    DEFINE_BOOL_NE(vec##D##_array, vec##D##_array__eq__)                                           \
+    DEF_VEC_ARRAY_BINARY_OP(D, add)                                                                \
+    DEF_VEC_ARRAY_BINARY_OP(D, sub)                                                                \
+    DEF_VEC_ARRAY_BINARY_OP(D, mul)                                                                \
+    static bool vec##D##_array_dot(int argc, py_Ref argv) {                                        \
+        PY_CHECK_ARGC(2);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        float buf[D];                                                                              \
+        const float* b;                                                                            \
+        bool broadcast;                                                                            \
+        int code = vec_array__operand(self, D, &argv[1], buf, &b, &broadcast);                     \
+        if(code == -1) return false;                                                               \
+        if(code == 0 || argv[1].type == tp_int || argv[1].type == tp_float) {                      \
+            return TypeError("expected vec" #D "_array or vec" #D ", got '%t'", argv[1].type);     \
+        }                                                                                          \
+        /* floats are unboxed, building the list allocates nothing per item */                     \
+        py_newlistn(py_retval(), self->length);                                                    \
+        py_TValue* out = py_list_data(py_retval());                                                \
+        int step = broadcast ? 0 : D;                                                              \
+        for(int i = 0; i < self->length; i++) {                                                    \
+            float sum = 0;                                                                         \
+            for(int k = 0; k < D; k++)                                                             \
+                sum += self->data[i * D + k] * b[i * step + k];                                    \
+            py_newfloat(&out[i], sum);                                                             \
+        }                                                                                          \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_length(int argc, py_Ref argv) {                                     \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        py_newlistn(py_retval(), self->length);                                                    \
+        py_TValue* out = py_list_data(py_retval());                                                \
+        for(int i = 0; i < self->length; i++) {                                                    \
+            float sum = 0;                                                                         \
+            for(int k = 0; k < D; k++)                                                             \
+                sum += self->data[i * D + k] * self->data[i * D + k];                              \
+            py_newfloat(&out[i], sqrtf(sum));                                                      \
+        }                                                                                          \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_normalize(int argc, py_Ref argv) {                                  \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        c11_vec_array* res = vec_array__new(py_retval(), tp_vec##D##_array, D, self->length);      \
+        vec_array__normalize(res->data, self->data, self->length, D);                              \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_normalize_(int argc, py_Ref argv) {                                 \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        vec_array__normalize(self->data, self->data, self->length, D);                             \
+        py_newnone(py_retval());                                                                   \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_lerp(int argc, py_Ref argv) {                                       \
+        PY_CHECK_ARGC(3);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        float t;                                                                                   \
+        if(!py_castfloat32(&argv[2], &t)) return false;                                            \
+        float buf[D];                                                                              \
+        const float* b;                                                                            \
+        bool broadcast;                                                                            \
+        int code = vec_array__operand(self, D, &argv[1], buf, &b, &broadcast);                     \
+        if(code == -1) return false;                                                               \
+        if(code == 0 || argv[1].type == tp_int || argv[1].type == tp_float) {                      \
+            return TypeError("expected vec" #D "_array or vec" #D ", got '%t'", argv[1].type);     \
+        }                                                                                          \
+        c11_vec_array* res = vec_array__new(py_retval(), tp_vec##D##_array, D, self->length);      \
+        vec_array__lerp(res->data, self->data, b, broadcast, self->length, D, t);                  \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_copy(int argc, py_Ref argv) {                                       \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        c11_vec_array* res = vec_array__new(py_retval(), tp_vec##D##_array, D, self->length);      \
+        memcpy(res->data, self->data, sizeof(float) * D * self->length);                           \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_tolist(int argc, py_Ref argv) {                                     \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        py_newlistn(py_retval(), self->length);                                                    \
+        py_TValue* out = py_list_data(py_retval());                                                \
+        for(int i = 0; i < self->length; i++) {                                                    \
+            c11_vec##D v;                                                                          \
+            memcpy(v.data, self->data + i * D, sizeof(float) * D);                                 \
+            py_newvec##D(&out[i], v);                                                              \
+        }                                                                                          \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_tobytes(int argc, py_Ref argv) {                                    \
+        PY_CHECK_ARGC(1);                                                                          \
+        c11_vec_array* self = py_touserdata(argv);                                                 \
+        int size = sizeof(float) * D * self->length;                                               \
+        unsigned char* p = py_newbytes(py_retval(), size);                                         \
+        memcpy(p, self->data, size);                                                               \
+        return true;                                                                               \
+    }                                                                                              \
+    static bool vec##D##_array_frombytes_STATIC(int argc, py_Ref argv) {                           \
+        PY_CHECK_ARGC(1);                                                                          \
+        PY_CHECK_ARG_TYPE(0, tp_bytes);                                                            \
+        int size;                                                                                  \
+        py_tobytes(argv, &size);                                                                   \
+        int itemsize = sizeof(float) * D;                                                          \
+        if(size % itemsize != 0) {                                                                 \
+            return ValueError("bytes size %d is not a multiple of %d", size, itemsize);            \
+        }                                                                                          \
+        c11_vec_array* res =                                                                       \
+            vec_array__new(py_retval(), tp_vec##D##_array, D, size / itemsize);                    \
+        memcpy(res->data, py_tobytes(argv, &size), size);                                          \
+        return true;                                                                               \
+    }
+
+DEF_VEC_ARRAY_OPS(2)
+DEF_VEC_ARRAY_OPS(3)
+
+static bool vec2_array__transform_impl(int argc, py_Ref argv, float w, bool inplace) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(1, tp_mat3x3);
+    c11_vec_array* self = py_touserdata(argv);
+    if(inplace) {
+        vec2_array__transform(self->data, self->data, self->length, py_tomat3x3(&argv[1]), w);
+        py_newnone(py_retval());
+        return true;
+    }
+    c11_vec_array* res = vec_array__new(py_retval(), tp_vec2_array, 2, self->length);
+    vec2_array__transform(res->data, self->data, self->length, py_tomat3x3(&argv[1]), w);
+    return true;
+}
+
+static bool vec2_array_transform_point(int argc, py_Ref argv) {
+    return vec2_array__transform_impl(argc, argv, 1, false);
+}
+
+static bool vec2_array_transform_vector(int argc, py_Ref argv) {
+    return vec2_array__transform_impl(argc, argv, 0, false);
+}
+
+static bool vec2_array_transform_point_(int argc, py_Ref argv) {
+    return vec2_array__transform_impl(argc, argv, 1, true);
+}
+
+static bool vec2_array_transform_vector_(int argc, py_Ref argv) {
+    return vec2_array__transform_impl(argc, argv, 0, true);
+}
+
+static bool vec3_array_transform_(int argc, py_Ref argv) {
+    PY_CHECK_ARGC(2);
+    PY_CHECK_ARG_TYPE(1, tp_mat3x3);
+    c11_vec_array* self = py_touserdata(argv);
+    vec3_array__transform(self->data, self->data, self->length, py_tomat3x3(&argv[1]));
+    py_newnone(py_retval());
+    return true;
+}
+
 void pk__add_module_linalg() {
     py_Ref mod = py_newmodule("linalg");
 
@@ -999,8 +1441,60 @@ void pk__add_module_linalg() {
     });
 }
 
+// `vec2_array` and `vec3_array` are registered after the array2d types,
+// so that the ids of the existing entries in `py_PredefinedType` are kept
+void pk__add_module_linalg_arrays() {
+    py_GlobalRef mod = py_getmodule("linalg");
+
+    py_Type vec2_array = pk_newtype("vec2_array", tp_object, mod, NULL, false, true);
+    py_Type vec3_array = pk_newtype("vec3_array", tp_object, mod, NULL, false, true);
+
+    py_setdict(mod, py_name("vec2_array"), py_tpobject(vec2_array));
+    py_setdict(mod, py_name("vec3_array"), py_tpobject(vec3_array));
+
+    assert(vec2_array == tp_vec2_array);
+    assert(vec3_array == tp_vec3_array);
+
+#define BIND_VEC_ARRAY(D)                                                                          \
+    py_bindmagic(vec##D##_array, __new__, vec##D##_array__new__);                                  \
+    py_bindmagic(vec##D##_array, __repr__, vec##D##_array__repr__);                                \
+    py_bindmagic(vec##D##_array, __len__, vec##D##_array__len__);                                  \
+    py_bindmagic(vec##D##_array, __getitem__, vec##D##_array__getitem__);                          \
+    py_bindmagic(vec##D##_array, __setitem__, vec##D##_array__setitem__);                          \
+    py_bindmagic(vec##D##_array, __eq__, vec##D##_array__eq__);                                    \
+    py_bindmagic(vec##D##_array, __ne__, vec##D##_array__ne__);                                    \
+    py_bindmagic(vec##D##_array, __add__, vec##D##_array__add__);                                  \
+    py_bindmagic(vec##D##_array, __sub__, vec##D##_array__sub__);                                  \
+    py_bindmagic(vec##D##_array, __mul__, vec##D##_array__mul__);                                  \
+    py_bindmethod(vec##D##_array, "add_", vec##D##_array_add_);                                    \
+    py_bindmethod(vec##D##_array, "sub_", vec##D##_array_sub_);                                    \
+    py_bindmethod(vec##D##_array, "mul_", vec##D##_array_mul_);                                    \
+    py_bindmethod(vec##D##_array, "dot", vec##D##_array_dot);                                      \
+    py_bindmethod(vec##D##_array, "length", vec##D##_array_length);                                \
+    py_bindmethod(vec##D##_array, "normalize", vec##D##_array_normalize);                          \
+    py_bindmethod(vec##D##_array, "normalize_", vec##D##_array_normalize_);                        \
+    py_bindmethod(vec##D##_array, "lerp", vec##D##_array_lerp);                                    \
+    py_bindmethod(vec##D##_array, "copy", vec##D##_array_copy);                                    \
+    py_bindmethod(vec##D##_array, "tolist", vec##D##_array_tolist);                                \
+    py_bindmethod(vec##D##_array, "tobytes", vec##D##_array_tobytes);                              \
+    py_bindstaticmethod(vec##D##_array, "frombytes", vec##D##_array_frombytes_STATIC);
+
+    BIND_VEC_ARRAY(2)
+    BIND_VEC_ARRAY(3)
+#undef BIND_VEC_ARRAY
+
+    py_bindmethod(vec2_array, "transform_point", vec2_array_transform_point);
+    py_bindmethod(vec2_array, "transform_vector", vec2_array_transform_vector);
+    py_bindmethod(vec2_array, "transform_point_", vec2_array_transform_point_);
+    py_bindmethod(vec2_array, "transform_vector_", vec2_array_transform_vector_);
+    py_bindmethod(vec3_array, "transform_", vec3_array_transform_);
+}
+
 #undef DEFINE_VEC_FIELD
 #undef DEFINE_BOOL_NE
 #undef DEF_VECTOR_ELEMENT_WISE
 #undef DEF_VECTOR_OPS
-#undef DEF_VECTOR_INT_OPS
\ No newline at end of file
+#undef DEF_VECTOR_INT_OPS
+#undef DEF_VEC_ARRAY_ZIP
+#undef DEF_VEC_ARRAY_BINARY_OP
+#undef DEF_VEC_ARRAY_OPS
@@ -48,7 +48,8 @@ static bool pkpy_memory_usage(int argc, py_Ref argv) {
     pk_sprintf(&buf, "len(large_objects)=%d\n", large_object_count);
     c11_sbuf__write_cstr(&buf, "== heap.gc ==\n");
     pk_sprintf(&buf, "gc_counter=%d\n", heap->gc_counter);
-    pk_sprintf(&buf, "gc_threshold=%d", heap->gc_threshold);
+    pk_sprintf(&buf, "gc_threshold=%d\n", heap->gc_threshold);
+    pk_sprintf(&buf, "gc_sweeping=%d", (int)heap->gc_sweeping);
     // c11_sbuf__write_cstr(&buf, "== vm.pool_frame ==\n");
     c11_sbuf__py_submit(&buf, py_retval());
     c11_string__delete(small_objects_usage);
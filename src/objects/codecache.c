@@ -0,0 +1,660 @@
+#include "pocketpy/objects/codeobject.h"
+#include "pocketpy/common/smallmap.h"
+#include "pocketpy/common/utils.h"
+#include "pocketpy/pocketpy.h"
+#include "pocketpy/interpreter/vm.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Binary format of a bytecode cache (.pkc) file:
+ *
+ *   header:  "pkc\0", version info, source hash and source size
+ *   payload: names, every py_Name used by the code, as strings
+ *            body, the module CodeObject with nested FuncDecls inlined
+ *
+ * A bundle (.pkb) holds the payloads of many modules:
+ *
+ *   header:  "pkb\0", version info, module count
+ *   index:   path, filename, source and payload of each module, sorted by path
+ *   blob:    the data referenced by the index
+ *
+ * py_Name values are VM-specific, so the body refers to names by their index in the
+ * name table and they are interned again when loading.
+ * Strings are null-terminated, so that a bundle can be used in place.
+ */
+
+#define PKC_FORMAT_VERSION 2
+#define PKC_ENDIAN_TAG 0x01020304
+
+enum {
+    PKC_OPCODE_COUNT = 0
+#define OPCODE(name) +1
+#include "pocketpy/xmacros/opcodes.h"
+#undef OPCODE
+};
+
+typedef enum {
+    PKC_NIL,
+    PKC_NONE,
+    PKC_TRUE,
+    PKC_FALSE,
+    PKC_ELLIPSIS,
+    PKC_INT,
+    PKC_FLOAT,
+    PKC_STR,
+    PKC_TUPLE,
+} PkcValueTag;
+
+typedef struct PkcWriter {
+    c11_vector /*T=char*/ body;
+    c11_vector /*T=py_Name*/ names;
+    c11_smallmap_n2i names_inv;
+} PkcWriter;
+
+typedef struct PkcReader {
+    const unsigned char* p;
+    const unsigned char* end;
+    bool error;
+    bool borrow;  // create `str` constants referencing the input
+    py_Name* names;
+    int names_length;
+} PkcReader;
+
+static bool pkc__is_name_op(Opcode op) {
+    switch(op) {
+        case OP_LOAD_NAME:
+        case OP_LOAD_NONLOCAL:
+        case OP_LOAD_GLOBAL:
+        case OP_LOAD_CLASS_GLOBAL:
+        case OP_STORE_NAME:
+        case OP_STORE_GLOBAL:
+        case OP_DELETE_NAME:
+        case OP_DELETE_GLOBAL:
+        case OP_DELETE_ATTR:
+        case OP_BEGIN_CLASS:
+        case OP_END_CLASS:
+        case OP_STORE_CLASS_ATTR:
+        case OP_ADD_CLASS_ANNOTATION: return true;
+        default: return false;
+    }
+}
+
+static uint64_t pkc__hash_source(const char* data, int size) {
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for(int i = 0; i < size; i++) {
+        hash ^= (unsigned char)data[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+/* writer */
+static void pkc__write(c11_vector* buf, const void* data, int size) {
+    c11_vector__extend(char, buf, data, size);
+}
+
+static void pkc__write_i32(c11_vector* buf, int32_t val) { pkc__write(buf, &val, 4); }
+
+static void pkc__write_u8(c11_vector* buf, uint8_t val) { c11_vector__push(char, buf, val); }
+
+static void pkc__write_sv(c11_vector* buf, c11_sv sv) {
+    pkc__write_i32(buf, sv.size);
+    pkc__write(buf, sv.data, sv.size);
+    pkc__write_u8(buf, 0);
+}
+
+static void pkc__write_name(PkcWriter* w, py_Name name) {
+    int index = c11_smallmap_n2i__get(&w->names_inv, name, -1);
+    if(index == -1) {
+        index = w->names.length;
+        c11_vector__push(py_Name, &w->names, name);
+        c11_smallmap_n2i__set(&w->names_inv, name, index);
+    }
+    pkc__write_i32(&w->body, index);
+}
+
+static bool pkc__write_value(PkcWriter* w, py_TValue* val) {
+    c11_vector* buf = &w->body;
+    switch(val->type) {
+        case tp_nil: pkc__write_u8(buf, PKC_NIL); return true;
+        case tp_NoneType: pkc__write_u8(buf, PKC_NONE); return true;
+        case tp_bool: pkc__write_u8(buf, py_tobool(val) ? PKC_TRUE : PKC_FALSE); return true;
+        case tp_ellipsis: pkc__write_u8(buf, PKC_ELLIPSIS); return true;
+        case tp_int: {
+            py_i64 i = py_toint(val);
+            pkc__write_u8(buf, PKC_INT);
+            pkc__write(buf, &i, sizeof(py_i64));
+            return true;
+        }
+        case tp_float: {
+            py_f64 f = py_tofloat(val);
+            pkc__write_u8(buf, PKC_FLOAT);
+            pkc__write(buf, &f, sizeof(py_f64));
+            return true;
+        }
+        case tp_str: {
+            pkc__write_u8(buf, PKC_STR);
+            pkc__write_sv(buf, py_tosv(val));
+            return true;
+        }
+        case tp_tuple: {
+            int length = py_tuple_len(val);
+            pkc__write_u8(buf, PKC_TUPLE);
+            pkc__write_i32(buf, length);
+            for(int i = 0; i < length; i++) {
+                if(!pkc__write_value(w, py_tuple_getitem(val, i))) return false;
+            }
+            return true;
+        }
+        default: return false;
+    }
+}
+
+static bool pkc__write_code(PkcWriter* w, const CodeObject* co);
+
+static bool pkc__write_decl(PkcWriter* w, const FuncDecl* decl) {
+    c11_vector* buf = &w->body;
+    if(!pkc__write_code(w, &decl->code)) return false;
+    pkc__write_i32(buf, decl->args.length);
+    c11__foreach(int, &decl->args, p) pkc__write_i32(buf, *p);
+    pkc__write_i32(buf, decl->kwargs.length);
+    c11__foreach(FuncDeclKwArg, &decl->kwargs, kv) {
+        pkc__write_i32(buf, kv->index);
+        pkc__write_name(w, kv->key);
+        if(!pkc__write_value(w, &kv->value)) return false;
+    }
+    pkc__write_i32(buf, decl->starred_arg);
+    pkc__write_i32(buf, decl->starred_kwarg);
+    pkc__write_u8(buf, decl->nested);
+    pkc__write_u8(buf, decl->type);
+    // the docstring is a weak ref to one of the constants
+    int docstring = -1;
+    for(int i = 0; i < decl->code.consts.length; i++) {
+        py_TValue* c = c11__at(py_TValue, &decl->code.consts, i);
+        if(decl->docstring && c->type == tp_str && py_tostr(c) == decl->docstring) {
+            docstring = i;
+            break;
+        }
+    }
+    if(decl->docstring && docstring == -1) return false;
+    pkc__write_i32(buf, docstring);
+    return true;
+}
+
+static bool pkc__write_code(PkcWriter* w, const CodeObject* co) {
+    c11_vector* buf = &w->body;
+    pkc__write_sv(buf, c11_string__sv(co->name));
+    pkc__write_i32(buf, co->start_line);
+    pkc__write_i32(buf, co->end_line);
+
+    pkc__write_i32(buf, co->codes.length);
+    for(int i = 0; i < co->codes.length; i++) {
+        Bytecode byte = c11__getitem(Bytecode, &co->codes, i);
+        pkc__write_u8(buf, byte.op);
+        if(pkc__is_name_op(byte.op)) {
+            py_Name name = byte.arg;
+            if(i > 0) {
+                Bytecode prev = c11__getitem(Bytecode, &co->codes, i - 1);
+                if(prev.op == OP_EXTENDED_ARG) name |= (py_Name)prev.arg << 16;
+            }
+            pkc__write_name(w, name);
+        } else {
+            pkc__write(buf, &byte.arg, sizeof(uint16_t));
+        }
+    }
+    pkc__write_i32(buf, co->linetable.length);
+    pkc__write(buf, co->linetable.data, co->linetable.length);
+
+    pkc__write_i32(buf, co->consts.length);
+    for(int i = 0; i < co->consts.length; i++) {
+        if(!pkc__write_value(w, c11__at(py_TValue, &co->consts, i))) return false;
+    }
+
+    pkc__write_i32(buf, co->varnames.length);
+    c11__foreach(py_Name, &co->varnames, p) pkc__write_name(w, *p);
+
+    pkc__write_i32(buf, co->blocks.length);
+    c11__foreach(CodeBlock, &co->blocks, p) {
+        pkc__write_u8(buf, p->type);
+        pkc__write_i32(buf, p->parent);
+        pkc__write_i32(buf, p->start);
+        pkc__write_i32(buf, p->end);
+        pkc__write_i32(buf, p->end2);
+    }
+
+    pkc__write_i32(buf, co->inline_caches.length);
+    c11__foreach(InlineCache, &co->inline_caches, p) pkc__write_name(w, p->name);
+
+    pkc__write_i32(buf, co->func_decls.length);
+    c11__foreach(FuncDecl_, &co->func_decls, p) {
+        if(!pkc__write_decl(w, *p)) return false;
+    }
+    return true;
+}
+
+static void pkc__write_version(c11_vector* buf) {
+    pkc__write_i32(buf, PKC_FORMAT_VERSION);
+    pkc__write_sv(buf, (c11_sv){PK_VERSION, sizeof(PK_VERSION) - 1});
+    pkc__write_i32(buf, PKC_OPCODE_COUNT);
+    pkc__write_i32(buf, PKC_ENDIAN_TAG);
+}
+
+static bool pkc__write_payload(const CodeObject* co, c11_vector* out) {
+    PkcWriter w;
+    c11_vector__ctor(&w.body, sizeof(char));
+    c11_vector__ctor(&w.names, sizeof(py_Name));
+    c11_smallmap_n2i__ctor(&w.names_inv);
+
+    bool ok = pkc__write_code(&w, co);
+    if(ok) {
+        pkc__write_i32(out, w.names.length);
+        c11__foreach(py_Name, &w.names, p) pkc__write_sv(out, py_name2sv(*p));
+        pkc__write(out, w.body.data, w.body.length);
+    }
+
+    c11_vector__dtor(&w.body);
+    c11_vector__dtor(&w.names);
+    c11_smallmap_n2i__dtor(&w.names_inv);
+    return ok;
+}
+
+bool CodeObject__dumps(const CodeObject* self, c11_vector* out) {
+    c11_sv source = c11_string__sv(self->src->source);
+    pkc__write(out, "pkc", 4);
+    pkc__write_version(out);
+    uint64_t hash = pkc__hash_source(source.data, source.size);
+    pkc__write(out, &hash, sizeof(uint64_t));
+    pkc__write_i32(out, source.size);
+    int length = out->length;
+    if(pkc__write_payload(self, out)) return true;
+    out->length = length;
+    return false;
+}
+
+static int pkc__cmp_module(const void* a, const void* b) {
+    const BundleModule* lhs = *(const BundleModule**)a;
+    const BundleModule* rhs = *(const BundleModule**)b;
+    return strcmp(lhs->path, rhs->path);
+}
+
+bool Bundle__dumps(const BundleModule* modules, int count, c11_vector* out) {
+    const BundleModule** sorted = PK_MALLOC(sizeof(BundleModule*) * (count + 1));
+    for(int i = 0; i < count; i++)
+        sorted[i] = &modules[i];
+    qsort(sorted, count, sizeof(BundleModule*), pkc__cmp_module);
+
+    pkc__write(out, "pkb", 4);
+    pkc__write_version(out);
+    pkc__write_i32(out, count);
+    int base = out->length + count * 8 * 4;
+
+    c11_vector blob;
+    c11_vector__ctor(&blob, sizeof(char));
+    bool ok = true;
+    for(int i = 0; i < count && ok; i++) {
+        const CodeObject* co = sorted[i]->code;
+        c11_sv svs[3] = {
+            {sorted[i]->path, strlen(sorted[i]->path)},
+            c11_string__sv(co->src->filename),
+            c11_string__sv(co->src->source),
+        };
+        for(int j = 0; j < 3; j++) {
+            pkc__write_i32(out, base + blob.length);
+            pkc__write_i32(out, svs[j].size);
+            pkc__write(&blob, svs[j].data, svs[j].size);
+            pkc__write_u8(&blob, 0);
+        }
+        int offset = blob.length;
+        ok = pkc__write_payload(co, &blob);
+        pkc__write_i32(out, base + offset);
+        pkc__write_i32(out, blob.length - offset);
+    }
+    pkc__write(out, blob.data, blob.length);
+    c11_vector__dtor(&blob);
+    PK_FREE(sorted);
+    return ok;
+}
+
+/* reader */
+static const unsigned char* pkc__read(PkcReader* r, int size) {
+    if(r->error || size < 0 || r->end - r->p < size) {
+        r->error = true;
+        return NULL;
+    }
+    const unsigned char* p = r->p;
+    r->p += size;
+    return p;
+}
+
+static int32_t pkc__read_i32(PkcReader* r) {
+    int32_t val = 0;
+    const unsigned char* p = pkc__read(r, 4);
+    if(p) memcpy(&val, p, 4);
+    return val;
+}
+
+static uint8_t pkc__read_u8(PkcReader* r) {
+    const unsigned char* p = pkc__read(r, 1);
+    return p ? *p : 0;
+}
+
+static c11_sv pkc__read_sv(PkcReader* r) {
+    int size = pkc__read_i32(r);
+    const unsigned char* p = size >= 0 ? pkc__read(r, size + 1) : NULL;
+    if(p == NULL || p[size] != 0) {
+        r->error = true;
+        return (c11_sv){"", 0};
+    }
+    return (c11_sv){(const char*)p, size};
+}
+
+static int pkc__read_length(PkcReader* r) {
+    int length = pkc__read_i32(r);
+    // every element takes at least one byte
+    if(length < 0 || length > r->end - r->p) {
+        r->error = true;
+        return 0;
+    }
+    return length;
+}
+
+static py_Name pkc__read_name(PkcReader* r) {
+    int index = pkc__read_i32(r);
+    if(index < 0 || index >= r->names_length) {
+        r->error = true;
+        return 0;
+    }
+    return r->names[index];
+}
+
+static void pkc__read_value(PkcReader* r, py_OutRef out) {
+    py_newnil(out);
+    switch(pkc__read_u8(r)) {
+        case PKC_NIL: break;
+        case PKC_NONE: py_newnone(out); break;
+        case PKC_TRUE: py_newbool(out, true); break;
+        case PKC_FALSE: py_newbool(out, false); break;
+        case PKC_ELLIPSIS: py_newellipsis(out); break;
+        case PKC_INT: {
+            py_i64 val = 0;
+            const unsigned char* p = pkc__read(r, sizeof(py_i64));
+            if(p) memcpy(&val, p, sizeof(py_i64));
+            py_newint(out, val);
+            break;
+        }
+        case PKC_FLOAT: {
+            py_f64 val = 0;
+            const unsigned char* p = pkc__read(r, sizeof(py_f64));
+            if(p) memcpy(&val, p, sizeof(py_f64));
+            py_newfloat(out, val);
+            break;
+        }
+        case PKC_STR: {
+            c11_sv sv = pkc__read_sv(r);
+            if(r->borrow) {
+                pk_newstrview(out, sv);
+            } else {
+                py_newstrv(out, sv);
+            }
+            break;
+        }
+        case PKC_TUPLE: {
+            int length = pkc__read_length(r);
+            py_Ref p = py_newtuple(out, length);
+            for(int i = 0; i < length; i++) {
+                pkc__read_value(r, &p[i]);
+            }
+            break;
+        }
+        default: r->error = true; break;
+    }
+}
+
+static void pkc__read_code(PkcReader* r, CodeObject* co);
+
+static FuncDecl_ pkc__read_decl(PkcReader* r, SourceData_ src) {
+    c11_sv name = pkc__read_sv(r);
+    FuncDecl_ decl = FuncDecl__rcnew(src, name);
+    pkc__read_code(r, &decl->code);
+    int args_length = pkc__read_length(r);
+    for(int i = 0; i < args_length; i++) {
+        c11_vector__push(int, &decl->args, pkc__read_i32(r));
+    }
+    int kwargs_length = pkc__read_length(r);
+    for(int i = 0; i < kwargs_length; i++) {
+        FuncDeclKwArg* kv = c11_vector__emplace(&decl->kwargs);
+        kv->index = pkc__read_i32(r);
+        kv->key = pkc__read_name(r);
+        pkc__read_value(r, &kv->value);
+        c11_smallmap_n2i__set(&decl->kw_to_index, kv->key, kv->index);
+    }
+    decl->starred_arg = pkc__read_i32(r);
+    decl->starred_kwarg = pkc__read_i32(r);
+    decl->nested = pkc__read_u8(r);
+    decl->type = (FuncType)pkc__read_u8(r);
+    int docstring = pkc__read_i32(r);
+    if(docstring >= decl->code.consts.length) r->error = true;
+    if(docstring >= 0 && !r->error) {
+        py_TValue* c = c11__at(py_TValue, &decl->code.consts, docstring);
+        if(c->type == tp_str) {
+            decl->docstring = py_tostr(c);
+        } else {
+            r->error = true;
+        }
+    }
+    return decl;
+}
+
+// indices and jump targets are used by the VM without bounds checks
+static bool pkc__check_args(const CodeObject* co) {
+    const Bytecode* codes = co->codes.data;
+    int n = co->codes.length;
+    for(int i = 0; i < n; i++) {
+        Bytecode byte = codes[i];
+        if(byte.op == OP_EXTENDED_ARG) {
+            if(i + 1 == n || codes[i + 1].op == OP_EXTENDED_ARG) return false;
+            continue;
+        }
+        int arg = byte.arg;
+        if(i > 0 && codes[i - 1].op == OP_EXTENDED_ARG) arg |= codes[i - 1].arg << 16;
+        int bound;
+        switch(byte.op) {
+            case OP_LOAD_CONST:
+            case OP_BUILD_BYTES:
+            case OP_IMPORT_PATH:
+            case OP_FORMAT_STRING: bound = co->consts.length; break;
+            case OP_LOAD_FUNCTION: bound = co->func_decls.length; break;
+            case OP_LOAD_FAST:
+            case OP_STORE_FAST:
+            case OP_DELETE_FAST: bound = co->nlocals; break;
+            case OP_LOAD_ATTR:
+            case OP_LOAD_METHOD:
+            case OP_STORE_ATTR: bound = co->inline_caches.length; break;
+            case OP_LOAD_FAST_LOAD_FAST: {
+                if((arg >> 8) >= co->nlocals || (arg & 0xFF) >= co->nlocals) return false;
+                continue;
+            }
+            case OP_LOAD_FAST_LOAD_ATTR: {
+                if((arg >> 8) >= co->nlocals || (arg & 0xFF) >= co->inline_caches.length) {
+                    return false;
+                }
+                continue;
+            }
+            case OP_JUMP_FORWARD:
+            case OP_POP_JUMP_IF_FALSE:
+            case OP_POP_JUMP_IF_TRUE:
+            case OP_JUMP_IF_TRUE_OR_POP:
+            case OP_JUMP_IF_FALSE_OR_POP:
+            case OP_SHORTCUT_IF_FALSE_OR_POP:
+            case OP_LOOP_CONTINUE:
+            case OP_LOOP_BREAK:
+            case OP_FOR_ITER:
+            case OP_FOR_ITER_YIELD_VALUE: {
+                // relative to the instruction, see `DISPATCH_JUMP`
+                int target = i + (int16_t)arg;
+                if(target < 0 || target >= n) return false;
+                continue;
+            }
+            default: continue;
+        }
+        if(arg >= bound) return false;
+    }
+    return true;
+}
+
+// the name has been read by the caller
+static void pkc__read_code(PkcReader* r, CodeObject* co) {
+    co->start_line = pkc__read_i32(r);
+    co->end_line = pkc__read_i32(r);
+
+    int codes_length = pkc__read_length(r);
+    c11_vector__reserve(&co->codes, codes_length);
+    for(int i = 0; i < codes_length; i++) {
+        Bytecode byte = {0};
+        byte.op = pkc__read_u8(r);
+        if(byte.op >= PKC_OPCODE_COUNT) r->error = true;
+        if(pkc__is_name_op(byte.op)) {
+            // names are interned again, so the width of the argument may change
+            py_Name name = pkc__read_name(r);
+            Bytecode* prev = i > 0 ? &c11_vector__back(Bytecode, &co->codes) : NULL;
+            if(prev && prev->op == OP_EXTENDED_ARG) {
+                prev->arg = (uint16_t)(name >> 16);
+            } else if(name > UINT16_MAX) {
+                r->error = true;
+            }
+            byte.arg = (uint16_t)name;
+        } else {
+            const unsigned char* p = pkc__read(r, sizeof(uint16_t));
+            if(p) memcpy(&byte.arg, p, sizeof(uint16_t));
+        }
+        c11_vector__push(Bytecode, &co->codes, byte);
+    }
+    int linetable_length = pkc__read_length(r);
+    const unsigned char* linetable = pkc__read(r, linetable_length);
+    if(linetable) {
+        c11_vector__reserve(&co->linetable, linetable_length);
+        c11_vector__extend(char, &co->linetable, linetable, linetable_length);
+    }
+
+    int consts_length = pkc__read_length(r);
+    for(int i = 0; i < consts_length; i++) {
+        py_TValue* val = c11_vector__emplace(&co->consts);
+        pkc__read_value(r, val);
+    }
+
+    int varnames_length = pkc__read_length(r);
+    for(int i = 0; i < varnames_length; i++) {
+        CodeObject__add_varname(co, pkc__read_name(r));
+    }
+    if(co->varnames.length != varnames_length) r->error = true;
+
+    int blocks_length = pkc__read_length(r);
+    c11_vector__clear(&co->blocks);
+    for(int i = 0; i < blocks_length; i++) {
+        CodeBlock* block = c11_vector__emplace(&co->blocks);
+        block->type = (CodeBlockType)pkc__read_u8(r);
+        block->parent = pkc__read_i32(r);
+        block->start = pkc__read_i32(r);
+        block->end = pkc__read_i32(r);
+        block->end2 = pkc__read_i32(r);
+    }
+
+    int inline_caches_length = pkc__read_length(r);
+    for(int i = 0; i < inline_caches_length; i++) {
+        CodeObject__add_inline_cache(co, pkc__read_name(r));
+    }
+
+    int func_decls_length = pkc__read_length(r);
+    for(int i = 0; i < func_decls_length && !r->error; i++) {
+        FuncDecl_ decl = pkc__read_decl(r, co->src);
+        c11_vector__push(FuncDecl_, &co->func_decls, decl);
+    }
+    if(!CodeObject__check_linetable(co) || !pkc__check_args(co)) {
+        r->error = true;
+        return;
+    }
+    CodeObject__index_linetable(co);
+}
+
+static bool pkc__check_version(PkcReader* r, const char* magic) {
+    const unsigned char* p = pkc__read(r, 4);
+    if(p == NULL || memcmp(p, magic, 4) != 0) return false;
+    if(pkc__read_i32(r) != PKC_FORMAT_VERSION) return false;
+    c11_sv version = pkc__read_sv(r);
+    if(!c11__sveq(version, (c11_sv){PK_VERSION, sizeof(PK_VERSION) - 1})) return false;
+    if(pkc__read_i32(r) != PKC_OPCODE_COUNT) return false;
+    if(pkc__read_i32(r) != PKC_ENDIAN_TAG) return false;
+    return !r->error;
+}
+
+static bool pkc__read_payload(PkcReader* r, CodeObject* out, SourceData_ src) {
+    int names_length = pkc__read_length(r);
+    r->names = PK_MALLOC(sizeof(py_Name) * (names_length + 1));
+    for(int i = 0; i < names_length; i++) {
+        r->names[i] = py_namev(pkc__read_sv(r));
+    }
+    r->names_length = names_length;
+
+    c11_sv name = pkc__read_sv(r);
+    CodeObject__ctor(out, src, name);
+    pkc__read_code(r, out);
+    PK_FREE(r->names);
+
+    if(r->error || r->p != r->end) {
+        CodeObject__dtor(out);
+        return false;
+    }
+    return true;
+}
+
+bool CodeObject__loads(CodeObject* out, const void* data, int size, SourceData_ src) {
+    PkcReader r = {.p = data, .end = (const unsigned char*)data + size};
+    if(!pkc__check_version(&r, "pkc")) return false;
+    uint64_t hash = 0;
+    const unsigned char* p = pkc__read(&r, sizeof(uint64_t));
+    if(p) memcpy(&hash, p, sizeof(uint64_t));
+    c11_sv source = c11_string__sv(src->source);
+    if(pkc__read_i32(&r) != source.size) return false;
+    if(hash != pkc__hash_source(source.data, source.size)) return false;
+    return pkc__read_payload(&r, out, src);
+}
+
+bool Bundle__parse(const void* data, int size, c11_vector* out) {
+    PkcReader r = {.p = data, .end = (const unsigned char*)data + size};
+    if(!pkc__check_version(&r, "pkb")) return false;
+    int count = pkc__read_length(&r);
+    for(int i = 0; i < count && !r.error; i++) {
+        int32_t fields[8];
+        for(int j = 0; j < 8; j++)
+            fields[j] = pkc__read_i32(&r);
+        for(int j = 0; j < 8; j += 2) {
+            int offset = fields[j], length = fields[j + 1];
+            // strings are followed by a null-terminator
+            int extra = j < 6 ? 1 : 0;
+            if(offset < 0 || length < 0 || offset > size - length - extra) r.error = true;
+        }
+        if(r.error) break;
+        const char* p = data;
+        BundleEntry* entry = c11_vector__emplace(out);
+        entry->path = (c11_sv){p + fields[0], fields[1]};
+        entry->filename = (c11_sv){p + fields[2], fields[3]};
+        entry->source = (c11_sv){p + fields[4], fields[5]};
+        entry->code = p + fields[6];
+        entry->code_size = fields[7];
+        for(int j = 0; j < 6; j += 2) {
+            if(p[fields[j] + fields[j + 1]] != '\0') r.error = true;
+        }
+    }
+    if(r.error) c11_vector__clear(out);
+    return !r.error;
+}
+
+bool CodeObject__loads_bundled(CodeObject* out, const BundleEntry* entry, SourceData_ src) {
+    PkcReader r = {.p = entry->code, .end = (const unsigned char*)entry->code + entry->code_size};
+    r.borrow = true;
+    return pkc__read_payload(&r, out, src);
+}
+
+#undef PKC_FORMAT_VERSION
+#undef PKC_ENDIAN_TAG
@@ -1,7 +1,9 @@
 #include "pocketpy/objects/codeobject.h"
 #include "pocketpy/common/utils.h"
+#include "pocketpy/common/algorithm.h"
 #include "pocketpy/pocketpy.h"
 #include <stdint.h>
+#include <string.h>
 
 void Bytecode__set_signed_arg(Bytecode* self, int arg) {
     self->arg = (int16_t)arg;
@@ -121,15 +123,18 @@ void CodeObject__ctor(CodeObject* self, SourceData_ src, c11_sv name) {
 
     c11_vector__ctor(&self->codes, sizeof(Bytecode));
     c11_vector__ctor(&self->codes_ex, sizeof(BytecodeEx));
+    c11_vector__ctor(&self->linetable, sizeof(char));
+    c11_vector__ctor(&self->linetable_marks, sizeof(LinetableMark));
 
     c11_vector__ctor(&self->consts, sizeof(py_TValue));
-    c11_vector__ctor(&self->varnames, sizeof(uint16_t));
+    c11_vector__ctor(&self->varnames, sizeof(py_Name));
     self->nlocals = 0;
 
     c11_smallmap_n2i__ctor(&self->varnames_inv);
 
     c11_vector__ctor(&self->blocks, sizeof(CodeBlock));
     c11_vector__ctor(&self->func_decls, sizeof(FuncDecl_));
+    c11_vector__ctor(&self->inline_caches, sizeof(InlineCache));
 
     self->start_line = -1;
     self->end_line = -1;
@@ -144,6 +149,8 @@ void CodeObject__dtor(CodeObject* self) {
 
     c11_vector__dtor(&self->codes);
     c11_vector__dtor(&self->codes_ex);
+    c11_vector__dtor(&self->linetable);
+    c11_vector__dtor(&self->linetable_marks);
 
     c11_vector__dtor(&self->consts);
     c11_vector__dtor(&self->varnames);
@@ -157,6 +164,7 @@ void CodeObject__dtor(CodeObject* self) {
         PK_DECREF(decl);
     }
     c11_vector__dtor(&self->func_decls);
+    c11_vector__dtor(&self->inline_caches);
 }
 
 void Function__ctor(Function* self, FuncDecl_ decl, py_GlobalRef module, py_Ref globals) {
@@ -172,16 +180,195 @@ void Function__ctor(Function* self, FuncDecl_ decl, py_GlobalRef module, py_Ref
 int CodeObject__add_varname(CodeObject* self, py_Name name) {
     int index = c11_smallmap_n2i__get(&self->varnames_inv, name, -1);
     if(index >= 0) return index;
-    c11_vector__push(uint16_t, &self->varnames, name);
+    c11_vector__push(py_Name, &self->varnames, name);
     self->nlocals++;
     index = self->varnames.length - 1;
     c11_smallmap_n2i__set(&self->varnames_inv, name, index);
     return index;
 }
 
+int CodeObject__add_inline_cache(CodeObject* self, py_Name name) {
+    InlineCache* cache = c11_vector__emplace(&self->inline_caches);
+    memset(cache, 0, sizeof(InlineCache));
+    cache->name = name;
+    return self->inline_caches.length - 1;
+}
+
+#define LINETABLE_MARK_STRIDE 16
+#define LINETABLE_MARK_LESS(mark, key) ((mark).ip < (key))
+
+/* The line table is a sequence of runs, one for each group of consecutive instructions sharing
+ * the same `BytecodeEx`. A run is three varints: the number of instructions, the zigzag-encoded
+ * line delta from the previous run and `iblock << 1 | is_virtual`. */
+static void linetable__write_varint(c11_vector* buf, uint32_t val) {
+    while(val >= 0x80) {
+        c11_vector__push(char, buf, (char)((val & 0x7F) | 0x80));
+        val >>= 7;
+    }
+    c11_vector__push(char, buf, (char)val);
+}
+
+static uint32_t linetable__read_varint(const unsigned char** p) {
+    uint32_t val = 0;
+    int shift = 0;
+    while(**p & 0x80) {
+        val |= (uint32_t)(*(*p)++ & 0x7F) << shift;
+        shift += 7;
+    }
+    return val | (uint32_t)*(*p)++ << shift;
+}
+
+// returns the number of instructions in the run and stores its `BytecodeEx` in `ex`
+static int linetable__read_run(const unsigned char** p, BytecodeEx* ex) {
+    int length = linetable__read_varint(p);
+    uint32_t delta = linetable__read_varint(p);
+    ex->lineno += (delta & 1) ? -(int)(delta >> 1) - 1 : (int)(delta >> 1);
+    uint32_t flags = linetable__read_varint(p);
+    ex->is_virtual = flags & 1;
+    ex->iblock = flags >> 1;
+    return length;
+}
+
+void CodeObject__pack_linetable(CodeObject* self) {
+    BytecodeEx* codes_ex = self->codes_ex.data;
+    int n = self->codes_ex.length;
+    c11_vector buf;
+    c11_vector__ctor(&buf, sizeof(char));
+    int prev_line = 0;
+    for(int i = 0; i < n;) {
+        int j = i + 1;
+        while(j < n && codes_ex[j].lineno == codes_ex[i].lineno &&
+              codes_ex[j].is_virtual == codes_ex[i].is_virtual &&
+              codes_ex[j].iblock == codes_ex[i].iblock) {
+            j++;
+        }
+        int delta = codes_ex[i].lineno - prev_line;
+        linetable__write_varint(&buf, j - i);
+        // zigzag: the sign goes to the lowest bit
+        uint32_t zigzag = delta >= 0 ? (uint32_t)delta << 1 : (uint32_t)~delta << 1 | 1;
+        linetable__write_varint(&buf, zigzag);
+        linetable__write_varint(&buf, (uint32_t)codes_ex[i].iblock << 1 | codes_ex[i].is_virtual);
+        prev_line = codes_ex[i].lineno;
+        i = j;
+    }
+    // the table is never modified again, so it is allocated with the exact size
+    c11_vector__clear(&self->linetable);
+    c11_vector__reserve(&self->linetable, buf.length);
+    c11_vector__extend(char, &self->linetable, buf.data, buf.length);
+    c11_vector__dtor(&buf);
+    c11_vector__dtor(&self->codes_ex);
+    c11_vector__ctor(&self->codes_ex, sizeof(BytecodeEx));
+    CodeObject__index_linetable(self);
+}
+
+void CodeObject__index_linetable(CodeObject* self) {
+    const unsigned char* begin = self->linetable.data;
+    const unsigned char* p = begin;
+    const unsigned char* end = p + self->linetable.length;
+    c11_vector__clear(&self->linetable_marks);
+    // a run takes at least three bytes
+    c11_vector__reserve(&self->linetable_marks,
+                        self->linetable.length / (3 * LINETABLE_MARK_STRIDE) + 1);
+    BytecodeEx ex = {0, false, 0};
+    int ip = 0;
+    for(int i = 0; p < end; i++) {
+        if(i % LINETABLE_MARK_STRIDE == 0) {
+            LinetableMark mark = {ip, (int)(p - begin), ex.lineno};
+            c11_vector__push(LinetableMark, &self->linetable_marks, mark);
+        }
+        ip += linetable__read_run(&p, &ex);
+    }
+}
+
+// starts from the closest mark, so a lookup decodes at most `LINETABLE_MARK_STRIDE` runs
+static void linetable__seek(const CodeObject* self, int ip, LinetableCursor* cursor) {
+    memset(cursor, 0, sizeof(LinetableCursor));
+    if(self->linetable_marks.length == 0) return;
+    LinetableMark* marks = self->linetable_marks.data;
+    // the last mark at or before `ip`
+    int index;
+    c11__lower_bound(LinetableMark,
+                     marks,
+                     self->linetable_marks.length,
+                     ip + 1,
+                     LINETABLE_MARK_LESS,
+                     &index);
+    LinetableMark* mark = &marks[index - 1];
+    const unsigned char* begin = self->linetable.data;
+    const unsigned char* p = begin + mark->offset;
+    const unsigned char* end = begin + self->linetable.length;
+    cursor->end = mark->ip;
+    cursor->ex.lineno = mark->lineno;
+    while(p < end) {
+        cursor->start = cursor->end;
+        cursor->end += linetable__read_run(&p, &cursor->ex);
+        if(ip < cursor->end) break;
+    }
+    cursor->offset = p - begin;
+}
+
+// `cursor` keeps the decoded run for the next lookup of the same caller
+BytecodeEx CodeObject__line_info(const CodeObject* self, int ip, LinetableCursor* cursor) {
+    if(cursor->start <= ip && ip < cursor->end) return cursor->ex;
+    // stepping through the code usually lands in the next run
+    if(cursor->end <= ip && cursor->offset < self->linetable.length) {
+        const unsigned char* begin = self->linetable.data;
+        const unsigned char* p = begin + cursor->offset;
+        BytecodeEx ex = cursor->ex;
+        int end = cursor->end + linetable__read_run(&p, &ex);
+        if(ip < end) {
+            cursor->start = cursor->end;
+            cursor->end = end;
+            cursor->offset = p - begin;
+            cursor->ex = ex;
+            return ex;
+        }
+    }
+    linetable__seek(self, ip, cursor);
+    return cursor->ex;
+}
+
+bool CodeObject__check_linetable(const CodeObject* self) {
+    const unsigned char* p = self->linetable.data;
+    const unsigned char* end = p + self->linetable.length;
+    // varints must be complete, fit in 32 bits and come in groups of three
+    int varints = 0;
+    int width = 0;
+    for(const unsigned char* q = p; q < end; q++) {
+        if(++width > 5) return false;
+        if(*q & 0x80) continue;
+        varints++;
+        width = 0;
+    }
+    if(width != 0 || varints % 3 != 0) return false;
+    BytecodeEx ex = {0, false, 0};
+    int count = 0;
+    while(p < end) {
+        int length = linetable__read_run(&p, &ex);
+        if(length <= 0 || length > self->codes.length - count) return false;
+        if(ex.iblock >= self->blocks.length) return false;
+        count += length;
+    }
+    return count == self->codes.length;
+}
+
+void CodeObject__unpack_linetable(const CodeObject* self, c11_vector* out) {
+    const unsigned char* p = self->linetable.data;
+    const unsigned char* end = p + self->linetable.length;
+    BytecodeEx ex = {0, false, 0};
+    while(p < end) {
+        int length = linetable__read_run(&p, &ex);
+        for(int i = 0; i < length; i++)
+            c11_vector__push(BytecodeEx, out, ex);
+    }
+}
+
 void Function__dtor(Function* self) {
     // printf("%s() in %s freed!\n", self->decl->code.name->data,
     // self->decl->code.src->filename->data);
     PK_DECREF(self->decl);
     if(self->closure) NameDict__delete(self->closure);
-}
\ No newline at end of file
+}
+
+#undef LINETABLE_MARK_STRIDE
+#undef LINETABLE_MARK_LESS
@@ -2,12 +2,30 @@
 #include "pocketpy/objects/object.h"
 
 #define SMALLMAP_T__SOURCE
-#define K uint16_t
+#define K py_Name
 #define V py_TValue
 #define NAME NameDict
 #include "pocketpy/xmacros/smallmap.h"
 #undef SMALLMAP_T__SOURCE
 
+py_TValue* NameDict__try_get_hinted(const NameDict* self, py_Name key, int* hint) {
+    NameDict_KV* data = self->data;
+    int index = *hint;
+    if(index < self->length && data[index].key == key) return &data[index].value;
+    py_TValue* res = NameDict__try_get(self, key);
+    if(res) *hint = (int)((NameDict_KV*)((char*)res - offsetof(NameDict_KV, value)) - data);
+    return res;
+}
+
+void NameDict__set_hinted(NameDict* self, py_Name key, py_TValue value, int* hint) {
+    py_TValue* slot = NameDict__try_get_hinted(self, key, hint);
+    if(slot) {
+        *slot = value;
+    } else {
+        NameDict__set(self, key, value);
+    }
+}
+
 void ModuleDict__ctor(ModuleDict* self, const char* path, py_TValue module) {
     self->path = path;
     self->module = module;
@@ -0,0 +1,206 @@
+#include "pocketpy/objects/codeobject.h"
+#include "pocketpy/objects/sourcedata.h"
+#include "pocketpy/pocketpy.h"
+
+#include "pocketpy/common/utils.h"
+#include "pocketpy/common/threads.h"
+#include "pocketpy/interpreter/vm.h"
+#include <stdio.h>
+#include <string.h>
+
+#if PK_ENABLE_OS
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef WIN32_LEAN_AND_MEAN
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+typedef struct MountedBundle {
+    struct MountedBundle* next;
+    const void* data;
+    int size;
+    bool is_mapped;
+    c11_vector /*T=BundleEntry*/ entries;  // sorted by path
+} MountedBundle;
+
+// bundles are shared by all VMs, the most recently mounted one comes first
+static MountedBundle* pk_bundles;
+static c11_spinlock pk_bundles_lock;
+
+static void pk_unmap_file(const void* data, int size) {
+#if PK_ENABLE_OS
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap((void*)data, size);
+#endif
+#endif
+}
+
+static bool pk_mount(const void* data, int size, bool is_mapped) {
+    MountedBundle* self = PK_MALLOC(sizeof(MountedBundle));
+    self->data = data;
+    self->size = size;
+    self->is_mapped = is_mapped;
+    c11_vector__ctor(&self->entries, sizeof(BundleEntry));
+    if(!Bundle__parse(data, size, &self->entries)) {
+        c11_vector__dtor(&self->entries);
+        PK_FREE(self);
+        if(is_mapped) pk_unmap_file(data, size);
+        return ValueError("invalid bundle or it was built by another version of pocketpy");
+    }
+    c11_spinlock__lock(&pk_bundles_lock);
+    self->next = pk_bundles;
+    pk_bundles = self;
+    c11_spinlock__unlock(&pk_bundles_lock);
+    return true;
+}
+
+bool py_importlib_mountbundlemem(const void* data, int size) {
+    return pk_mount(data, size, false);
+}
+
+bool py_importlib_mountbundle(const char* path) {
+#if PK_ENABLE_OS
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path,
+                              GENERIC_READ,
+                              FILE_SHARE_READ,
+                              NULL,
+                              OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL,
+                              NULL);
+    if(file == INVALID_HANDLE_VALUE) return OSError("cannot open bundle '%s'", path);
+    LARGE_INTEGER size;
+    void* data = NULL;
+    if(GetFileSizeEx(file, &size) && size.QuadPart > 0 && size.QuadPart < INT32_MAX) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(mapping != NULL) {
+            data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+    if(data == NULL) return OSError("cannot map bundle '%s'", path);
+    return pk_mount(data, (int)size.QuadPart, true);
+#else
+    int fd = open(path, O_RDONLY);
+    if(fd == -1) return OSError("cannot open bundle '%s'", path);
+    struct stat st;
+    void* data = MAP_FAILED;
+    if(fstat(fd, &st) == 0 && st.st_size > 0 && st.st_size < INT32_MAX) {
+        data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if(data == MAP_FAILED) return OSError("cannot map bundle '%s'", path);
+    return pk_mount(data, (int)st.st_size, true);
+#endif
+#else
+    return OSError("bundle files are not supported on this platform");
+#endif
+}
+
+static int pk_cmp_bundle_entry(const void* a, const void* b) {
+    const c11_sv* key = a;
+    const BundleEntry* entry = b;
+    int res = memcmp(key->data, entry->path.data, c11__min(key->size, entry->path.size));
+    if(res != 0) return res;
+    return key->size - entry->path.size;
+}
+
+const BundleEntry* pk_find_bundled(const char* path) {
+    c11_sv key = {path, strlen(path)};
+    const BundleEntry* res = NULL;
+    c11_spinlock__lock(&pk_bundles_lock);
+    for(MountedBundle* p = pk_bundles; p && !res; p = p->next) {
+        res = bsearch(&key,
+                      p->entries.data,
+                      p->entries.length,
+                      sizeof(BundleEntry),
+                      pk_cmp_bundle_entry);
+    }
+    c11_spinlock__unlock(&pk_bundles_lock);
+    return res;
+}
+
+bool pk_exec_bundled(const BundleEntry* entry, py_Ref module) {
+    SourceData_ src = SourceData__rcnew_view(entry->source, entry->filename.data, EXEC_MODE, false);
+    CodeObject co;
+    bool ok = CodeObject__loads_bundled(&co, entry, src);
+    PK_DECREF(src);
+    // the bundle has the source, so it can be compiled as a last resort
+    if(!ok && !_py_compile(&co, entry->source.data, entry->filename.data, EXEC_MODE, false)) {
+        return false;
+    }
+    ok = pk_exec(&co, module);
+    CodeObject__dtor(&co);
+    return ok;
+}
+
+void pk_unmount_bundles() {
+    MountedBundle* p = pk_bundles;
+    while(p) {
+        MountedBundle* next = p->next;
+        if(p->is_mapped) pk_unmap_file(p->data, p->size);
+        c11_vector__dtor(&p->entries);
+        PK_FREE(p);
+        p = next;
+    }
+    pk_bundles = NULL;
+}
+
+bool py_importlib_makebundle(const char* path, const char** modules, int count) {
+#if PK_ENABLE_OS
+    BundleModule* items = PK_MALLOC(sizeof(BundleModule) * (count + 1));
+    CodeObject* codes = PK_MALLOC(sizeof(CodeObject) * (count + 1));
+    int n = 0;
+    bool ok = true;
+    for(; n < count; n++) {
+        c11_string* filename;
+        bool need_free;
+        const char* data = pk_load_module_source(modules[n], &filename, &need_free);
+        if(data == NULL) {
+            ok = ImportError("module '%s' not found", modules[n]);
+            break;
+        }
+        ok = _py_compile(&codes[n], data, filename->data, EXEC_MODE, false);
+        c11_string__delete(filename);
+        if(need_free) PK_FREE((void*)data);
+        if(!ok) break;
+        items[n].path = modules[n];
+        items[n].code = &codes[n];
+    }
+
+    if(ok) {
+        c11_vector buf;
+        c11_vector__ctor(&buf, sizeof(char));
+        ok = Bundle__dumps(items, count, &buf);
+        if(!ok) {
+            ValueError("'%s' contains constants that cannot be bundled", path);
+        } else {
+            FILE* f = fopen(path, "wb");
+            if(f == NULL) {
+                ok = OSError("cannot open '%s' for writing", path);
+            } else {
+                fwrite(buf.data, 1, buf.length, f);
+                fclose(f);
+            }
+        }
+        c11_vector__dtor(&buf);
+    }
+
+    for(int i = 0; i < n; i++)
+        CodeObject__dtor(&codes[i]);
+    PK_FREE(codes);
+    PK_FREE(items);
+    return ok;
+#else
+    return OSError("bundle files are not supported on this platform");
+#endif
+}
@@ -6,6 +6,7 @@
 #include "pocketpy/interpreter/vm.h"
 #include "pocketpy/compiler/compiler.h"
 #include <assert.h>
+#include <stdio.h>
 
 py_Type pk_code__register() {
     py_Type type = pk_newtype("code", tp_object, NULL, (py_Dtor)CodeObject__dtor, false, true);
@@ -19,7 +20,7 @@ bool _py_compile(CodeObject* out,
                  bool is_dynamic) {
     VM* vm = pk_current_vm;
     SourceData_ src = SourceData__rcnew(source, filename, mode, is_dynamic);
-    Error* err = pk_compile(src, out);
+    Error* err = pk_compile(src, vm->optimize, out);
     if(err) {
         py_exception(tp_SyntaxError, err->msg);
         py_BaseException__stpush(&vm->curr_exception, err->src, err->lineno, NULL);
@@ -33,6 +34,45 @@ bool _py_compile(CodeObject* out,
     return true;
 }
 
+void py_sys_setoptimize(int level) { pk_current_vm->optimize = level; }
+
+bool pk_compile_cached(CodeObject* out,
+                       const char* source,
+                       const char* filename,
+                       const char* cache_path) {
+#if PK_ENABLE_OS
+    FILE* f = fopen(cache_path, "rb");
+    if(f != NULL) {
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        char* data = PK_MALLOC(size);
+        size = fread(data, 1, size, f);
+        fclose(f);
+        SourceData_ src = SourceData__rcnew(source, filename, EXEC_MODE, false);
+        bool ok = CodeObject__loads(out, data, size, src);
+        PK_DECREF(src);
+        PK_FREE(data);
+        if(ok) return true;
+    }
+#endif
+    if(!_py_compile(out, source, filename, EXEC_MODE, false)) return false;
+#if PK_ENABLE_OS
+    c11_vector buf;
+    c11_vector__ctor(&buf, sizeof(char));
+    if(CodeObject__dumps(out, &buf)) {
+        // a stale or broken cache file is simply overwritten
+        f = fopen(cache_path, "wb");
+        if(f != NULL) {
+            fwrite(buf.data, 1, buf.length, f);
+            fclose(f);
+        }
+    }
+    c11_vector__dtor(&buf);
+#endif
+    return true;
+}
+
 bool py_compile(const char* source,
                 const char* filename,
                 enum py_CompileMode mode,
@@ -3,19 +3,32 @@
 #include "pocketpy/pocketpy.h"
 
 #include "pocketpy/common/utils.h"
+#include "pocketpy/common/threads.h"
 #include "pocketpy/interpreter/vm.h"
 
-VM* pk_current_vm;
+// each OS thread runs its own VM, see `py_switchvm()`
+c11__thread_local VM* pk_current_vm;
 
+static bool pk_initialized;
 static VM pk_default_vm;
-static VM* pk_all_vm[16];
+static c11_vector /* T=VM* */ pk_all_vm;  // `NULL` for deleted VMs
 static py_TValue _True, _False, _None, _NIL;
 
+#if PK_ENABLE_THREADS
+static c11_mtx pk_all_vm_lock;
+#define VM_LOCK() c11_mtx__lock(&pk_all_vm_lock)
+#define VM_UNLOCK() c11_mtx__unlock(&pk_all_vm_lock)
+#else
+#define VM_LOCK() ((void)0)
+#define VM_UNLOCK() ((void)0)
+#endif
+
 void py_initialize() {
-    if(pk_current_vm) {
+    if(pk_initialized) {
         // c11__abort("py_initialize() can only be called once!");
         return;
     }
+    pk_initialized = true;
 
     // check endianness
     int x = 1;
@@ -27,7 +40,12 @@ void py_initialize() {
     static_assert(sizeof(py_TValue) == 16, "sizeof(py_TValue) != 16");
     static_assert(offsetof(py_TValue, extra) == 4, "offsetof(py_TValue, extra) != 4");
 
-    pk_current_vm = pk_all_vm[0] = &pk_default_vm;
+#if PK_ENABLE_THREADS
+    c11_mtx__ctor(&pk_all_vm_lock);
+#endif
+    c11_vector__ctor(&pk_all_vm, sizeof(VM*));
+    c11_vector__push(VM*, &pk_all_vm, &pk_default_vm);
+    pk_current_vm = &pk_default_vm;
 
     // initialize some convenient references
     py_newbool(&_True, true);
@@ -45,31 +63,83 @@ py_GlobalRef py_None() { return &_None; }
 
 py_GlobalRef py_NIL() { return &_NIL; }
 
+static VM* VM__new() {
+    VM* vm = PK_MALLOC(sizeof(VM));
+    memset(vm, 0, sizeof(VM));
+    VM* prev = pk_current_vm;
+    pk_current_vm = vm;
+    VM__ctor(vm);
+    pk_current_vm = prev;
+    return vm;
+}
+
+static void VM__delete(VM* vm) {
+    // temp fix https://github.com/pocketpy/pocketpy/issues/315
+    // TODO: refactor VM__ctor and VM__dtor
+    VM* prev = pk_current_vm;
+    pk_current_vm = vm;
+    VM__dtor(vm);
+    pk_current_vm = prev;
+    PK_FREE(vm);
+}
+
 void py_finalize() {
-    for(int i = 1; i < 16; i++) {
-        VM* vm = pk_all_vm[i];
-        if(vm) {
-            // temp fix https://github.com/pocketpy/pocketpy/issues/315
-            // TODO: refactor VM__ctor and VM__dtor
-            pk_current_vm = vm;
-            VM__dtor(vm);
-            PK_FREE(vm);
-        }
+    for(int i = pk_all_vm.length - 1; i >= 1; i--) {
+        VM* vm = c11__getitem(VM*, &pk_all_vm, i);
+        if(vm) VM__delete(vm);
     }
     pk_current_vm = &pk_default_vm;
     VM__dtor(&pk_default_vm);
     pk_current_vm = NULL;
+    c11_vector__dtor(&pk_all_vm);
+    pk_unmount_bundles();
+#if PK_ENABLE_THREADS
+    c11_mtx__dtor(&pk_all_vm_lock);
+#endif
+    pk_initialized = false;
 }
 
-void py_switchvm(int index) {
-    if(index < 0 || index >= 16) c11__abort("invalid vm index");
-    if(!pk_all_vm[index]) {
-        pk_current_vm = pk_all_vm[index] = PK_MALLOC(sizeof(VM));
-        memset(pk_current_vm, 0, sizeof(VM));
-        VM__ctor(pk_all_vm[index]);
+int py_newvm() {
+    VM* vm = VM__new();
+    VM_LOCK();
+    int index = 1;
+    while(index < pk_all_vm.length && c11__getitem(VM*, &pk_all_vm, index) != NULL)
+        index++;
+    if(index == pk_all_vm.length) {
+        c11_vector__push(VM*, &pk_all_vm, vm);
     } else {
-        pk_current_vm = pk_all_vm[index];
+        c11__setitem(VM*, &pk_all_vm, index, vm);
     }
+    VM_UNLOCK();
+    return index;
+}
+
+void py_deletevm(int index) {
+    VM_LOCK();
+    VM* vm = NULL;
+    if(index > 0 && index < pk_all_vm.length) {
+        vm = c11__getitem(VM*, &pk_all_vm, index);
+        c11__setitem(VM*, &pk_all_vm, index, NULL);
+    }
+    VM_UNLOCK();
+    if(vm == NULL) c11__abort("invalid vm index");
+    if(vm == pk_current_vm) c11__abort("cannot delete the current vm");
+    VM__delete(vm);
+}
+
+void py_switchvm(int index) {
+    if(index < 0) c11__abort("invalid vm index");
+    VM_LOCK();
+    while(pk_all_vm.length <= index) {
+        c11_vector__push(VM*, &pk_all_vm, NULL);
+    }
+    VM* vm = c11__getitem(VM*, &pk_all_vm, index);
+    if(!vm) {
+        vm = VM__new();
+        c11__setitem(VM*, &pk_all_vm, index, vm);
+    }
+    VM_UNLOCK();
+    pk_current_vm = vm;
 }
 
 void py_resetvm() {
@@ -80,10 +150,16 @@ void py_resetvm() {
 }
 
 int py_currentvm() {
-    for(int i = 0; i < 16; i++) {
-        if(pk_all_vm[i] == pk_current_vm) return i;
+    int index = -1;
+    VM_LOCK();
+    for(int i = 0; i < pk_all_vm.length; i++) {
+        if(c11__getitem(VM*, &pk_all_vm, i) == pk_current_vm) {
+            index = i;
+            break;
+        }
     }
-    return -1;
+    VM_UNLOCK();
+    return index;
 }
 
 void* py_getvmctx() { return pk_current_vm->ctx; }
@@ -163,7 +239,7 @@ bool py_pushmethod(py_Name name) {
     return ok;
 }
 
-bool pk_loadmethod(py_StackRef self, py_Name name) {
+static bool pk__loadmethod(py_StackRef self, py_Name name, InlineCache* cache) {
     // NOTE: `out` and `out_self` may overlap with `self`
     py_Type type;
 
@@ -200,7 +276,12 @@ bool pk_loadmethod(py_StackRef self, py_Name name) {
         self_bak = *self;
     }
 
-    py_Ref cls_var = py_tpfindname(type, name);
+    py_Ref cls_var;
+    if(cache && !py_istype(self, tp_super)) {
+        cls_var = pk_inlinecache__lookup(cache, type);
+    } else {
+        cls_var = py_tpfindname(type, name);
+    }
     if(cls_var != NULL) {
         switch(cls_var->type) {
             case tp_function:
@@ -224,6 +305,12 @@ bool pk_loadmethod(py_StackRef self, py_Name name) {
     return false;
 }
 
+bool pk_loadmethod(py_StackRef self, py_Name name) { return pk__loadmethod(self, name, NULL); }
+
+bool pk_loadmethod_cached(py_StackRef self, InlineCache* cache) {
+    return pk__loadmethod(self, cache->name, cache);
+}
+
 py_Ref py_tpfindmagic(py_Type t, py_Name name) {
     assert(py_ismagicname(name));
     py_TypeInfo* ti = pk__type_info(t);
@@ -280,3 +367,6 @@ bool StopIteration() {
     if(!ok) return false;
     return py_raise(py_retval());
 }
+
+#undef VM_LOCK
+#undef VM_UNLOCK
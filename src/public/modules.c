@@ -67,6 +67,46 @@ py_Ref py_newmodule(const char* path) {
 
 int load_module_from_dll_desktop_only(const char* path) PY_RAISE PY_RETURN;
 
+// find the source of a module, returns NULL if not found
+const char* pk_load_module_source(const char* path, c11_string** filename, bool* need_free) {
+    VM* vm = pk_current_vm;
+    c11_string* slashed_path = c11_sv__replace((c11_sv){path, strlen(path)}, '.', PK_PLATFORM_SEP);
+    *filename = c11_string__new3("%s.py", slashed_path->data);
+    *need_free = false;
+
+    const char* data = load_kPythonLib(path);
+    if(data == NULL) {
+        *need_free = true;
+        data = vm->callbacks.importfile((*filename)->data);
+    }
+    if(data == NULL) {
+        c11_string__delete(*filename);
+        *filename = c11_string__new3("%s%c__init__.py", slashed_path->data, PK_PLATFORM_SEP);
+        data = vm->callbacks.importfile((*filename)->data);
+    }
+    c11_string__delete(slashed_path);
+    if(data == NULL) c11_string__delete(*filename);
+    return data;
+}
+
+static c11_string* pk_cache_path(const char* path) {
+    VM* vm = pk_current_vm;
+    if(vm->cache_dir == NULL) return NULL;
+    return c11_string__new3("%s%c%s.pkc", vm->cache_dir->data, PK_PLATFORM_SEP, path);
+}
+
+static bool pk_exec_module(const char* source, const char* filename, const char* path, py_Ref mod) {
+    c11_string* cache_path = pk_cache_path(path);
+    if(cache_path == NULL) return py_exec(source, filename, EXEC_MODE, mod);
+    CodeObject co;
+    bool ok = pk_compile_cached(&co, source, filename, cache_path->data);
+    c11_string__delete(cache_path);
+    if(!ok) return false;
+    ok = pk_exec(&co, mod);
+    CodeObject__dtor(&co);
+    return ok;
+}
+
 int py_import(const char* path_cstr) {
     VM* vm = pk_current_vm;
     c11_sv path = {path_cstr, strlen(path_cstr)};
@@ -123,39 +163,26 @@ int py_import(const char* path_cstr) {
         return true;
     }
 
-    // try import
-    c11_string* slashed_path = c11_sv__replace(path, '.', PK_PLATFORM_SEP);
-    c11_string* filename = c11_string__new3("%s.py", slashed_path->data);
-
-    bool need_free = true;
-    const char* data = load_kPythonLib(path_cstr);
-    if(data != NULL) {
-        need_free = false;
-        goto __SUCCESS;
+    // mounted bundles take precedence over `importfile`
+    const BundleEntry* entry = pk_find_bundled(path_cstr);
+    if(entry != NULL) {
+        py_GlobalRef mod = py_newmodule(path_cstr);
+        bool ok = pk_exec_bundled(entry, mod);
+        py_assign(py_retval(), mod);
+        return ok ? 1 : -1;
     }
 
-    data = vm->callbacks.importfile(filename->data);
-    if(data != NULL) goto __SUCCESS;
-
-    c11_string__delete(filename);
-    filename = c11_string__new3("%s%c__init__.py", slashed_path->data, PK_PLATFORM_SEP);
-    data = vm->callbacks.importfile(filename->data);
-    if(data != NULL) goto __SUCCESS;
-
-    c11_string__delete(filename);
-    c11_string__delete(slashed_path);
-    // not found
-    return load_module_from_dll_desktop_only(path_cstr);
+    // try import
+    c11_string* filename;
+    bool need_free;
+    const char* data = pk_load_module_source(path_cstr, &filename, &need_free);
+    if(data == NULL) return load_module_from_dll_desktop_only(path_cstr);
 
-__SUCCESS:
-    do {
-    } while(0);
     py_GlobalRef mod = py_newmodule(path_cstr);
-    bool ok = py_exec((const char*)data, filename->data, EXEC_MODE, mod);
+    bool ok = pk_exec_module(data, filename->data, path_cstr, mod);
     py_assign(py_retval(), mod);
 
     c11_string__delete(filename);
-    c11_string__delete(slashed_path);
     if(need_free) PK_FREE((void*)data);
     return ok ? 1 : -1;
 }
@@ -163,6 +190,12 @@ __SUCCESS:
 bool py_importlib_reload(py_GlobalRef module) {
     VM* vm = pk_current_vm;
     c11_sv path = py_tosv(py_getdict(module, __path__));
+    const BundleEntry* entry = pk_find_bundled(path.data);
+    if(entry != NULL) {
+        bool ok = pk_exec_bundled(entry, module);
+        py_assign(py_retval(), module);
+        return ok;
+    }
     c11_string* slashed_path = c11_sv__replace(path, '.', PK_PLATFORM_SEP);
     c11_string* filename = c11_string__new3("%s.py", slashed_path->data);
     char* data = vm->callbacks.importfile(filename->data);
@@ -173,13 +206,38 @@ bool py_importlib_reload(py_GlobalRef module) {
     }
     c11_string__delete(slashed_path);
     if(data == NULL) return ImportError("module '%v' not found", path);
-    bool ok = py_exec(data, filename->data, EXEC_MODE, module);
+    bool ok = pk_exec_module(data, filename->data, path.data, module);
     c11_string__delete(filename);
     PK_FREE(data);
     py_assign(py_retval(), module);
     return ok;
 }
 
+void py_importlib_setcachedir(const char* path) {
+    VM* vm = pk_current_vm;
+    if(vm->cache_dir) c11_string__delete(vm->cache_dir);
+    vm->cache_dir = path ? c11_string__new(path) : NULL;
+}
+
+int py_importlib_compile(const char* path) {
+    c11_string* cache_path = pk_cache_path(path);
+    if(cache_path == NULL) return RuntimeError("bytecode cache directory is not set");
+    c11_string* filename;
+    bool need_free;
+    const char* data = pk_load_module_source(path, &filename, &need_free);
+    if(data == NULL) {
+        c11_string__delete(cache_path);
+        return 0;
+    }
+    CodeObject co;
+    bool ok = pk_compile_cached(&co, data, filename->data, cache_path->data);
+    if(ok) CodeObject__dtor(&co);
+    c11_string__delete(cache_path);
+    c11_string__delete(filename);
+    if(need_free) PK_FREE((void*)data);
+    return ok ? 1 : -1;
+}
+
 //////////////////////////
 
 static bool builtins_exit(int argc, py_Ref argv) {
@@ -688,10 +746,11 @@ bool py_smarteval(const char* source, py_Ref module, ...) {
 }
 
 static bool builtins_compile(int argc, py_Ref argv) {
-    PY_CHECK_ARGC(3);
+    PY_CHECK_ARGC(4);
     for(int i = 0; i < 3; i++) {
         if(!py_checktype(py_arg(i), tp_str)) return false;
     }
+    PY_CHECK_ARG_TYPE(3, tp_int);
     const char* source = py_tostr(py_arg(0));
     const char* filename = py_tostr(py_arg(1));
     const char* mode = py_tostr(py_arg(2));
@@ -706,7 +765,13 @@ static bool builtins_compile(int argc, py_Ref argv) {
     } else {
         return ValueError("compile() mode must be 'exec', 'eval', or 'single'");
     }
-    return py_compile(source, filename, compile_mode, true);
+    // -1 means the current level of the VM
+    VM* vm = pk_current_vm;
+    int optimize = vm->optimize;
+    if(py_toint(py_arg(3)) >= 0) vm->optimize = py_toint(py_arg(3));
+    bool ok = py_compile(source, filename, compile_mode, true);
+    vm->optimize = optimize;
+    return ok;
 }
 
 static bool builtins__import__(int argc, py_Ref argv) {
@@ -766,7 +831,7 @@ py_TValue pk_builtins__register() {
     py_bindfunc(builtins, "locals", builtins_locals);
     py_bindfunc(builtins, "exec", builtins_exec);
     py_bindfunc(builtins, "eval", builtins_eval);
-    py_bindfunc(builtins, "compile", builtins_compile);
+    py_bind(builtins, "compile(source, filename, mode, optimize=-1)", builtins_compile);
 
     py_bindfunc(builtins, "__import__", builtins__import__);
 
@@ -5,64 +5,132 @@
 #include "pocketpy/objects/object.h"
 #include "pocketpy/interpreter/vm.h"
 
-static uint32_t Dict__next_cap(uint32_t cap) {
-    switch(cap) {
-        case 7: return 17;
-        case 17: return 37;
-        case 37: return 79;
-        case 79: return 163;
-        case 163: return 331;
-        case 331: return 673;
-        case 673: return 1361;
-        case 1361: return 2053;
-        case 2053: return 3083;
-        case 3083: return 4637;
-        case 4637: return 6959;
-        case 6959: return 10453;
-        case 10453: return 15683;
-        case 15683: return 23531;
-        case 23531: return 35311;
-        case 35311: return 52967;
-        case 52967: return 79451;
-        case 79451: return 119179;
-        case 119179: return 178781;
-        case 178781: return 268189;
-        case 268189: return 402299;
-        case 402299: return 603457;
-        case 603457: return 905189;
-        case 905189: return 1357787;
-        case 1357787: return 2036687;
-        case 2036687: return 3055043;
-        case 3055043: return 4582577;
-        case 4582577: return 6873871;
-        case 6873871: return 10310819;
-        case 10310819: return 15466229;
-        case 15466229: return 23199347;
-        case 23199347: return 34799021;
-        case 34799021: return 52198537;
-        case 52198537: return 78297827;
-        case 78297827: return 117446801;
-        case 117446801: return 176170229;
-        case 176170229: return 264255353;
-        case 264255353: return 396383041;
-        case 396383041: return 594574583;
-        case 594574583: return 891861923;
-        default: c11__unreachable();
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PK_DICT_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define PK_DICT_NEON 1
+#endif
+
+/* The index is an open-addressing table probed one group of 16 slots at a time.
+ * Each slot has a control tag: 7 bits of the hash when full (see `Dict__h2`), or
+ * one of the special values below. Slots point into `entries`, which keeps
+ * insertion order. */
+#define DICT_CTRL_EMPTY ((uint8_t)0x80)
+#define DICT_CTRL_DELETED ((uint8_t)0xFE)
+
+// mask of matching lanes, see DictGroup__lane()
+typedef uint64_t DictMask;
+
+#if PK_DICT_NEON
+#define DICT_LANE_SHIFT 2  // one bit out of each nibble
+#else
+#define DICT_LANE_SHIFT 0  // one bit per lane
+#endif
+
+static int DictMask__lowest(DictMask mask) { return c11__ctz64(mask) >> DICT_LANE_SHIFT; }
+
+#if PK_DICT_SSE2
+static DictMask DictGroup__match(const uint8_t* g, uint8_t h2) {
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)g);
+    return (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+}
+
+static DictMask DictGroup__match_empty(const uint8_t* g) {
+    return DictGroup__match(g, DICT_CTRL_EMPTY);
+}
+
+static DictMask DictGroup__match_free(const uint8_t* g) {
+    // empty or deleted, i.e. the high bit is set
+    return (uint16_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)g));
+}
+#elif PK_DICT_NEON
+static DictMask DictGroup__movemask(uint8x16_t cmp) {
+    uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(nibbles), 0) & 0x8888888888888888ULL;
+}
+
+static DictMask DictGroup__match(const uint8_t* g, uint8_t h2) {
+    return DictGroup__movemask(vceqq_u8(vld1q_u8(g), vdupq_n_u8(h2)));
+}
+
+static DictMask DictGroup__match_empty(const uint8_t* g) {
+    return DictGroup__match(g, DICT_CTRL_EMPTY);
+}
+
+static DictMask DictGroup__match_free(const uint8_t* g) {
+    return DictGroup__movemask(vtstq_u8(vld1q_u8(g), vdupq_n_u8(0x80)));
+}
+#else
+static DictMask DictGroup__match(const uint8_t* g, uint8_t h2) {
+    DictMask mask = 0;
+    for(int i = 0; i < PK_DICT_GROUP_WIDTH; i++) {
+        if(g[i] == h2) mask |= (DictMask)1 << i;
+    }
+    return mask;
+}
+
+static DictMask DictGroup__match_empty(const uint8_t* g) {
+    return DictGroup__match(g, DICT_CTRL_EMPTY);
+}
+
+static DictMask DictGroup__match_free(const uint8_t* g) {
+    DictMask mask = 0;
+    for(int i = 0; i < PK_DICT_GROUP_WIDTH; i++) {
+        if(g[i] & 0x80) mask |= (DictMask)1 << i;
     }
+    return mask;
+}
+#endif
+
+// the 7-bit tag; int hashes are the identity, so take the top bits of a multiplicative hash
+static uint8_t Dict__h2(uint64_t hash) { return (hash * 0x9E3779B97F4A7C15ULL) >> 57; }
+
+/* Groups are probed like CPython's dict: the first group comes from the raw hash, so sequential
+ * ints fill adjacent groups, then `perturb` folds in the high bits to break up clustered keys.
+ * `5 * group + 1` alone visits every group when the count is a power of two. */
+typedef struct {
+    uint32_t group;
+    uint32_t group_mask;
+    uint64_t perturb;
+} DictProbe;
+
+static DictProbe DictProbe__start(const Dict* self, uint64_t hash) {
+    DictProbe p;
+    p.group_mask = self->capacity / PK_DICT_GROUP_WIDTH - 1;
+    p.group = (uint32_t)(hash / PK_DICT_GROUP_WIDTH) & p.group_mask;
+    p.perturb = hash;
+    return p;
 }
 
+static void DictProbe__next(DictProbe* p) {
+    p->perturb >>= 5;
+    p->group = (p->group * 5 + 1 + (uint32_t)p->perturb) & p->group_mask;
+}
 
+// keep the load factor at or below 7/8
+static uint32_t Dict__max_load(uint32_t capacity) { return capacity - capacity / 8; }
 
 typedef struct {
     DictEntry* curr;
     DictEntry* end;
 } DictIterator;
 
+static void Dict__alloc_table(Dict* self, uint32_t capacity) {
+    assert(capacity >= PK_DICT_GROUP_WIDTH && (capacity & (capacity - 1)) == 0);
+    uint32_t n_groups = capacity / PK_DICT_GROUP_WIDTH;
+    self->capacity = capacity;
+    self->growth_left = Dict__max_load(capacity);
+    self->groups = PK_MALLOC(n_groups * sizeof(DictGroup));
+    for(uint32_t i = 0; i < n_groups; i++) {
+        memset(self->groups[i].ctrl, DICT_CTRL_EMPTY, PK_DICT_GROUP_WIDTH);
+    }
+}
+
 static void Dict__ctor(Dict* self, uint32_t capacity, int entries_capacity) {
     self->length = 0;
-    self->capacity = capacity;
-    self->indices = PK_MALLOC(self->capacity * sizeof(DictIndex));
-    memset(self->indices, -1, self->capacity * sizeof(DictIndex));
+    Dict__alloc_table(self, capacity);
     c11_vector__ctor(&self->entries, sizeof(DictEntry));
     c11_vector__reserve(&self->entries, entries_capacity);
 }
@@ -70,70 +138,80 @@ static void Dict__ctor(Dict* self, uint32_t capacity, int entries_capacity) {
 static void Dict__dtor(Dict* self) {
     self->length = 0;
     self->capacity = 0;
-    PK_FREE(self->indices);
+    PK_FREE(self->groups);
     c11_vector__dtor(&self->entries);
 }
 
-static bool Dict__try_get(Dict* self, py_TValue* key, DictEntry** out) {
-    py_i64 hash;
-    if(!py_hash(key, &hash)) return false;
-    int idx = (uint64_t)hash % self->capacity;
-    for(int i = 0; i < PK_DICT_MAX_COLLISION; i++) {
-        int idx2 = self->indices[idx]._[i];
-        if(idx2 == -1) continue;
-        DictEntry* entry = c11__at(DictEntry, &self->entries, idx2);
-        if(entry->hash == (uint64_t)hash) {
-            int res = py_equal(&entry->key, key);
-            if(res == 1) {
-                *out = entry;
-                return true;
+static int Dict__key_equal(py_TValue* lhs, py_TValue* rhs) {
+    if(lhs->type == tp_str && rhs->type == tp_str) {
+        // hashes already matched, so this rarely compares unequal strings
+        c11_sv a = py_tosv(lhs);
+        c11_sv b = py_tosv(rhs);
+        return a.size == b.size && memcmp(a.data, b.data, a.size) == 0;
+    }
+    return py_equal(lhs, rhs);
+}
+
+/// Find the slot holding `key`.
+/// -1: error, 0: not found, 1: found (`*out` is the slot index)
+static int Dict__find(Dict* self, py_TValue* key, uint64_t hash, int* out) {
+    uint8_t h2 = Dict__h2(hash);
+    for(DictProbe p = DictProbe__start(self, hash);; DictProbe__next(&p)) {
+        DictGroup* g = &self->groups[p.group];
+        DictMask mask = DictGroup__match(g->ctrl, h2);
+        while(mask) {
+            int lane = DictMask__lowest(mask);
+            DictEntry* entry = c11__at(DictEntry, &self->entries, g->slots[lane]);
+            if(entry->hash == hash) {
+                int res = Dict__key_equal(&entry->key, key);
+                if(res == 1) {
+                    *out = p.group * PK_DICT_GROUP_WIDTH + lane;
+                    return 1;
+                }
+                if(res == -1) return -1;  // error
             }
-            if(res == -1) return false;  // error
+            mask &= mask - 1;
         }
+        if(DictGroup__match_empty(g->ctrl)) return 0;
     }
-    *out = NULL;
-    return true;
 }
 
-static void Dict__clear(Dict* self) {
-    memset(self->indices, -1, self->capacity * sizeof(DictIndex));
-    c11_vector__clear(&self->entries);
-    self->length = 0;
+/// Find the first empty or deleted slot on the probe sequence of `hash`.
+static int Dict__find_free(Dict* self, uint64_t hash) {
+    for(DictProbe p = DictProbe__start(self, hash);; DictProbe__next(&p)) {
+        DictMask mask = DictGroup__match_free(self->groups[p.group].ctrl);
+        if(mask) return p.group * PK_DICT_GROUP_WIDTH + DictMask__lowest(mask);
+    }
 }
 
-static void Dict__rehash_2x(Dict* self) {
-    Dict old_dict = *self;
-    uint32_t new_capacity = self->capacity;
+#define DICT_CTRL(self, slot)                                                                      \
+    (self)->groups[(slot) / PK_DICT_GROUP_WIDTH].ctrl[(slot) % PK_DICT_GROUP_WIDTH]
+#define DICT_SLOT(self, slot)                                                                      \
+    (self)->groups[(slot) / PK_DICT_GROUP_WIDTH].slots[(slot) % PK_DICT_GROUP_WIDTH]
 
-__RETRY:
-    // use next capacity
-    new_capacity = Dict__next_cap(new_capacity);
-    // create a new dict with new capacity
-    Dict__ctor(self, new_capacity, old_dict.entries.capacity);
-    // move entries from old dict to new dict
-    for(int i = 0; i < old_dict.entries.length; i++) {
-        DictEntry* old_entry = c11__at(DictEntry, &old_dict.entries, i);
-        if(py_isnil(&old_entry->key)) continue;
-        int idx = old_entry->hash % new_capacity;
-        bool success = false;
-        for(int i = 0; i < PK_DICT_MAX_COLLISION; i++) {
-            int idx2 = self->indices[idx]._[i];
-            if(idx2 == -1) {
-                // insert new entry (empty slot)
-                c11_vector__push(DictEntry, &self->entries, *old_entry);
-                self->indices[idx]._[i] = self->entries.length - 1;
-                self->length++;
-                success = true;
-                break;
-            }
-        }
-        if(!success) {
-            Dict__dtor(self);
-            goto __RETRY;
-        }
+static void Dict__fill_slot(Dict* self, int slot, uint64_t hash, int index) {
+    if(DICT_CTRL(self, slot) == DICT_CTRL_EMPTY) self->growth_left--;
+    DICT_CTRL(self, slot) = Dict__h2(hash);
+    DICT_SLOT(self, slot) = index;
+}
+
+static bool Dict__try_get(Dict* self, py_TValue* key, DictEntry** out) {
+    py_i64 hash;
+    if(!py_hash(key, &hash)) return false;
+    int slot;
+    int res = Dict__find(self, key, (uint64_t)hash, &slot);
+    if(res == -1) return false;
+    *out = res ? c11__at(DictEntry, &self->entries, DICT_SLOT(self, slot)) : NULL;
+    return true;
+}
+
+static void Dict__clear(Dict* self) {
+    for(uint32_t i = 0; i < self->capacity / PK_DICT_GROUP_WIDTH; i++) {
+        memset(self->groups[i].ctrl, DICT_CTRL_EMPTY, PK_DICT_GROUP_WIDTH);
     }
-    // done
-    Dict__dtor(&old_dict);
+    self->growth_left = Dict__max_load(self->capacity);
+    c11_vector__clear(&self->entries);
+    self->length = 0;
 }
 
 static void Dict__compact_entries(Dict* self) {
@@ -151,68 +229,52 @@ static void Dict__compact_entries(Dict* self) {
         n++;
     }
     self->entries.length = n;
-    // update indices
+    // update slots
     for(uint32_t i = 0; i < self->capacity; i++) {
-        for(int j = 0; j < PK_DICT_MAX_COLLISION; j++) {
-            int idx = self->indices[i]._[j];
-            if(idx == -1) continue;
-            self->indices[i]._[j] = mappings[idx];
-        }
+        if(DICT_CTRL(self, i) & 0x80) continue;
+        DICT_SLOT(self, i) = mappings[DICT_SLOT(self, i)];
     }
     PK_FREE(mappings);
 }
 
+/// Rebuild the index without tombstones, doubling the capacity only when
+/// the live entries alone would fill more than half of it.
+static void Dict__rehash(Dict* self) {
+    uint32_t new_capacity = self->capacity;
+    if((uint32_t)self->length >= Dict__max_load(self->capacity) / 2) new_capacity *= 2;
+    if(self->length != self->entries.length) Dict__compact_entries(self);
+    PK_FREE(self->groups);
+    Dict__alloc_table(self, new_capacity);
+    for(int i = 0; i < self->entries.length; i++) {
+        DictEntry* entry = c11__at(DictEntry, &self->entries, i);
+        Dict__fill_slot(self, Dict__find_free(self, entry->hash), entry->hash, i);
+    }
+}
+
 static bool Dict__set(Dict* self, py_TValue* key, py_TValue* val) {
     py_i64 hash;
     if(!py_hash(key, &hash)) return false;
-    int idx = (uint64_t)hash % self->capacity;
-    int bad_hash_count = 0;
-    for(int i = 0; i < PK_DICT_MAX_COLLISION; i++) {
-        int idx2 = self->indices[idx]._[i];
-        if(idx2 == -1) {
-            // insert new entry
-            DictEntry* new_entry = c11_vector__emplace(&self->entries);
-            new_entry->hash = (uint64_t)hash;
-            new_entry->key = *key;
-            new_entry->val = *val;
-            self->indices[idx]._[i] = self->entries.length - 1;
-            self->length++;
-            return true;
-        }
+    int slot;
+    int res = Dict__find(self, key, (uint64_t)hash, &slot);
+    if(res == -1) return false;  // error
+    if(res == 1) {
         // update existing entry
-        DictEntry* entry = c11__at(DictEntry, &self->entries, idx2);
-        // check if they have the same hash
-        if(entry->hash == (uint64_t)hash) {
-            // check if they are equal
-            int res = py_equal(&entry->key, key);
-            if(res == 1) {
-                entry->val = *val;
-                return true;
-            }
-            if(res == -1) return false;  // error
-            // res == 0
-            bad_hash_count++;
-        }
-    }
-    // no empty slot found
-    if(bad_hash_count == PK_DICT_MAX_COLLISION) {
-        // all `PK_DICT_MAX_COLLISION` slots have the same hash but different keys
-        // we are unable to solve this collision via rehashing
-        return RuntimeError("dict: %d/%d/%d: maximum collision reached (hash=%i)",
-                            self->entries.length,
-                            self->entries.capacity,
-                            self->capacity,
-                            hash);
+        c11__at(DictEntry, &self->entries, DICT_SLOT(self, slot))->val = *val;
+        return true;
     }
-
-    if(self->capacity >= (uint32_t)self->entries.length * 10) {
-        return RuntimeError("dict: %d/%d/%d: minimum load factor reached",
-                            self->entries.length,
-                            self->entries.capacity,
-                            self->capacity);
+    // insert new entry
+    slot = Dict__find_free(self, (uint64_t)hash);
+    if(self->growth_left == 0 && DICT_CTRL(self, slot) == DICT_CTRL_EMPTY) {
+        Dict__rehash(self);
+        slot = Dict__find_free(self, (uint64_t)hash);
     }
-    Dict__rehash_2x(self);
-    return Dict__set(self, key, val);
+    DictEntry* new_entry = c11_vector__emplace(&self->entries);
+    new_entry->hash = (uint64_t)hash;
+    new_entry->key = *key;
+    new_entry->val = *val;
+    Dict__fill_slot(self, slot, (uint64_t)hash, self->entries.length - 1);
+    self->length++;
+    return true;
 }
 
 /// Delete an entry from the dict.
@@ -220,25 +282,23 @@ static bool Dict__set(Dict* self, py_TValue* key, py_TValue* val) {
 static int Dict__pop(Dict* self, py_Ref key) {
     py_i64 hash;
     if(!py_hash(key, &hash)) return -1;
-    int idx = (uint64_t)hash % self->capacity;
-    for(int i = 0; i < PK_DICT_MAX_COLLISION; i++) {
-        int idx2 = self->indices[idx]._[i];
-        if(idx2 == -1) continue;
-        DictEntry* entry = c11__at(DictEntry, &self->entries, idx2);
-        if(entry->hash == (uint64_t)hash) {
-            int res = py_equal(&entry->key, key);
-            if(res == 1) {
-                *py_retval() = entry->val;
-                py_newnil(&entry->key);
-                self->indices[idx]._[i] = -1;
-                self->length--;
-                if(self->length < self->entries.length / 2) Dict__compact_entries(self);
-                return 1;
-            }
-            if(res == -1) return -1;  // error
-        }
+    int slot;
+    int res = Dict__find(self, key, (uint64_t)hash, &slot);
+    if(res != 1) return res;
+    DictEntry* entry = c11__at(DictEntry, &self->entries, DICT_SLOT(self, slot));
+    *py_retval() = entry->val;
+    py_newnil(&entry->key);
+    // a group that still has an empty slot never stopped a probe sequence,
+    // so the slot can become empty again instead of a tombstone
+    if(DictGroup__match_empty(self->groups[slot / PK_DICT_GROUP_WIDTH].ctrl)) {
+        DICT_CTRL(self, slot) = DICT_CTRL_EMPTY;
+        self->growth_left++;
+    } else {
+        DICT_CTRL(self, slot) = DICT_CTRL_DELETED;
     }
-    return 0;
+    self->length--;
+    if(self->length < self->entries.length / 2) Dict__compact_entries(self);
+    return 1;
 }
 
 static void DictIterator__ctor(DictIterator* self, Dict* dict) {
@@ -260,13 +320,13 @@ static bool dict__new__(int argc, py_Ref argv) {
     py_Type cls = py_totype(argv);
     int slots = cls == tp_dict ? 0 : -1;
     Dict* ud = py_newobject(py_retval(), cls, slots, sizeof(Dict));
-    Dict__ctor(ud, 7, 8);
+    Dict__ctor(ud, PK_DICT_GROUP_WIDTH, 8);
     return true;
 }
 
 void py_newdict(py_Ref out) {
     Dict* ud = py_newobject(out, tp_dict, 0, sizeof(Dict));
-    Dict__ctor(ud, 7, 8);
+    Dict__ctor(ud, PK_DICT_GROUP_WIDTH, 8);
 }
 
 static bool dict__init__(int argc, py_Ref argv) {
@@ -310,7 +370,9 @@ static bool dict__getitem__(int argc, py_Ref argv) {
 static bool dict__setitem__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(3);
     Dict* self = py_touserdata(argv);
-    return Dict__set(self, py_arg(1), py_arg(2));
+    if(!Dict__set(self, py_arg(1), py_arg(2))) return false;
+    py_newnone(py_retval());
+    return true;
 }
 
 static bool dict__delitem__(int argc, py_Ref argv) {
@@ -424,12 +486,13 @@ static bool dict_copy(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     Dict* self = py_touserdata(argv);
     Dict* new_dict = py_newobject(py_retval(), tp_dict, 0, sizeof(Dict));
-    new_dict->capacity = self->capacity;
     new_dict->length = self->length;
     new_dict->entries = c11_vector__copy(&self->entries);
-    // copy indices
-    new_dict->indices = PK_MALLOC(new_dict->capacity * sizeof(DictIndex));
-    memcpy(new_dict->indices, self->indices, new_dict->capacity * sizeof(DictIndex));
+    // copy the index table
+    Dict__alloc_table(new_dict, self->capacity);
+    new_dict->growth_left = self->growth_left;
+    uint32_t n_groups = self->capacity / PK_DICT_GROUP_WIDTH;
+    memcpy(new_dict->groups, self->groups, n_groups * sizeof(DictGroup));
     return true;
 }
 
@@ -640,4 +703,10 @@ bool py_dict_apply(py_Ref self, bool (*f)(py_Ref, py_Ref, void*), void* ctx) {
     return true;
 }
 
-#undef PK_DICT_MAX_COLLISION
\ No newline at end of file
+#undef DICT_CTRL_EMPTY
+#undef DICT_CTRL_DELETED
+#undef DICT_LANE_SHIFT
+#undef PK_DICT_SSE2
+#undef PK_DICT_NEON
+#undef DICT_CTRL
+#undef DICT_SLOT
\ No newline at end of file
@@ -86,6 +86,7 @@ static bool namedict_clear(int argc, py_Ref argv) {
     py_Ref object = py_getslot(argv, 0);
     NameDict* dict = PyObject__dict(object->_obj);
     NameDict__clear(dict);
+    if(object->type == tp_type) pk__type_modified(py_totype(object));
     py_newnone(py_retval());
     return true;
 }
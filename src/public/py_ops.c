@@ -45,6 +45,16 @@ int py_bool(py_Ref val) {
 }
 
 bool py_hash(py_Ref val, int64_t* out) {
+    if(val->type == tp_str) {
+        // fast path for str keys, the hash is cached in the object
+        *out = c11_string__hash(py_touserdata(val));
+        return true;
+    }
+    if(val->type == tp_int) {
+        // int is sealed and hashes to itself
+        *out = val->_i64;
+        return true;
+    }
     py_TypeInfo* ti = pk__type_info(val->type);
     do {
         py_Ref slot_hash = TypeList__magic_common(ti, __hash__);
@@ -84,10 +94,22 @@ int py_next(py_Ref val) {
     return -1;
 }
 
-bool py_getattr(py_Ref self, py_Name name) {
+py_Ref pk_inlinecache__lookup(InlineCache* cache, py_Type type) {
+    // magic slots can be written through `py_tpgetmagic`, which does not bump the version
+    if(py_ismagicname(cache->name)) return py_tpfindname(type, cache->name);
+    uint32_t version = pk__type_info(type)->version;
+    if(cache->type != type || cache->version != version) {
+        cache->type = type;
+        cache->version = version;
+        cache->cls_var = py_tpfindname(type, cache->name);
+    }
+    return cache->cls_var;
+}
+
+// `cls_var` is the result of `py_tpfindname(self->type, name)`
+static bool pk__getattr(py_Ref self, py_Name name, py_Ref cls_var, int* dict_hint) {
     // https://docs.python.org/3/howto/descriptor.html#invocation-from-an-instance
     py_Type type = self->type;
-    py_Ref cls_var = py_tpfindname(type, name);
     if(cls_var) {
         // handle descriptor
         if(py_istype(cls_var, tp_property)) {
@@ -98,7 +120,9 @@ bool py_getattr(py_Ref self, py_Name name) {
     // handle instance __dict__
     if(self->is_ptr && self->_obj->slots == -1) {
         if(!py_istype(self, tp_type)) {
-            py_Ref res = py_getdict(self, name);
+            NameDict* dict = PyObject__dict(self->_obj);
+            py_Ref res = dict_hint ? NameDict__try_get_hinted(dict, name, dict_hint)
+                                   : NameDict__try_get(dict, name);
             if(res) {
                 py_assign(py_retval(), res);
                 return true;
@@ -175,9 +199,16 @@ bool py_getattr(py_Ref self, py_Name name) {
     return AttributeError(self, name);
 }
 
-bool py_setattr(py_Ref self, py_Name name, py_Ref val) {
-    py_Type type = self->type;
-    py_Ref cls_var = py_tpfindname(type, name);
+bool py_getattr(py_Ref self, py_Name name) {
+    return pk__getattr(self, name, py_tpfindname(self->type, name), NULL);
+}
+
+bool pk_getattr_cached(py_Ref self, InlineCache* cache) {
+    py_Ref cls_var = pk_inlinecache__lookup(cache, self->type);
+    return pk__getattr(self, cache->name, cls_var, &cache->dict_index);
+}
+
+static bool pk__setattr(py_Ref self, py_Name name, py_Ref val, py_Ref cls_var, int* dict_hint) {
     if(cls_var) {
         // handle descriptor
         if(py_istype(cls_var, tp_property)) {
@@ -195,13 +226,26 @@ bool py_setattr(py_Ref self, py_Name name, py_Ref val) {
 
     // handle instance __dict__
     if(self->is_ptr && self->_obj->slots == -1) {
-        py_setdict(self, name, val);
+        if(dict_hint && self->type != tp_type) {
+            NameDict__set_hinted(PyObject__dict(self->_obj), name, *val, dict_hint);
+        } else {
+            py_setdict(self, name, val);
+        }
         return true;
     }
 
     return TypeError("cannot set attribute");
 }
 
+bool py_setattr(py_Ref self, py_Name name, py_Ref val) {
+    return pk__setattr(self, name, val, py_tpfindname(self->type, name), NULL);
+}
+
+bool pk_setattr_cached(py_Ref self, InlineCache* cache, py_Ref val) {
+    py_Ref cls_var = pk_inlinecache__lookup(cache, self->type);
+    return pk__setattr(self, cache->name, val, cls_var, &cache->dict_index);
+}
+
 bool py_delattr(py_Ref self, py_Name name) {
     if(self->is_ptr && self->_obj->slots == -1) {
         if(py_deldict(self, name)) return true;
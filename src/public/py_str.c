@@ -20,6 +20,18 @@ char* py_newstrn(py_Ref out, int size) {
     return ud->data;
 }
 
+// like `py_newstrn()`, a non-ascii string gets room for its codepoint index
+static char* str__new(py_OutRef out, int size, bool ascii) {
+    ManagedHeap* heap = &pk_current_vm->heap;
+    PyObject* obj = ManagedHeap__gcnew(heap, tp_str, 0, c11_string__sizeof(size, ascii));
+    c11_string* ud = PyObject__userdata(obj);
+    c11_string__ctor4(ud, size, ascii);
+    out->type = tp_str;
+    out->is_ptr = true;
+    out->_obj = obj;
+    return ud->data;
+}
+
 void py_newstrv(py_OutRef out, c11_sv sv) {
     if(sv.size == 0) {
         *out = pk_current_vm->ascii_literals[128];
@@ -32,7 +44,7 @@ void py_newstrv(py_OutRef out, c11_sv sv) {
             return;
         }
     }
-    char* data = py_newstrn(out, sv.size);
+    char* data = str__new(out, sv.size, c11__is_ascii(sv.data, sv.size));
     memcpy(data, sv.data, sv.size);
 }
 
@@ -58,25 +70,64 @@ unsigned char* py_newbytes(py_Ref out, int size) {
     return ud->data;
 }
 
-const char* py_tostr(py_Ref self) {
+/* Strings produced by `str.__add__` may share a growable buffer, which is a `bytes` object kept
+ * in slot 0 whose size is the number of bytes in use. Such a string is a view, other strings keep
+ * their bytes inline. Adding to the string which ends at the end of the buffer writes in place,
+ * so building a string with `s += x` is amortized linear. This overwrites the null-terminator of
+ * the shorter strings, they are copied out on the next read. */
+#define STR_BUFFER_MIN_SIZE 256
+
+static c11_string* str__userdata(py_Ref self) {
     assert(self->type == tp_str);
     c11_string* ud = PyObject__userdata(self->_obj);
-    return ud->data;
+    if(!ud->is_view) return ud;
+    c11_string_ref* ref = c11_string__ref(ud);
+    if(ref->data[ud->size] != '\0') {
+        // only a shared buffer can lose the null-terminator
+        assert(self->_obj->slots == 1);
+        py_Ref buffer = PyObject__slots(self->_obj);
+        unsigned char* p = py_newbytes(buffer, ud->size + 1);
+        memcpy(p, ref->data, ud->size);
+        p[ud->size] = '\0';
+        ((c11_bytes*)py_touserdata(buffer))->size = ud->size;
+        ref->data = (char*)p;
+        ref->capacity = ud->size + 1;
+    }
+    return ud;
 }
 
-const char* py_tostrn(py_Ref self, int* size) {
-    assert(self->type == tp_str);
-    c11_string* ud = PyObject__userdata(self->_obj);
-    *size = ud->size;
-    return ud->data;
+static void str__newview(py_OutRef out, py_Ref buffer, int size, int capacity) {
+    int ud_size = sizeof(c11_string) + sizeof(c11_string_ref);
+    PyObject* obj = ManagedHeap__gcnew(&pk_current_vm->heap, tp_str, 1, ud_size);
+    c11_string* ud = PyObject__userdata(obj);
+    c11_bytes* buf = py_touserdata(buffer);
+    c11_string__ctor_view(ud, (c11_sv){(char*)buf->data, size});
+    c11_string__ref(ud)->capacity = capacity;
+    PyObject__slots(obj)[0] = *buffer;
+    out->type = tp_str;
+    out->is_ptr = true;
+    out->_obj = obj;
 }
 
-c11_sv py_tosv(py_Ref self) {
-    assert(self->type == tp_str);
-    c11_string* ud = PyObject__userdata(self->_obj);
-    return c11_string__sv(ud);
+void pk_newstrview(py_OutRef out, c11_sv sv) {
+    int ud_size = sizeof(c11_string) + sizeof(c11_string_ref);
+    PyObject* obj = ManagedHeap__gcnew(&pk_current_vm->heap, tp_str, 0, ud_size);
+    c11_string__ctor_view(PyObject__userdata(obj), sv);
+    out->type = tp_str;
+    out->is_ptr = true;
+    out->_obj = obj;
+}
+
+const char* py_tostr(py_Ref self) { return c11_string__sv(str__userdata(self)).data; }
+
+const char* py_tostrn(py_Ref self, int* size) {
+    c11_sv sv = c11_string__sv(str__userdata(self));
+    *size = sv.size;
+    return sv.data;
 }
 
+c11_sv py_tosv(py_Ref self) { return c11_string__sv(str__userdata(self)); }
+
 unsigned char* py_tobytes(py_Ref self, int* size) {
     assert(self->type == tp_bytes);
     c11_bytes* ud = PyObject__userdata(self->_obj);
@@ -104,20 +155,15 @@ static bool str__new__(int argc, py_Ref argv) {
 
 static bool str__hash__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    int size;
-    const char* data = py_tostrn(&argv[0], &size);
-    uint64_t res = 0;
-    for(int i = 0; i < size; i++) {
-        res = res * 31 + data[i];
-    }
-    py_newint(py_retval(), res);
+    c11_string* self = py_touserdata(&argv[0]);
+    py_newint(py_retval(), c11_string__hash(self));
     return true;
 }
 
 static bool str__len__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_string* self = py_touserdata(&argv[0]);
-    py_newint(py_retval(), c11_sv__u8_length((c11_sv){self->data, self->size}));
+    py_newint(py_retval(), c11_string__u8_length(self));
     return true;
 }
 
@@ -126,22 +172,47 @@ static bool str__add__(int argc, py_Ref argv) {
     c11_string* self = py_touserdata(&argv[0]);
     if(py_arg(1)->type != tp_str) {
         py_newnotimplemented(py_retval());
-    } else {
-        c11_string* other = py_touserdata(&argv[1]);
-        int total_size = sizeof(c11_string) + self->size + other->size + 1;
-        c11_string* res = py_newobject(py_retval(), tp_str, 0, total_size);
-        res->size = self->size + other->size;
-        char* p = res->data;
-        memcpy(p, self->data, self->size);
-        memcpy(p + self->size, other->data, other->size);
-        p[res->size] = '\0';
+        return true;
     }
+    c11_string* other = py_touserdata(&argv[1]);
+    c11_sv lhs = c11_string__sv(self);
+    c11_sv rhs = c11_string__sv(other);
+    int size = lhs.size + rhs.size;
+    PyObject* obj = argv[0]._obj;
+    if(obj->slots == 1) {
+        py_Ref buffer = PyObject__slots(obj);
+        c11_bytes* buf = py_touserdata(buffer);
+        c11_string_ref* ref = c11_string__ref(self);
+        if(buf->size == lhs.size && size < ref->capacity) {
+            memcpy(ref->data + lhs.size, rhs.data, rhs.size);
+            ref->data[size] = '\0';
+            buf->size = size;
+            str__newview(py_retval(), buffer, size, ref->capacity);
+            return true;
+        }
+    }
+    if(size >= STR_BUFFER_MIN_SIZE && size < INT32_MAX / 2) {
+        py_TValue buffer;
+        int capacity = size * 2 + 1;
+        unsigned char* p = py_newbytes(&buffer, capacity);
+        memcpy(p, lhs.data, lhs.size);
+        memcpy(p + lhs.size, rhs.data, rhs.size);
+        p[size] = '\0';
+        ((c11_bytes*)py_touserdata(&buffer))->size = size;
+        str__newview(py_retval(), &buffer, size, capacity);
+        return true;
+    }
+    bool ascii = c11_string__is_ascii(self) && c11_string__is_ascii(other);
+    char* p = str__new(py_retval(), size, ascii);
+    memcpy(p, lhs.data, lhs.size);
+    memcpy(p + lhs.size, rhs.data, rhs.size);
     return true;
 }
 
 static bool str__mul__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
-    c11_string* self = py_touserdata(&argv[0]);
+    c11_string* ud = py_touserdata(&argv[0]);
+    c11_sv self = c11_string__sv(ud);
     if(py_arg(1)->type != tp_int) {
         py_newnotimplemented(py_retval());
     } else {
@@ -149,14 +220,10 @@ static bool str__mul__(int argc, py_Ref argv) {
         if(n <= 0) {
             py_newstr(py_retval(), "");
         } else {
-            int total_size = sizeof(c11_string) + self->size * n + 1;
-            c11_string* res = py_newobject(py_retval(), tp_str, 0, total_size);
-            res->size = self->size * n;
-            char* p = res->data;
+            char* p = str__new(py_retval(), self.size * n, c11_string__is_ascii(ud));
             for(int i = 0; i < n; i++) {
-                memcpy(p + i * self->size, self->data, self->size);
+                memcpy(p + i * self.size, self.data, self.size);
             }
-            p[res->size] = '\0';
         }
     }
     return true;
@@ -171,8 +238,8 @@ static bool str__contains__(int argc, py_Ref argv) {
         py_newnotimplemented(py_retval());
     } else {
         c11_string* other = py_touserdata(&argv[1]);
-        const char* p = strstr(self->data, other->data);
-        py_newbool(py_retval(), p != NULL);
+        int index = c11_sv__index2(c11_string__sv(self), c11_string__sv(other), 0);
+        py_newbool(py_retval(), index != -1);
     }
     return true;
 }
@@ -202,19 +269,19 @@ static bool str__iter__(int argc, py_Ref argv) {
 
 static bool str__getitem__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(2);
-    c11_sv self = c11_string__sv(py_touserdata(&argv[0]));
+    c11_string* self = py_touserdata(&argv[0]);
     py_Ref _1 = py_arg(1);
     if(_1->type == tp_int) {
         int index = py_toint(py_arg(1));
-        if(!pk__normalize_index(&index, self.size)) return false;
-        c11_sv res = c11_sv__u8_getitem(self, index);
+        if(!pk__normalize_index(&index, c11_string__u8_length(self))) return false;
+        c11_sv res = c11_string__u8_getitem(self, index);
         py_newstrv(py_retval(), res);
         return true;
     } else if(_1->type == tp_slice) {
         int start, stop, step;
-        bool ok = pk__parse_int_slice(_1, c11_sv__u8_length(self), &start, &stop, &step);
+        bool ok = pk__parse_int_slice(_1, c11_string__u8_length(self), &start, &stop, &step);
         if(!ok) return false;
-        c11_string* res = c11_sv__u8_slice(self, start, stop, step);
+        c11_string* res = c11_string__u8_slice(self, start, stop, step);
         py_newstrv(py_retval(), (c11_sv){res->data, res->size});
         c11_string__delete(res);
         return true;
@@ -248,31 +315,25 @@ DEF_STR_CMP_OP(__ge__, c11_sv__cmp, res >= 0)
 
 static bool str_lower(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    c11_string* self = py_touserdata(&argv[0]);
-    int total_size = sizeof(c11_string) + self->size + 1;
-    c11_string* res = py_newobject(py_retval(), tp_str, 0, total_size);
-    res->size = self->size;
-    char* p = res->data;
-    for(int i = 0; i < self->size; i++) {
-        char c = self->data[i];
+    c11_string* ud = py_touserdata(&argv[0]);
+    c11_sv self = c11_string__sv(ud);
+    char* p = str__new(py_retval(), self.size, c11_string__is_ascii(ud));
+    for(int i = 0; i < self.size; i++) {
+        char c = self.data[i];
         p[i] = c >= 'A' && c <= 'Z' ? c + 32 : c;
     }
-    p[res->size] = '\0';
     return true;
 }
 
 static bool str_upper(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
-    c11_string* self = py_touserdata(&argv[0]);
-    int total_size = sizeof(c11_string) + self->size + 1;
-    c11_string* res = py_newobject(py_retval(), tp_str, 0, total_size);
-    res->size = self->size;
-    char* p = res->data;
-    for(int i = 0; i < self->size; i++) {
-        char c = self->data[i];
+    c11_string* ud = py_touserdata(&argv[0]);
+    c11_sv self = c11_string__sv(ud);
+    char* p = str__new(py_retval(), self.size, c11_string__is_ascii(ud));
+    for(int i = 0; i < self.size; i++) {
+        char c = self.data[i];
         p[i] = c >= 'a' && c <= 'z' ? c - 32 : c;
     }
-    p[res->size] = '\0';
     return true;
 }
 
@@ -318,8 +379,7 @@ static bool str_join(int argc, py_Ref argv) {
             c11_sbuf__dtor(&buf);
             return false;
         }
-        c11_string* item = py_touserdata(py_retval());
-        c11_sbuf__write_cstrn(&buf, item->data, item->size);
+        c11_sbuf__write_sv(&buf, c11_string__sv(py_touserdata(py_retval())));
         first = false;
     }
 
@@ -428,10 +488,10 @@ static bool str__widthjust_impl(bool left, int argc, py_Ref argv) {
         pad = ' ';
     } else {
         if(!py_checkstr(&argv[2])) return false;
-        c11_string* padstr = py_touserdata(&argv[2]);
-        if(padstr->size != 1)
+        c11_sv padstr = c11_string__sv(py_touserdata(&argv[2]));
+        if(padstr.size != 1)
             return TypeError("The fill character must be exactly one character long");
-        pad = padstr->data[0];
+        pad = padstr.data[0];
     }
     c11_sv self = c11_string__sv(py_touserdata(&argv[0]));
     PY_CHECK_ARG_TYPE(1, tp_int);
@@ -493,8 +553,8 @@ static bool str_encode(int argc, py_Ref argv) {
 }
 
 py_Type pk_str__register() {
-    py_Type type = pk_newtype("str", tp_object, NULL, NULL, false, true);
-    // no need to dtor because the memory is controlled by the object
+    // the dtor only releases the codepoint index of a non-ascii view
+    py_Type type = pk_newtype("str", tp_object, NULL, (py_Dtor)c11_string__dtor, false, true);
 
     py_bindmagic(tp_str, __new__, str__new__);
     py_bindmagic(tp_str, __hash__, str__hash__);
@@ -641,11 +701,7 @@ static bool bytes__ne__(int argc, py_Ref argv) {
 static bool bytes__hash__(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     c11_bytes* self = py_touserdata(&argv[0]);
-    uint64_t res = 0;
-    for(int i = 0; i < self->size; i++) {
-        res = res * 31 + self->data[i];
-    }
-    py_newint(py_retval(), res);
+    py_newint(py_retval(), c11__hash_bytes(self->data, self->size));
     return true;
 }
 
@@ -667,6 +723,9 @@ static bool bytes_decode(int argc, py_Ref argv) {
     PY_CHECK_ARGC(1);
     int size;
     unsigned char* data = py_tobytes(&argv[0], &size);
+    if(!c11__u8_validate((const char*)data, size)) {
+        return ValueError("'utf-8' codec can't decode bytes: invalid utf-8 sequence");
+    }
     py_newstrv(py_retval(), (c11_sv){(const char*)data, size});
     return true;
 }
@@ -709,4 +768,5 @@ bool py_repr(py_Ref val) { return pk_callmagic(__repr__, 1, val); }
 
 bool py_len(py_Ref val) { return pk_callmagic(__len__, 1, val); }
 
-#undef DEF_STR_CMP_OP
\ No newline at end of file
+#undef DEF_STR_CMP_OP
+#undef STR_BUFFER_MIN_SIZE
@@ -14,13 +14,14 @@ py_Ref py_getdict(py_Ref self, py_Name name) {
         return NameDict__try_get(PyObject__dict(self->_obj), name);
     } else {
         py_Type* ud = py_touserdata(self);
-        py_Ref slot = py_tpgetmagic(*ud, name);
+        py_Ref slot = TypeList__magic_readonly(pk__type_info(*ud), name);
         return py_isnil(slot) ? NULL : slot;
     }
 }
 
 void py_setdict(py_Ref self, py_Name name, py_Ref val) {
     assert(self && self->is_ptr);
+    if(self->type == tp_type) pk__type_modified(py_totype(self));
     if(!py_ismagicname(name) || self->type != tp_type) {
         NameDict__set(PyObject__dict(self->_obj), name, *val);
     } else {
@@ -47,6 +48,7 @@ bool py_applydict(py_Ref self, bool (*f)(py_Name, py_Ref, void*), void* ctx) {
 
 bool py_deldict(py_Ref self, py_Name name) {
     assert(self && self->is_ptr);
+    if(self->type == tp_type) pk__type_modified(py_totype(self));
     if(!py_ismagicname(name) || self->type != tp_type) {
         return NameDict__del(PyObject__dict(self->_obj), name);
     } else {
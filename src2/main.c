@@ -78,6 +78,7 @@ int main(int argc, char** argv) {
 #endif
 
     bool trace = false;
+    int optimize = 1;
     const char* filename = NULL;
 
     for(int i = 1; i < argc; i++) {
@@ -85,17 +86,22 @@ int main(int argc, char** argv) {
             trace = true;
             continue;
         }
+        if(strncmp(argv[i], "-O", 2) == 0) {
+            optimize = atoi(argv[i] + 2);
+            continue;
+        }
         if(filename == NULL) {
             filename = argv[i];
             continue;
         }
-        printf("Usage: pocketpy [--trace] filename\n");
+        printf("Usage: pocketpy [--trace] [-O<level>] filename\n");
     }
 
     py_initialize();
     py_sys_setargv(argc, argv);
 
     if(trace) py_sys_settrace(tracefunc);
+    py_sys_setoptimize(optimize);
 
     if(filename == NULL) {
         printf("pocketpy " PK_VERSION " (" __DATE__ ", " __TIME__ ") ");
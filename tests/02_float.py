@@ -98,3 +98,27 @@ assert abs(0.0) == 0.0
 #     exit(1)
 # except ValueError:
 #     pass
+
+# specialized binary ops must deoptimize when operand types change
+def poly_add(a, b):
+    return a + b
+
+def poly_lt(a, b):
+    if a < b:
+        return 'lt'
+    return 'ge'
+
+def poly_mod(a, b):
+    return a % b, a // b
+
+for _ in range(2):
+    assert poly_add(1, 2) == 3
+    assert poly_add(1.5, 2) == 3.5
+    assert poly_add(1, 2.5) == 3.5
+    assert poly_add('a', 'b') == 'ab'
+    assert poly_lt(1, 2) == 'lt'
+    assert poly_lt(2.5, 1) == 'ge'
+    assert poly_lt('a', 'b') == 'lt'
+    assert poly_mod(7, 3) == (1, 2)
+    assert poly_mod(-7, 3) == (2, -3)
+    assert poly_mod(7, -3) == (-2, -3)
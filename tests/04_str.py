@@ -228,3 +228,60 @@ assert f"{(1, 2, 3)}" == "(1, 2, 3)"
 
 # stack=[1,2,3,4]
 # assert f"{stack[2:]}" == '[3, 4]'
+
+# str hash is cached and consistent
+s = 'hello world' * 10
+assert hash(s) == hash(s) == hash('hello world' * 10)
+assert hash(b'abc') == hash(b'abc')
+d = {('k' + str(i)) * 3: i for i in range(1000)}
+for i in range(1000):
+    assert d[('k' + str(i)) * 3] == i
+
+# indexing and slicing of long non-ascii strings
+chars = ['a', 'ä', '中', '😀', 'z'] * 60
+s = ''.join(chars)
+assert len(s) == 300
+for i in range(len(s)):
+    assert s[i] == chars[i]
+    assert s[-i-1] == chars[-i-1]
+assert s[63:130] == ''.join(chars[63:130])
+assert s[5:290:7] == ''.join(chars[5:290:7])
+assert s[290:5:-3] == ''.join(chars[290:5:-3])
+assert s[::-1] == ''.join(chars[::-1])
+try:
+    s[300]
+    exit(1)
+except IndexError:
+    pass
+
+# `+=` appends in place to a shared buffer, earlier strings stay intact
+s = ''
+parts = []
+for i in range(1000):
+    s += str(i) + ','
+    if i % 100 == 0:
+        parts.append(s)
+assert s == ','.join([str(i) for i in range(1000)]) + ','
+for p in parts:
+    assert s.startswith(p)
+    assert p.endswith(',')
+a = '0' * 300 + '1.5'
+b = a + 'e3'
+c = a + 'e1'
+assert float(a) == 1.5
+assert float(b) == 1500.0
+assert float(c) == 15.0
+assert a == '0' * 300 + '1.5' and len(a) == 303
+assert {a: 1}['0' * 300 + '1.5'] == 1
+
+# codepoint access on non-ascii strings made by `+`, `*` and the shared buffer
+s = 'ab' + '你好'
+assert len(s) == 4 and s[2] == '你' and s[-1] == '好'
+s = '你' * 100
+assert len(s) == 100 and s[99] == '你' and s[40:42] == '你你'
+assert ('Aé' * 70).upper()[:4] == 'AéAé'
+s = '0' * 300
+for i in range(200):
+    s += '好'
+assert len(s) == 500 and s[299] == '0' and s[300] == '好' and s[-1] == '好'
+assert s[298:302] == '00好好'
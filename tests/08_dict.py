@@ -147,4 +147,27 @@ for i in range(-1000, 1000):
 e = {}
 for i in range(-10000, 10000, 3):
     e[i] = i
-    assert e[i] == i
\ No newline at end of file
+    assert e[i] == i
+# keys sharing low bits, interleaved deletes and reinserts
+f = {}
+for i in range(4096):
+    f[i << 16] = i
+for i in range(0, 4096, 2):
+    del f[i << 16]
+assert len(f) == 2048
+for i in range(0, 4096, 2):
+    assert (i << 16) not in f
+    f[i << 16] = -i
+assert len(f) == 4096
+assert f[2 << 16] == -2 and f[3 << 16] == 3
+assert list(f.keys())[:3] == [1 << 16, 3 << 16, 5 << 16]
+
+g = f.copy()
+g.clear()
+assert len(g) == 0 and len(f) == 4096
+for _ in range(3):
+    for i in range(100):
+        g[str(i)] = i
+    for i in range(100):
+        assert g.pop(str(i)) == i
+assert len(g) == 0
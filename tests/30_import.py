@@ -42,4 +42,98 @@ from math import (
     pow,
     sin,
     cos
-)
\ No newline at end of file
+)
+# bytecode cache
+import importlib
+import traceback
+
+src = '''
+x = [1, -2.5, 'str', None, ..., b'bytes', f'{1+1}']
+
+def f(a, *args, b=(1, 'x'), **kwargs):
+    """f doc"""
+    return a, b, args, kwargs
+
+class A:
+    y: int = 2
+    def g(self):
+        return self.y
+
+def err():
+    raise ValueError('boom')
+'''
+with open('_pkc_mod.py', 'w') as fp:
+    fp.write(src)
+
+importlib.set_cache_dir('.')
+assert importlib.compile('_pkc_mod')
+assert os.path.exists('_pkc_mod.pkc')
+assert not importlib.compile('_pkc_missing')
+
+import _pkc_mod
+assert _pkc_mod.x == [1, -2.5, 'str', None, ..., b'bytes', '2']
+assert _pkc_mod.f(1, 2, b=3, d=4) == (1, 3, (2,), {'d': 4})
+assert _pkc_mod.f(1) == (1, (1, 'x'), (), {})
+assert _pkc_mod.f.__doc__ == 'f doc'
+assert _pkc_mod.A().g() == 2
+assert _pkc_mod.A.__annotations__['y'] == 'int'
+try:
+    _pkc_mod.err()
+    exit(1)
+except ValueError:
+    assert "raise ValueError('boom')" in traceback.format_exc()
+
+# a stale cache is recompiled
+with open('_pkc_mod.py', 'w') as fp:
+    fp.write('x = 2\n')
+importlib.reload(_pkc_mod)
+assert _pkc_mod.x == 2
+
+# a cache whose instructions refer to a missing constant is rejected
+with open('_pkc_mod.py', 'w') as fp:
+    fp.write('x = 1.5\n')
+assert importlib.compile('_pkc_mod')
+with open('_pkc_mod.pkc', 'rb') as fp:
+    data = fp.read()
+# the constant table: a count of 1, then the tagged float 1.5
+consts = b'\x01\x00\x00\x00\x06\x00\x00\x00\x00\x00\x00\xf8\x3f'
+i = 0
+while data[i:i + len(consts)] != consts:
+    i += 1
+with open('_pkc_mod.pkc', 'wb') as fp:
+    fp.write(data[:i] + b'\x00\x00\x00\x00' + data[i + len(consts):])
+importlib.reload(_pkc_mod)
+assert _pkc_mod.x == 1.5
+
+importlib.set_cache_dir(None)
+os.remove('_pkc_mod.py')
+os.remove('_pkc_mod.pkc')
+
+# bundles
+with open('_pkb_mod.py', 'w') as fp:
+    fp.write('x = [1, "a", "bc"]\ndef err():\n    "err doc"\n    raise ValueError("bundled")\n')
+importlib.make_bundle('_bundle.pkb', ['_pkb_mod', 'test2.a.g'])
+os.remove('_pkb_mod.py')
+importlib.mount_bundle('_bundle.pkb')
+
+import _pkb_mod
+assert _pkb_mod.err.__doc__ == 'err doc'
+assert _pkb_mod.x == [1, 'a', 'bc']
+assert _pkb_mod.x[2] + 'd' == 'bcd'
+try:
+    _pkb_mod.err()
+    exit(1)
+except ValueError:
+    assert 'raise ValueError("bundled")' in traceback.format_exc()
+
+try:
+    importlib.make_bundle('_bundle2.pkb', ['_pkb_missing'])
+    exit(1)
+except ImportError:
+    pass
+
+try:
+    # a mapped file cannot be removed on Windows
+    os.remove('_bundle.pkb')
+except OSError:
+    pass
@@ -167,4 +167,71 @@ class DerivedClass(BaseClass):
         return super().f()
 
     
-assert DerivedClass.f() == 'BaseClass'
\ No newline at end of file
+assert DerivedClass.f() == 'BaseClass'
+# inline caches must be invalidated when a class is mutated
+class CacheA:
+    x = 1
+    def f(self):
+        return 'A.f'
+
+class CacheB(CacheA):
+    pass
+
+def get_x(o):
+    return o.x
+
+def call_f(o):
+    return o.f()
+
+b = CacheB()
+for _ in range(3):
+    assert get_x(b) == 1
+    assert call_f(b) == 'A.f'
+
+CacheA.x = 2
+CacheA.f = lambda self: 'new'
+assert get_x(b) == 2
+assert call_f(b) == 'new'
+
+b.x = 3
+assert get_x(b) == 3
+del b.x
+assert get_x(b) == 2
+
+CacheA.x = property(lambda self: 42)
+assert get_x(b) == 42
+
+# every class has its own version, mutations reach subclasses at any depth
+class CacheC(CacheB):
+    pass
+
+class CacheD(CacheA):
+    pass
+
+c = CacheC()
+d = CacheD()
+for _ in range(3):
+    assert call_f(c) == 'new'
+    assert call_f(d) == 'new'
+CacheB.f = lambda self: 'B.f'
+assert call_f(c) == 'B.f'
+assert call_f(d) == 'new'
+del CacheB.f
+assert call_f(c) == 'new'
+CacheA.f = lambda self: 'A.f2'
+assert call_f(c) == 'A.f2'
+assert call_f(d) == 'A.f2'
+
+# magic names are looked up through their slots
+class CacheE:
+    def __len__(self):
+        return 1
+
+def get_len(o):
+    return o.__len__()
+
+e = CacheE()
+for _ in range(3):
+    assert get_len(e) == 1
+CacheE.__len__ = lambda self: 2
+assert get_len(e) == 2
@@ -40,4 +40,13 @@ assert a[5:2:-2] == b",l"
 
 assert bytes() == b''
 assert bytes((65,)) == b'A'
-assert bytes([0, 1, 2, 3]) == b'\x00\x01\x02\x03'
\ No newline at end of file
+assert bytes([0, 1, 2, 3]) == b'\x00\x01\x02\x03'
+# decode validates utf-8
+assert b'hello world, this is a long ascii line'.decode() == 'hello world, this is a long ascii line'
+assert '中文ä😀'.encode().decode() == '中文ä😀'
+for bad in [b'\xff', b'abc\x80', b'\xc0\xaf', b'\xe0\x80\x80', b'\xed\xa0\x80', b'\xf4\x90\x80\x80', b'0123456789abcdef\xe4\xb8']:
+    try:
+        bad.decode()
+        exit(1)
+    except ValueError:
+        pass
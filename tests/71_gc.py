@@ -9,4 +9,75 @@ gc.collect()
 
 create_garbage()
 create_garbage()
-create_garbage()
\ No newline at end of file
+create_garbage()
+assert gc.get_mode() == 'full'
+gc.set_mode('lazy_sweep')
+assert gc.get_mode() == 'lazy_sweep'
+
+def create_linked(n):
+    head = None
+    for i in range(n):
+        head = [i, head, 'x' * 200]
+    return head
+
+keep = create_linked(1000)
+for _ in range(20):
+    create_linked(5000)
+    create_garbage()
+gc.collect()
+node = keep
+count = 0
+while node is not None:
+    assert node[0] == 999 - count and len(node[2]) == 200
+    node = node[1]
+    count += 1
+assert count == 1000
+
+gc.set_mode('full')
+assert gc.get_mode() == 'full'
+try:
+    gc.set_mode('generational')
+    exit(1)
+except ValueError:
+    pass
+
+# deep chains are marked without recursion
+deep = None
+for i in range(300000):
+    deep = [[i], deep]
+gc.collect()
+assert deep[0][0] == 299999
+del deep
+
+assert gc.get_sweep_threads() == 1
+try:
+    gc.set_sweep_threads(0)
+    exit(1)
+except ValueError:
+    pass
+try:
+    gc.set_sweep_threads(4)
+    assert gc.get_sweep_threads() == 4
+except RuntimeError:
+    # threads are not enabled in this build
+    assert gc.get_sweep_threads() == 1
+keep = [{'k': [i, str(i)]} for i in range(50000)]
+for _ in range(5):
+    create_linked(20000)
+    gc.collect()
+assert keep[49999]['k'] == [49999, '49999']
+gc.set_sweep_threads(1)
+
+# objects of every pool size class survive collections intact
+sizes = [10, 100, 200, 300, 450, 700, 900, 2000]
+kept = []
+for r in range(4):
+    for n in sizes:
+        for i in range(2000):
+            s = chr(97 + i % 26) * n
+            if i % 7 == 0:
+                kept.append(s)
+    gc.collect()
+for s in kept:
+    assert s == s[0] * len(s)
+del kept
@@ -87,4 +87,20 @@ class A:
         self.b = b
 
 a = A(1, ['2', False, None])
-assert json.dumps(a.__dict__) == '{"a": 1, "b": ["2", false, null]}'
\ No newline at end of file
+assert json.dumps(a.__dict__) == '{"a": 1, "b": ["2", false, null]}'
+assert json.loads(' {"a": [1, -2, 3.5, -1e3]} ') == {"a": [1, -2, 3.5, -1000.0]}
+assert json.loads('"\\u00e9\\ud83d\\ude00\\n\\"\\/"') == 'é😀\n"/'
+assert json.loads('-Infinity') == float('-inf')
+
+for bad in ['', '[1,', '{"a" 1}', '[1 2]', '"abc', '01', '{1: 2}', '[1,]']:
+    try:
+        json.loads(bad)
+        exit(1)
+    except ValueError:
+        pass
+
+try:
+    json.loads('[' * 5000 + ']' * 5000)
+    exit(1)
+except RecursionError:
+    pass
@@ -3,3 +3,62 @@ assert eval("1+2") == 3
 code = compile("1+2", "<eval>", "eval")
 # print(code)
 assert eval(code) == 3
+
+# the optimizer must not change the behavior
+src = '''
+def f(n):
+    """docstring"""
+    day = 60 * 60 * 24
+    s = '-' * 3 + 'x' + str(-(2 ** 10)) + str(~7) + str(not 0)
+    t = (1, (2.5, 'a'), None, ..., 1 << 62 >> 60, 7 // 2, -7 % 3, 1 / 4, 0xff & 0x0f | 0x30 ^ 1)
+    out = []
+    for i in range(n):
+        if i % 2 == 0:
+            if i > 6:
+                break
+            continue
+        elif i == 3:
+            out.append(i and 'three' or 'zero')
+        else:
+            out.append(i if i < 5 else -i)
+    try:
+        1 // 0
+        out.append('unreachable')
+    except ZeroDivisionError:
+        out.append('zde')
+    return day, s, t, out
+
+def g(x):
+    return x
+    x = 1
+    raise ValueError
+
+class P:
+    def __init__(self, x):
+        self.x = x
+
+def h(a, b):
+    c = a.x + b.x
+    return c, a.x, (a.x, b.x)
+
+result = (f(10), f.__doc__, g(2), h(P(1), P(2)))
+'''
+
+def run(optimize):
+    g = {}
+    exec(compile(src, '<opt>', 'exec', optimize), g)
+    return g['result']
+
+assert run(0) == run(1)
+assert run(1)[0] == (
+    86400, '---x-1024-8True', (1, (2.5, 'a'), None, ..., 4, 3, 2, 0.25, 63),
+    [1, 'three', -5, -7, 'zde']
+)
+assert run(1)[1:] == ('docstring', 2, (3, 1, (1, 2)))
+
+# more than 65535 constants are loaded with EXTENDED_ARG
+src = '\n'.join([f'x{i % 7} = {i}.5; s = "s{i}"' for i in range(70000)])
+for optimize in (0, 1):
+    g = {}
+    exec(compile(src, '<big>', 'exec', optimize), g)
+    assert g['x3'] == 69996.5 and g['s'] == 's69999'
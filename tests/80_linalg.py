@@ -425,3 +425,68 @@ for i in range(-1000, 10000):
     e[vec2i(i, 12)] = i
     e[vec2i(i, 11)] = i
     e[vec2i(i, 13)] = i
+
+# vec2_array / vec3_array
+from linalg import vec2_array, vec3_array, mat3x3
+
+a = vec2_array([vec2(1, 2), vec2(3, 4), vec2(0, 0)])
+assert len(a) == 3
+assert repr(a) == 'vec2_array(3)'
+assert a[1] == vec2(3, 4)
+assert a[-1] == vec2(0, 0)
+a[2] = vec2(-3, 4)
+assert a.tolist() == [vec2(1, 2), vec2(3, 4), vec2(-3, 4)]
+assert vec2_array(2).tolist() == [vec2(0, 0), vec2(0, 0)]
+
+b = vec2_array([vec2(1, 1), vec2(2, 2), vec2(3, 3)])
+assert (a + b).tolist() == [vec2(2, 3), vec2(5, 6), vec2(0, 7)]
+assert (a - vec2(1, 2)).tolist() == [vec2(0, 0), vec2(2, 2), vec2(-4, 2)]
+assert (a * 2).tolist() == [vec2(2, 4), vec2(6, 8), vec2(-6, 8)]
+assert (a * b).tolist() == [vec2(1, 2), vec2(6, 8), vec2(-9, 12)]
+assert a.dot(b) == [3.0, 14.0, 3.0]
+assert a.dot(vec2(1, 0)) == [1.0, 3.0, -3.0]
+assert a.length()[1:] == [5.0, 5.0]
+assert a.normalize()[1] == vec2(0.6, 0.8)
+assert vec2_array(1).normalize()[0] == vec2(0, 0)
+assert a.lerp(b, 0.5)[1] == vec2(2.5, 3)
+assert a.lerp(vec2(1, 2), 1.0)[2] == vec2(1, 2)
+
+c = a.copy()
+assert c == a and c is not a
+c.add_(vec2(1, 1))
+c.mul_(b)
+assert c.tolist() == [vec2(2, 3), vec2(8, 10), vec2(-6, 15)]
+assert c != a
+c.sub_(c)
+assert c == vec2_array(3)
+
+try:
+    a + vec2_array(2)
+    exit(1)
+except ValueError:
+    pass
+
+m = mat3x3.trs(vec2(10, 20), 0.5, vec2(2, 3))
+pts = a.transform_point(m)
+vecs = a.transform_vector(m)
+for i in range(len(a)):
+    assert pts[i] == m.transform_point(a[i])
+    assert vecs[i] == m.transform_vector(a[i])
+a.transform_point_(m)
+assert a == pts
+
+data = a.tobytes()
+assert type(data) is bytes and len(data) == 3 * 8
+assert vec2_array.frombytes(data) == a
+
+v = vec3_array([vec3(1, 2, 3), vec3(0, 0, 2)])
+assert v.length()[1] == 2.0
+assert v.normalize()[1] == vec3(0, 0, 1)
+assert (v + vec3(1, 1, 1)).tolist() == [vec3(2, 3, 4), vec3(1, 1, 3)]
+assert v.dot(v) == [14.0, 4.0]
+m = mat3x3(1, 2, 3, 4, 5, 6, 7, 8, 9)
+w = m @ v
+assert w.tolist() == [m @ v[0], m @ v[1]]
+v.transform_(m)
+assert v == w
+assert len(vec3_array.frombytes(v.tobytes())) == 2
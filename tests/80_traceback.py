@@ -16,4 +16,25 @@ if actual != expected:
     print(actual)
     print('--- EXPECTED RESULT ---')
     print(expected)
-    exit(1)
\ No newline at end of file
+    exit(1)
+# line numbers are looked up at many positions of a long function
+src = ['def long_f(k):', '    x = 0']
+for i in range(2000):
+    src.append('    x += 1')
+    src.append('    if x == k: raise ValueError(x)')
+src.append('    for j in range(3):')
+src.append('        try:')
+src.append('            raise KeyError(j)')
+src.append('        except KeyError:')
+src.append('            x += 1')
+src.append('    return x')
+exec('\n'.join(src))
+
+assert long_f(-1) == 2003
+for k in range(1, 2001, 37):
+    try:
+        long_f(k)
+        exit(1)
+    except ValueError:
+        actual = traceback.format_exc()
+    assert f'line {2 * k + 2}, in long_f' in actual, actual
@@ -197,6 +197,14 @@ res = a.convolve(kernel, -1)
 """
 assert res.tolist() == [[0, 4, 9, 9, 5], [0, 4, 9, 9, 5]]
 
+# separable and non-separable kernels give the same result as the definition
+kernel = array2d[int].fromlist([[1, 2, 1], [2, 4, 2], [1, 2, 1]])
+assert a.convolve(kernel, 0).tolist() == [[11, 11, 22, 31, 15], [16, 13, 20, 32, 18]]
+kernel = array2d[int].fromlist([[0, 1, 0], [1, -4, 1], [0, 1, 0]])
+assert a.convolve(kernel, 0).tolist() == [[-1, 4, -4, -9, 5], [-10, -1, 8, -15, 1]]
+assert a.convolve(array2d(1, 1, default=0.5), 0).tolist() == [[0.5, 0.0, 1.0, 2.0, 0.0], [1.5, 0.5, 0.0, 2.5, 0.5]]
+assert a.convolve(array2d(3, 3, default=1), 0.5).tolist() == [[7.5, 8.5, 13.5, 13.5, 12.5], [7.5, 8.5, 13.5, 13.5, 12.5]]
+
 mask = res == 9
 assert mask.tolist() == [
     [False, False, True, True, False],
@@ -294,3 +302,87 @@ assert (~b).tolist() == [[False, False], [True, True]]
 
 # import gc
 # gc.collect()
+
+# test array2d_packed
+from array2d import array2d_packed
+
+a = array2d_packed(3, 2, 'int8', default=5)
+assert a.dtype == 'int8' and a.shape == vec2i(3, 2)
+a[1, 1] = -7
+assert a.tolist() == [[5, 5, 5], [5, -7, 5]]
+assert a.count(5) == 5 and a.count(5.0) == 5 and a.count(1000) == 0
+assert a.get_bounding_rect(-7) == (1, 1, 1, 1)
+try:
+    a[0, 0] = 128
+    exit(1)
+except ValueError:
+    pass
+assert (a + 125).tolist() == [[-126, -126, -126], [-126, 118, -126]]
+assert (a // 2).tolist() == [[2, 2, 2], [2, -4, 2]]
+assert (a % 3).tolist() == [[2, 2, 2], [2, 2, 2]]
+assert (a / 2).dtype == 'float32'
+assert (~a).tolist() == [[-6, -6, -6], [-6, 6, -6]]
+try:
+    a // array2d_packed(3, 2, 'int8')
+    exit(1)
+except ZeroDivisionError:
+    pass
+
+m = a > 0
+assert m.dtype == 'bool' and m.any() and not m.all()
+assert (~m).tolist() == [[False, False, False], [False, True, False]]
+assert a[m] == [5, 5, 5, 5, 5]
+a[m] = 1
+assert a.tolist() == [[1, 1, 1], [1, -7, 1]]
+
+i = array2d_packed(2, 2, 'int32', default=2**31-1)
+assert (i + 1).tolist() == [[-2**31, -2**31], [-2**31, -2**31]]
+assert (i + 0.5).tolist() == [[2**31-0.5, 2**31-0.5], [2**31-0.5, 2**31-0.5]]
+
+f = array2d_packed(4, 4, 'float32', default=lambda pos: pos.x * 0.5)
+assert f.get_bounding_rect(1.5) == (3, 0, 1, 4)
+assert f.count(0.5) == 4 and f.count(0.1) == 0
+assert (f == f.copy()).all()
+v = f[1:3, 1:3]
+assert v.tolist() == [[0.5, 1.0], [0.5, 1.0]]
+assert (v + 1).tolist() == [[1.5, 2.0], [1.5, 2.0]]
+v[0, 0] = 4
+assert f[1, 1] == 4.0
+
+b = array2d_packed(2, 2, 'bool')
+assert (b | True).all() and not (b ^ b).any()
+# mixed dtypes fall back to boxed results
+assert (array2d_packed(2, 2, 'int8', default=3) == array2d[int](2, 2, default=3)).all()
+
+# test flood_fill, get_distance_field and find_path
+a = array2d[int].fromlist([
+    [0, 0, 0, 0],
+    [1, 1, 1, 0],
+    [0, 0, 0, 0],
+    [0, 1, 1, 1],
+])
+d = a.get_distance_field(vec2i(0, 0), 0)
+assert d.tolist() == [[0, 1, 2, 3], [-1, -1, -1, 4], [8, 7, 6, 5], [9, -1, -1, -1]]
+d = a.get_distance_field([vec2i(0, 0), vec2i(0, 3)], 0, 'Moore')
+assert d.tolist() == [[0, 1, 2, 3], [-1, -1, -1, 3], [1, 1, 2, 3], [0, -1, -1, -1]]
+
+path = a.find_path(vec2i(0, 0), vec2i(0, 3), 0)
+assert len(path) == 10 and path[0] == vec2i(0, 0) and path[-1] == vec2i(0, 3)
+assert len(a.find_path(vec2i(0, 0), vec2i(0, 3), 0, 'Moore')) == 7
+assert a.find_path(vec2i(0, 0), vec2i(1, 1), 0) is None
+cost = array2d[float](4, 4, default=1.0)
+cost[3, 2] = 10.0
+assert vec2i(3, 2) in a.find_path(vec2i(0, 0), vec2i(0, 2), 0, cost=cost)
+
+b = a.copy()
+assert b.flood_fill(vec2i(0, 0), 5) == 10
+assert b.tolist() == [[5, 5, 5, 5], [1, 1, 1, 5], [5, 5, 5, 5], [5, 1, 1, 1]]
+assert b.flood_fill(vec2i(1, 1), 1) == 0
+assert b.flood_fill(vec2i(1, 1), 7, 'Moore') == 3
+
+p = array2d_packed(4, 4, 'int8')
+p[a == 1] = 1
+vis, cnt = p.get_connected_components(1, 'von Neumann')
+assert cnt == 2 and vis.tolist() == [[0, 0, 0, 0], [1, 1, 1, 0], [0, 0, 0, 0], [0, 2, 2, 2]]
+assert p.find_path(vec2i(0, 0), vec2i(0, 3), 0) == path
+assert p.flood_fill(vec2i(0, 0), 3) == 10
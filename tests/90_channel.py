@@ -0,0 +1,62 @@
+from channel import Channel
+from array2d import array2d
+from linalg import vec2i
+
+ch = Channel('test', 3)
+assert ch.name == 'test'
+assert ch.capacity == 4
+assert len(ch) == 0
+assert ch.try_recv() is None
+assert ch.try_recv(-1) == -1
+
+# the same name refers to the same queue
+ch2 = Channel('test')
+assert ch2.capacity == 4
+ch.send(1)
+assert len(ch2) == 1
+assert ch2.recv() == 1
+
+# bytes and array2d are copied without pickling
+ch.send(b'\x00\x01\xff')
+a = array2d(3, 2, default=lambda pos: pos.x + pos.y * 0.5)
+a[0, 1] = vec2i(1, 2)
+ch.send(a)
+assert ch.recv() == b'\x00\x01\xff'
+b = ch.recv()
+assert b is not a and b == a
+assert b[0, 1] == vec2i(1, 2)
+
+# everything else goes through pickle
+class Point:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+ch.send([1, 'abc', (2.5, None), {'k': b'v'}])
+ch.send(Point(3, 4))
+ch.send([array2d(2, 2, default=lambda pos: pos.x)])
+assert ch.recv() == [1, 'abc', (2.5, None), {'k': b'v'}]
+p = ch.recv()
+assert type(p) is Point and p.x == 3 and p.y == 4
+c = ch.recv()
+assert c[0][1, 0] == 1
+
+# bounded
+for i in range(4):
+    assert ch.try_send(i)
+assert not ch.try_send(4)
+assert len(ch) == 4
+assert [ch.recv() for _ in range(4)] == [0, 1, 2, 3]
+
+try:
+    ch.send(lambda: 1)
+    exit(1)
+except TypeError:
+    pass
+assert len(ch) == 0
+
+try:
+    Channel('bad', 0)
+    exit(1)
+except ValueError:
+    pass
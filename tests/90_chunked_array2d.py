@@ -65,3 +65,63 @@ assert (a.view() == b.view()).all()
 
 for pos, ctx in a:
     assert b.get_context(pos) == ctx
+
+# many chunks, hashed lookup
+a = array2d.chunked_array2d(2, default=-1)
+for i in range(-50, 50):
+    for j in range(-50, 50):
+        a[vec2i(i, j)] = i * 1000 + j
+assert len(a) == 2500
+for i in range(-50, 50):
+    for j in range(-50, 50):
+        assert a[vec2i(i, j)] == i * 1000 + j
+for x in range(-25, 25, 2):
+    assert a.remove_chunk(vec2i(x, 3))
+assert len(a) == 2500 - 25
+assert a[vec2i(-50, 6)] == -1
+assert a[vec2i(-50, 8)] == -50000 + 8
+
+# streaming
+store = {}
+def save(pos, data):
+    store[pos] = data
+def load(pos):
+    return store[pos]
+
+a = array2d.chunked_array2d(4, default=0, context_builder=lambda pos: pos.x)
+a.set_streaming(2, save, load)
+for x in range(8):
+    a[vec2i(x * 4, 0)] = x + 1
+    a[vec2i(x * 4 + 1, 1)] = str(x)
+assert a.resident_chunks == 2
+assert len(a) == 8
+assert len(store) == 6
+assert type(store[vec2i(0, 0)]) is bytes
+assert a.get_context(vec2i(0, 0)) == 0
+for x in range(8):
+    assert a[vec2i(x * 4, 0)] == x + 1
+    assert a[vec2i(x * 4 + 1, 1)] == str(x)
+    assert a[vec2i(x * 4 + 2, 2)] == 0
+    assert a.resident_chunks == 2
+assert a.view_rect(vec2i(0, 0), 32, 1).tolist() == [
+    [(i // 4 + 1) if i % 4 == 0 else 0 for i in range(32)]
+]
+assert a.move_chunk(vec2i(0, 0), vec2i(0, 1))
+assert a[vec2i(0, 4)] == 1
+b = a.copy()
+assert b.resident_chunks == 8
+assert (a.view() == b.view()).all()
+
+a.set_streaming(0)
+assert a.resident_chunks == 8
+assert a[vec2i(0, 4)] == 1
+
+def bad_load(pos):
+    return 1
+a.set_streaming(1, save, bad_load)
+assert a[vec2i(0, 4)] == 1
+try:
+    a[vec2i(4, 0)]
+    exit(1)
+except TypeError:
+    pass
@@ -103,9 +103,20 @@ class A:
 
 bad_dict = {A(): 1, A(): 2, A(): 3, A(): 4}
 assert len(bad_dict) == 4
-try:
-    bad_dict[A()] = 5   # error
-    exit(1)
-except RuntimeError as e:
-    assert 'maximum collision reached' in str(e)
-
+for i in range(100):
+    bad_dict[A()] = i
+assert len(bad_dict) == 104
+
+
+# more than 65535 names
+class _Names: pass
+_n = _Names()
+for i in range(70000):
+    setattr(_n, f'_name_{i}', i)
+assert getattr(_n, '_name_69999') == 69999
+assert eval('_n._name_69999') == 69999
+# names beyond 16 bits are loaded with EXTENDED_ARG
+exec('_name_69999 = 1')
+assert eval('_name_69999 + 1') == 2
+exec('def _f(): return _name_69999')
+assert _f() == 1